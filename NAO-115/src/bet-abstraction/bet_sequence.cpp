@@ -12,7 +12,7 @@
 
 namespace BetAbstraction {
 
-ActionList getLegalActions(const MCCFRState& state) {
+ActionList getLegalActions(const MCCFRState& state, const BetConfig& config) {
     ActionList list;
     
     // need to get effective all in amount first to raise with actual stack, not full default one
@@ -72,19 +72,19 @@ ActionList getLegalActions(const MCCFRState& state) {
             denominators = PREFLOP_BET_DENOMINATORS;
             arraySize    = PREFLOP_BET_COUNT;
         } else {
-            // select street-specific sizes from global config
+            // select street-specific sizes from the passed config
             switch (state.street) {
                 case 1:  // flop
-                    numerators   = g_betConfig.flop_numerators;
-                    denominators = g_betConfig.flop_denominators;
+                    numerators   = config.flop_numerators;
+                    denominators = config.flop_denominators;
                     break;
                 case 2:  // turn
-                    numerators   = g_betConfig.turn_numerators;
-                    denominators = g_betConfig.turn_denominators;
+                    numerators   = config.turn_numerators;
+                    denominators = config.turn_denominators;
                     break;
                 case 3:  // river
-                    numerators   = g_betConfig.river_numerators;
-                    denominators = g_betConfig.river_denominators;
+                    numerators   = config.river_numerators;
+                    denominators = config.river_denominators;
                     break;
                 default:
                     numerators   = POSTFLOP_BET_NUMERATORS;
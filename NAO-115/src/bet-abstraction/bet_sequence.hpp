@@ -36,6 +36,7 @@ struct ActionList {
     }
 };
 
-ActionList getLegalActions(const MCCFRState& state);
+// postflop open sizings are read from the passed config, preflop & 3-bet sizings are fixed
+ActionList getLegalActions(const MCCFRState& state, const BetConfig& config);
 
 }
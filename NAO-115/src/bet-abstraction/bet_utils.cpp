@@ -1,5 +0,0 @@
-#include "bet_utils.hpp"
-
-namespace BetAbstraction {
-BetConfig g_betConfig;
-}
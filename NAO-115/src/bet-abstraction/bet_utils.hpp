@@ -32,6 +32,12 @@ constexpr int32_t RAISE_NUMERATORS[] = {1, 1, 2};
 constexpr int32_t RAISE_DENOMINATORS[] = {2, 1, 1};
 constexpr int RAISE_COUNT = 3;
 
+/*
+Postflop bet sizings of one abstraction (pot fractions as integer ratios).
+ - passed explicitly (by const reference) to every module that expands the betting tree,
+   there is no global instance -> several abstractions can be trained / evaluated in one process
+ - default values are the 0.5x / 1x / 2x pot baseline
+ */
 struct BetConfig {
     int32_t flop_numerators[3]   = {1, 1, 2};
     int32_t flop_denominators[3] = {2, 1, 1};
@@ -43,9 +49,6 @@ struct BetConfig {
     int32_t river_denominators[3] = {2, 1, 1};
 };
 
-// config which is set by evaluator before calling train
-extern BetConfig g_betConfig;
-
 // 3-bets (facing a raise): 0.8x pot
 constexpr int32_t THREE_BET_NUMERATORS[] = {4};
 constexpr int32_t THREE_BET_DENOMINATORS[] = {5}; // 4/5 = 0.8
@@ -0,0 +1,123 @@
+#include "baseline_cache.hpp"
+#include "../include/nlohmann/json.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <unistd.h>
+
+using json = nlohmann::json;
+
+namespace BaselineCache {
+
+template <typename T>
+static uint64_t hashValue(uint64_t hash, const T& value) {
+    return fnv1a(&value, sizeof(value), hash);
+}
+
+bool fileChecksum(const std::string& path, uint64_t& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        fprintf(stderr, "BaselineCache: cannot read %s\n", path.c_str());
+        return false;
+    }
+
+    std::vector<uint8_t> buffer(size_t(1) << 20);
+    uint64_t hash = FNV_OFFSET_BASIS;
+    size_t n;
+    while ((n = fread(buffer.data(), 1, buffer.size(), f)) > 0) {
+        hash = fnv1a(buffer.data(), n, hash);
+    }
+    bool ok = !ferror(f);
+    fclose(f);
+
+    out = hash;
+    return ok;
+}
+
+std::string digest(const Key& key) {
+    uint64_t hash = FNV_OFFSET_BASIS;
+    hash = hashValue(hash, CACHE_VERSION);
+
+    // field by field, no struct padding in the hash
+    const BetAbstraction::BetConfig& c = key.config;
+    for (int i = 0; i < 3; ++i) {
+        hash = hashValue(hash, c.flop_numerators[i]);
+        hash = hashValue(hash, c.flop_denominators[i]);
+        hash = hashValue(hash, c.turn_numerators[i]);
+        hash = hashValue(hash, c.turn_denominators[i]);
+        hash = hashValue(hash, c.river_numerators[i]);
+        hash = hashValue(hash, c.river_denominators[i]);
+    }
+    hash = hashValue(hash, key.nodeBudget);
+    hash = hashValue(hash, key.trainingSeed);
+    hash = hashValue(hash, static_cast<int32_t>(key.threads));
+    hash = hashValue(hash, static_cast<uint8_t>(key.precision));
+
+    for (const std::string& path : key.abstractionFiles) {
+        uint64_t checksum;
+        if (!fileChecksum(path, checksum)) return "";
+        hash = hashValue(hash, checksum);
+    }
+
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return hex;
+}
+
+std::string entryPath(const std::string& dir, const std::string& digest) {
+    return (std::filesystem::path(dir) / (digest + ".frozen")).string();
+}
+
+bool lookup(const std::string& dir, const std::string& digest, MatchEngine::StrategyProfile& profile) {
+    if (digest.empty()) return false;
+
+    std::string path = entryPath(dir, digest);
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) return false;
+    return MatchEngine::mapProfile(profile, path);
+}
+
+bool store(const std::string& dir, const std::string& digest, const Key& key, const FrozenStrategy::Table& table) {
+    if (digest.empty()) return false;
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if (error) {
+        fprintf(stderr, "BaselineCache: cannot create %s (%s)\n", dir.c_str(), error.message().c_str());
+        return false;
+    }
+
+    // temporary name per process, the rename publishes the complete file
+    std::string path = entryPath(dir, digest);
+    std::string temporary = path + ".tmp." + std::to_string(getpid());
+    if (!FrozenStrategy::saveMapped(table, temporary)) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        fprintf(stderr, "BaselineCache: cannot publish %s (%s)\n", path.c_str(), error.message().c_str());
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+
+    json manifest;
+    manifest["digest"] = digest;
+    manifest["cache_version"] = CACHE_VERSION;
+    manifest["node_budget"] = key.nodeBudget;
+    manifest["training_seed"] = key.trainingSeed;
+    manifest["threads"] = key.threads;
+    manifest["precision"] = static_cast<int>(key.precision);
+    manifest["infosets"] = table.size();
+    for (int i = 0; i < 3; ++i) {
+        manifest["flop"].push_back({key.config.flop_numerators[i], key.config.flop_denominators[i]});
+        manifest["turn"].push_back({key.config.turn_numerators[i], key.config.turn_denominators[i]});
+        manifest["river"].push_back({key.config.river_numerators[i], key.config.river_denominators[i]});
+    }
+    manifest["abstraction_files"] = key.abstractionFiles; // contents are in the digest
+    std::ofstream(std::filesystem::path(dir) / (digest + ".json")) << manifest.dump(2) << "\n";
+    return true;
+}
+
+}
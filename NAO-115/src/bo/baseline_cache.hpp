@@ -0,0 +1,66 @@
+#pragma once
+
+/*
+On-disk cache of the BO baseline profile.
+ The baseline is the same for every BO session with the same abstraction, budget and seed, so it is trained once
+ and stored as a memory mappable frozen table (FrozenStrategy::saveMapped), later sessions map it in place.
+
+ Content addressed:
+    - digest = FNV-1a 64 over the bet config ratios, node budget, training seed, thread count (the parallel trainer's
+      result depends on it), freeze precision, CACHE_VERSION and the checksums of the abstraction files
+    - entry: <dir>/<digest>.frozen, plus <dir>/<digest>.json describing the inputs (for humans, never read back)
+    - anything that changes the trained baseline changes the digest -> no invalidation logic, stale entries are just unused
+
+ Writes go to a temporary file renamed into place, so concurrent BO sessions never map a partial table.
+ */
+
+#include "bet-abstraction/bet_utils.hpp"
+#include "cfr/strategy-eval/frozen_strategy.hpp"
+#include "cfr/strategy-eval/match_engine.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BaselineCache {
+
+// bump when the trainer changes in a way that changes its output for the same inputs
+static constexpr uint32_t CACHE_VERSION = 1;
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 0xCBF29CE484222325ULL;
+static constexpr uint64_t FNV_PRIME = 0x100000001B3ULL;
+
+inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// everything the trained baseline depends on
+struct Key {
+    BetAbstraction::BetConfig config;
+    uint64_t nodeBudget = 0;
+    uint64_t trainingSeed = 0;
+    int threads = 1;
+    FrozenStrategy::Precision precision = FrozenStrategy::Precision::UInt16;
+    std::vector<std::string> abstractionFiles; // hashed by content
+};
+
+// FNV-1a of the file's bytes, false if it cannot be read
+bool fileChecksum(const std::string& path, uint64_t& out);
+
+// 16 hex digits, empty if an abstraction file cannot be read (no caching then)
+std::string digest(const Key& key);
+
+std::string entryPath(const std::string& dir, const std::string& digest);
+
+// map a cached baseline into profile (its bet config fields are left alone), false on a miss
+bool lookup(const std::string& dir, const std::string& digest, MatchEngine::StrategyProfile& profile);
+
+// write the frozen baseline (+ manifest) under its digest, false if the directory / file cannot be written
+bool store(const std::string& dir, const std::string& digest, const Key& key, const FrozenStrategy::Table& table);
+
+}
@@ -99,10 +99,10 @@ static void fractionToRatio(float fraction, int32_t& numerator, int32_t& denomin
     denominator /= a;
 }
 
-// apply bet fractions from JSON to Nao's global bet config
+// build Nao's bet config from the JSON bet fractions
 // converts float fractions of the pot into integer numerator/denominator pairs
-static void applyBetConfig(const json& config) {
-    auto& betConfig = BetAbstraction::g_betConfig;
+static BetAbstraction::BetConfig betConfigFromJson(const json& config) {
+    BetAbstraction::BetConfig betConfig;
 
     auto applyStreet = [](const json& streetArray, int32_t* numerators, int32_t* denominators, size_t maxSlots) {
         // Iterate over all elements in the JSON array or maxSlots, whichever is smaller
@@ -131,10 +131,12 @@ static void applyBetConfig(const json& config) {
                 betConfig.river_numerators,
                 betConfig.river_denominators,
                 BetAbstraction::POSTFLOP_BET_COUNT);
+    
+    return betConfig;
 }
 
-void applyBOBetSizing(const BOConfig& cfg) {
-    auto& betConfig = BetAbstraction::g_betConfig;
+BetAbstraction::BetConfig betConfigFromBO(const BOConfig& cfg) {
+    BetAbstraction::BetConfig betConfig;
 
     auto applyStreet = [](const float* fractions,
                           int32_t* nums,
@@ -148,6 +150,8 @@ void applyBOBetSizing(const BOConfig& cfg) {
     applyStreet(cfg.flop,  betConfig.flop_numerators,  betConfig.flop_denominators, 3);
     applyStreet(cfg.turn,  betConfig.turn_numerators,  betConfig.turn_denominators, 3);
     applyStreet(cfg.river, betConfig.river_numerators, betConfig.river_denominators, 3);
+    
+    return betConfig;
 }
 
 
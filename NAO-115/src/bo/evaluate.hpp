@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
+#include "bet-abstraction/bet_utils.hpp"
 
 // the evaluator will send these values as a signal back to the BO after running
 struct BOSignal {
@@ -29,4 +30,4 @@ struct BOResult {
 };
 
 BOResult evaluateNaoPostflopBO_Test(const BOConfig& config);
-void applyBOBetSizing(const BOConfig& cfg);
+BetAbstraction::BetConfig betConfigFromBO(const BOConfig& cfg);
@@ -18,6 +18,9 @@
 #include "cfr/cfr-core/infoset.hpp"
 #include "cfr/strategy-eval/match_engine.hpp"
 #include "cfr/strategy-eval/strategy_io.hpp"
+#include "baseline_cache.hpp"
+#include "cfr/cfr-core/warm_start.hpp"
+#include "cfr/utils/deal_stream.hpp"
 
 #include <cstdio>
 #include <fstream>
@@ -26,7 +29,20 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <limits>
+#include <stdexcept>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 using timerClock = std::chrono::high_resolution_clock;
 using Seconds = std::chrono::duration<double>;
@@ -84,34 +100,42 @@ inline void fractionToRatio(double fraction, int32_t& numerator, int32_t& denomi
     }
 }
 
-// in BO synergy, Nao uses two 'bet config applier' modules:
-// applyJsonBetConfig: is able to load any bet sizes proposed as a vector by the BO to a global bet config
-// applyBaselineConfig: responsible for initializing and training the baseline config for evaluating each vector
-void applyBetConfigFromArrays(const float flop[3],
-                             const float turn[3],
-                             const float river[3]) {
-    auto& betConfig = BetAbstraction::g_betConfig;
+// in BO synergy, Nao builds two kinds of bet configs:
+// betConfigFromJson: converts any bet sizes proposed as a vector by the BO into a config
+// baselineBetConfig: the fixed config the baseline strategy is trained with, every vector is evaluated against it
+// configs are plain values handed to the trainer / match engine - nothing global is mutated
+BetAbstraction::BetConfig betConfigFromArrays(const float flop[3],
+                                              const float turn[3],
+                                              const float river[3]) {
+    BetAbstraction::BetConfig betConfig;
 
     for (int i = 0; i < 3; ++i) {
         fractionToRatio(flop[i],  betConfig.flop_numerators[i],  betConfig.flop_denominators[i]);
         fractionToRatio(turn[i],  betConfig.turn_numerators[i],  betConfig.turn_denominators[i]);
         fractionToRatio(river[i], betConfig.river_numerators[i], betConfig.river_denominators[i]);
     }
+    
+    return betConfig;
 }
 
-void applyBaselineConfig() {
+BetAbstraction::BetConfig baselineBetConfig() {
     constexpr float sizes[3] = {0.5f, 1.0f, 2.0f};
-    applyBetConfigFromArrays(sizes, sizes, sizes);
+    return betConfigFromArrays(sizes, sizes, sizes);
 }
 
-void applyJsonBetConfig(const json& input) {
-    if (!input.contains("x") || input["x"].size() != 9) {
-        std::cerr << "Invalid input: expected x[9]\n";
-        std::exit(1);
+// throws std::invalid_argument on a malformed proposal (the one-shot evaluator exits, the daemon reports it)
+BetAbstraction::BetConfig betConfigFromJson(const json& input) {
+    if (!input.is_object() || !input.contains("x") || !input["x"].is_array() || input["x"].size() != 9) {
+        throw std::invalid_argument("Invalid input: expected x[9]");
+    }
+    for (const auto& value : input["x"]) {
+        if (!value.is_number()) {
+            throw std::invalid_argument("Invalid input: x must hold numbers");
+        }
     }
     
     const auto& x = input["x"];
-    auto& betConfig = BetAbstraction::g_betConfig;
+    BetAbstraction::BetConfig betConfig;
     
     auto processStreet = [&](int offset, int32_t* nums, int32_t* dens) {
         double a = x[offset + 0].get<double>();
@@ -128,24 +152,23 @@ void applyJsonBetConfig(const json& input) {
     processStreet(0, betConfig.flop_numerators,  betConfig.flop_denominators);
     processStreet(3, betConfig.turn_numerators,  betConfig.turn_denominators);
     processStreet(6, betConfig.river_numerators, betConfig.river_denominators);
+    
+    return betConfig;
 }
 
-MatchEngine::StrategyProfile buildProfile(StrategyIO::InfosetMap map) {
+MatchEngine::StrategyProfile buildProfile(StrategyIO::InfosetMap map, const BetAbstraction::BetConfig& config) {
     MatchEngine::StrategyProfile profile;
     profile.map = std::move(map);
     profile.numSizes = 3;
     
-    const auto& cfg = BetAbstraction::g_betConfig;
+    // the config the map was trained with
+    profile.betConfig = config;
     
+    // pot fractions for PHM translation, same values as the integer ratios
     for (int i = 0; i < 3; ++i) {
-        profile.flop_n[i]  = cfg.flop_numerators[i];
-        profile.flop_d[i]  = cfg.flop_denominators[i];
-        
-        profile.turn_n[i]  = cfg.turn_numerators[i];
-        profile.turn_d[i]  = cfg.turn_denominators[i];
-        
-        profile.river_n[i] = cfg.river_numerators[i];
-        profile.river_d[i] = cfg.river_denominators[i];
+        profile.flop[i]  = static_cast<float>(config.flop_numerators[i])  / config.flop_denominators[i];
+        profile.turn[i]  = static_cast<float>(config.turn_numerators[i])  / config.turn_denominators[i];
+        profile.river[i] = static_cast<float>(config.river_numerators[i]) / config.river_denominators[i];
     }
     
     return profile;
@@ -154,21 +177,123 @@ MatchEngine::StrategyProfile buildProfile(StrategyIO::InfosetMap map) {
 MatchEngine::StrategyProfile& getBaselineProfile() {
     static MatchEngine::StrategyProfile baseline = []{
         
-        applyBaselineConfig();
+        BetAbstraction::BetConfig config = baselineBetConfig();
+        MatchEngine::StrategyProfile profile = buildProfile(StrategyIO::InfosetMap{}, config);
+        
+        // same abstraction, budget, seed and abstraction files -> same baseline, trained only on a cache miss
+        BaselineCache::Key key;
+        key.config = config;
+        key.nodeBudget = nodeBudget;
+        key.trainingSeed = trainingSeed;
+        key.threads = threads;
+        key.abstractionFiles = {Bucketer::CENTROIDS_FILE, Bucketer::FLOP_LUT_FILE, Bucketer::TURN_LUT_FILE};
+        const std::string digest = BaselineCache::digest(key);
+        
+        if (BaselineCache::lookup(baselineCacheDir, digest, profile)) {
+            std::cerr << "Baseline: cache hit " << digest << "\n";
+            return profile;
+        }
         
-        MCCFR::ParallelTrainer trainer;
+        MCCFR::ParallelTrainer trainer(config);
         trainer.train(nodeBudget, threads, trainingSeed);
-        StrategyIO::saveForPlay(trainer.getInfosetMap(), "baseline.bin");
-        StrategyIO::InfosetMap map;
-        StrategyIO::load(map, "baseline.bin");
 
-        return buildProfile(std::move(map));
+        // the baseline is played against in every evaluation -> frozen once, written as a mapped table
+        // and queried in place (page cache backed), kept in memory if the file cannot be written / mapped
+        FrozenStrategy::Table frozen = FrozenStrategy::Table::freeze(trainer.getInfosetMap(), key.precision);
+        if (!BaselineCache::store(baselineCacheDir, digest, key, frozen) ||
+            !BaselineCache::lookup(baselineCacheDir, digest, profile)) {
+            profile.frozen = std::move(frozen);
+        }
+        return profile;
 
     }();
 
     return baseline;
 }
 
+// tables trained earlier in this process (daemon mode), candidates for warm starts
+struct TrainedTable {
+    BetAbstraction::BetConfig config;
+    InfosetMap map;
+};
+
+std::deque<TrainedTable>& getWarmStartPool() {
+    static std::deque<TrainedTable> pool;
+    return pool;
+}
+
+// batch pipelines share the pool
+std::mutex& getWarmStartMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+// initial table from the closest earlier table: most leading streets in common first, then the smallest size distance
+// (empty if no table shares the flop)
+WarmStart::InfosetMap warmStartTable(const BetAbstraction::BetConfig& config, int& streets) {
+    std::lock_guard<std::mutex> lock(getWarmStartMutex());
+    const TrainedTable* best = nullptr;
+    double bestDistance = 0.0;
+    streets = 0;
+    
+    for (const TrainedTable& table : getWarmStartPool()) {
+        int shared = WarmStart::sharedStreets(config, table.config);
+        if (shared == 0) continue;
+        double distance = WarmStart::sizeDistance(config, table.config);
+        if (shared > streets || (shared == streets && distance < bestDistance)) {
+            best = &table;
+            streets = shared;
+            bestDistance = distance;
+        }
+    }
+    return best ? WarmStart::transfer(best->map, streets) : WarmStart::InfosetMap{};
+}
+
+void rememberTrainedTable(const BetAbstraction::BetConfig& config, InfosetMap map) {
+    std::lock_guard<std::mutex> lock(getWarmStartMutex());
+    auto& pool = getWarmStartPool();
+    pool.push_back(TrainedTable{config, std::move(map)});
+    while (pool.size() > static_cast<size_t>(warmStartPoolSize)) {
+        pool.pop_front();
+    }
+}
+
+/*
+ Training deals shared by every candidate (and every evaluator process with the same abstraction files)
+  - file name: seed, deal count and the checksum of the abstraction files, generated on the first miss
+  - nullptr if an abstraction file cannot be read or the stream cannot be written (candidates sample their deals then)
+ */
+std::shared_ptr<const DealStream::Stream> getDealStream() {
+    static std::shared_ptr<const DealStream::Stream> shared = []() -> std::shared_ptr<const DealStream::Stream> {
+        uint64_t checksum = BaselineCache::FNV_OFFSET_BASIS;
+        for (const char* path : {Bucketer::CENTROIDS_FILE, Bucketer::FLOP_LUT_FILE, Bucketer::TURN_LUT_FILE}) {
+            uint64_t fileChecksum;
+            if (!BaselineCache::fileChecksum(path, fileChecksum)) return nullptr;
+            checksum = BaselineCache::fnv1a(&fileChecksum, sizeof(fileChecksum), checksum);
+        }
+        
+        char name[96];
+        snprintf(name, sizeof(name), "%llu-%llu-%016llx.deals", static_cast<unsigned long long>(trainingSeed),
+                 static_cast<unsigned long long>(dealStreamDeals), static_cast<unsigned long long>(checksum));
+        const std::string path = (std::filesystem::path(dealStreamDir) / name).string();
+        
+        auto stream = std::make_shared<DealStream::Stream>();
+        if (!stream->map(path)) {
+            auto start = timerClock::now();
+            if (!DealStream::generate(path, dealStreamDeals, trainingSeed, checksum) || !stream->map(path)) {
+                return nullptr;
+            }
+            std::cerr << "Deal stream: " << dealStreamDeals << " deals generated (" << elapsed_sec(start) << " s)\n";
+        }
+        if (stream->abstractionChecksum() != checksum || stream->seed() != trainingSeed) {
+            std::cerr << "Deal stream: " << path << " does not match the abstraction, deals are sampled\n";
+            return nullptr;
+        }
+        return stream;
+    }();
+    return shared;
+}
+
 double& getCumulativeBestEV() {
     static double best = -std::numeric_limits<double>::infinity();
     return best;
@@ -201,22 +326,55 @@ static std::pair<float, float> computeRegretStats(const InfosetMap& infosetMap)
     return {regretAbsAverage, regretAbsMaximum};
 }
 
-BOSignal evaluatePostflopStrategy() {
-    static uint32_t iteration = 0; // count the iteration count of this evaluator
+// hand indexing engine shared by every evaluation of this process
+Bucketer::IsomorphismEngine& getIsoEngine() {
+    static Bucketer::IsomorphismEngine isoEngine;
+    isoEngine.initialize(); // no-op after the first call
+    return isoEngine;
+}
 
-    // create the logger to be able to fill it up with mccfr and match info output
+// one proposal between its two stages: trained + frozen profile, log filled as the stages run
+struct Candidate {
+    BetAbstraction::BetConfig config;
+    MatchEngine::StrategyProfile profile;
     LoggedValues log;
+    BOSignal signal;
+    
+    // fidelity of the run, full budgets unless successive halving lowers them
+    uint32_t rung = 0;
+    double fidelity = 1.0;
+    uint64_t nodeBudget = ::nodeBudget;
+    uint64_t duplicateHands = ::duplicateHands;
+    
+    // successive halving: the table of the previous rung, continued by the next one instead of training from zero
+    bool keepTable = false;
+    WarmStart::InfosetMap table;
+    uint64_t tableNodes = 0;
+};
+
+/*
+ Stage 1: train the proposal and freeze its strategy.
+  - numThreads: cores of this stage (all of them for a single proposal, a share of them in batch / pipelined mode)
+  - slot: keeps the strategy files of stages running at the same time apart
+ */
+void trainCandidate(Candidate& candidate, int numThreads, int slot) {
+    static std::atomic<uint32_t> iteration{0}; // count the iteration count of this evaluator
+    
+    const BetAbstraction::BetConfig& config = candidate.config;
+    LoggedValues& log = candidate.log;
+
+    // parallel regions opened by this stage (load, freeze) stay inside its share of cores
+    omp_set_num_threads(numThreads);
 
     log.boIteration = iteration++;
+    log.trainingThreads = numThreads;
+    log.pipelined = false;
+    log.pipelineStepSeconds = 0.0;
+    log.pipelineUtilization = 0.0;
     // initialize evaluators, engine
     initializeModulesOnce();
     
-    // apply proposed bet sizes coming from BO module
-    json betSizeInput = readInputJSON();
-    applyJsonBetConfig(betSizeInput);
-    
     // log the bet size lists
-    const auto& config = BetAbstraction::g_betConfig;
 
     for (int i = 0; i < 3; ++i) {
         log.params.flopBetSizes[i] = (double)config.flop_numerators[i] / config.flop_denominators[i];
@@ -224,14 +382,43 @@ BOSignal evaluatePostflopStrategy() {
         log.params.riverBetSizes[i] = (double)config.river_numerators[i] / config.river_denominators[i];
     }
     
-    // initialize hand indexing modules
-    Bucketer::IsomorphismEngine isoEngine;
-    isoEngine.initialize();
-    
     // train the mccfr module
     auto t_train_start = timerClock::now();
-    MCCFR::ParallelTrainer trainer;
-    trainer.train(nodeBudget, threads, trainingSeed);
+    MCCFR::ParallelTrainer trainer(config);
+    if (sharedDealStream) {
+        // every rung of successive halving continues in another part of the stream
+        trainer.setDealStream(getDealStream(), candidate.rung * (dealStreamDeals / halvingRungs));
+    }
+    
+    // warm start from the closest table trained earlier in this process (same leading streets), shorter run
+    uint64_t trainingBudget = candidate.nodeBudget;
+    log.warmStartStreets = 0;
+    log.warmStartInfosets = 0;
+    if (!candidate.table.empty()) {
+        // promoted proposal: its own lower rung table, every street is kept and only the missing nodes are trained
+        log.warmStartStreets = 3;
+        log.warmStartInfosets = candidate.table.size();
+        trainingBudget = candidate.nodeBudget - std::min(candidate.tableNodes, candidate.nodeBudget);
+        trainer.setInitialMap(std::move(candidate.table));
+        candidate.table = {};
+    } else if (warmStartTraining) {
+        int streets = 0;
+        WarmStart::InfosetMap initial = warmStartTable(config, streets);
+        if (!initial.empty()) {
+            log.warmStartStreets = static_cast<uint32_t>(streets);
+            log.warmStartInfosets = initial.size();
+            trainer.setInitialMap(std::move(initial));
+            trainingBudget = static_cast<uint64_t>(static_cast<double>(candidate.nodeBudget) * warmStartBudgetFraction);
+        }
+    }
+    log.nodeBudget = trainingBudget;
+    log.nodesSaved = candidate.nodeBudget - trainingBudget;
+    log.fidelityRung = candidate.rung;
+    log.fidelity = candidate.fidelity;
+    
+    // every rung continues with a fresh deal stream (rung 0 = the usual seed)
+    const uint64_t seed = trainingSeed + candidate.rung;
+    trainer.train(trainingBudget, numThreads, seed);
     double training_sec = elapsed_sec(t_train_start);
     
     // logs related to specific mccfr run
@@ -242,54 +429,114 @@ BOSignal evaluatePostflopStrategy() {
     log.maxAbsRegret = maxAbsRegret;
 
     // descriptive values about the infoset table and how Nao got there
-    log.trainerSeed = trainingSeed;
+    log.trainerSeed = seed;
     log.infosetsCount = trainer.getNumInfosets();
     log.totalNodesTouched = trainer.getTotalNodesTouched();
     log.averageRunPerNode = static_cast<float>(log.totalNodesTouched) / static_cast<float>(std::max<uint64_t>(1, log.infosetsCount));
     log.mccfrTrainingSeconds = training_sec;
 
     // save the strategy to bin and load the infoset map into memory
-    StrategyIO::saveForPlay(trainer.getInfosetMap(), "strategy.bin");
-    StrategyIO::InfosetMap map;
-    StrategyIO::load(map, "strategy.bin");
+    const std::string strategyPath = slot == 0 ? "strategy.bin" : "strategy." + std::to_string(slot) + ".bin";
+    StrategyIO::saveForPlay(trainer.getInfosetMap(), strategyPath);
+    if (candidate.keepTable) {
+        candidate.table = std::move(trainer.getInfosetMap());
+        candidate.tableNodes = candidate.nodeBudget;
+    } else if (warmStartTraining) {
+        rememberTrainedTable(config, std::move(trainer.getInfosetMap()));
+    }
+    StrategyIO::ShardedMap shards;
+    StrategyIO::loadSharded(shards, strategyPath);
+    
+    candidate.profile = buildProfile(StrategyIO::InfosetMap{}, config);
+    MatchEngine::freezeProfile(candidate.profile, shards);
+}
+
+// Stage 2: duplicate match against the baseline, fills the signal
+void matchCandidate(Candidate& candidate, int numThreads) {
+    LoggedValues& log = candidate.log;
+    omp_set_num_threads(numThreads);
+    log.matchThreads = numThreads;
     
-    auto profile = buildProfile(std::move(map));
     auto& baseline = getBaselineProfile();
     
     auto t_eval_start = timerClock::now();
-    auto result = MatchEngine::runMatch(
-                                        profile, baseline,
-                                        isoEngine,
-                                        duplicateHands,
-                                        100,
-                                        evaluatorSeed
-                                        );
+    MatchEngine::MatchResult result;
+    if (sequentialEvaluation) {
+        // target 0 = baseline level, only "clearly worse" stops the match
+        MatchEngine::SequentialOptions sequential;
+        sequential.target_mbb = 0.0f;
+        result = MatchEngine::runMatchSequential(
+                                                 candidate.profile, baseline,
+                                                 getIsoEngine(),
+                                                 candidate.duplicateHands,
+                                                 100,
+                                                 evaluatorSeed,
+                                                 sequential,
+                                                 numThreads,
+                                                 varianceReducedEvaluation,
+                                                 evaluationDealSampling
+                                                 );
+    } else {
+        result = MatchEngine::runMatch(
+                                       candidate.profile, baseline,
+                                       getIsoEngine(),
+                                       candidate.duplicateHands,
+                                       100,
+                                       evaluatorSeed,
+                                       numThreads,
+                                       varianceReducedEvaluation,
+                                       evaluationDealSampling
+                                       );
+    }
     double eval_sec = elapsed_sec(t_eval_start);
     
+    // the frozen table is not needed after the match
+    candidate.profile = MatchEngine::StrategyProfile{};
+    
     // logs related to the heads up evaluation
     log.evaluatorSeed = evaluatorSeed;
     log.evaluationSeconds = eval_sec;
-    log.duplicateHands = duplicateHands;
-    log.standardError = result.std_error_mbb;
+    log.duplicateHands = result.num_pairs;
+    log.stoppedEarly = result.stopped_early;
+    log.varianceReduced = result.variance_reduced;
+    
+    // pick the estimate that is sent to the BO
+    double evMean = result.mean_ev_mbb;
+    double evStdError = result.std_error_mbb;
+    if (result.variance_reduced) {
+        evMean = result.corrected_mean_ev_mbb;
+        evStdError = result.corrected_std_error_mbb;
+    }
+    log.standardError = evStdError;
+    log.rawEvP0 = result.mean_ev_mbb;
+    log.rawStandardError = result.std_error_mbb;
     
-    double stdDevHandEV = result.std_error_mbb * std::sqrt(result.total_hands);
+    double stdDevHandEV = evStdError * std::sqrt(result.total_hands);
     log.stdDevHandEV = stdDevHandEV;
     
+    // SIGNAL TO BO
+    candidate.signal.ev_mean = evMean;
+    candidate.signal.ev_variance_of_mean = evStdError * evStdError;
+    candidate.signal.fidelity = candidate.fidelity;
+    log.evP0 = evMean;
+    log.evP0_bb100 = evMean * 100.0;
+}
+
+// best EV and the log line, shared by every stage of the process
+void writeLog(Candidate& candidate) {
+    static std::mutex logMutex;
+    std::lock_guard<std::mutex> logLock(logMutex);
+    
+    LoggedValues& log = candidate.log;
+    
     double& bestEV = getCumulativeBestEV();
-    double lowerBound = result.mean_ev_mbb - 1.96 * result.std_error_mbb;
+    double lowerBound = log.evP0 - 1.96 * log.standardError;
 
     if (lowerBound > bestEV) {
-        bestEV = result.mean_ev_mbb;
+        bestEV = log.evP0;
     }
 
     log.cumulativeBestEV = bestEV;
-
-    // SIGNAL TO BO
-    BOSignal signal;
-    signal.ev_mean = result.mean_ev_mbb;
-    signal.ev_variance_of_mean = result.std_error_mbb * result.std_error_mbb;
-    log.evP0 = result.mean_ev_mbb;
-    log.evP0_bb100 = result.mean_ev_mbb * 100.0;
     
     // create the log of this single heads up training and eval iteration
     static std::ofstream file("logs.jsonl", std::ios::app);
@@ -319,6 +566,9 @@ BOSignal evaluatePostflopStrategy() {
     out["stderr"] = log.standardError;
     out["stddev"] = log.stdDevHandEV;
     out["best_ev"] = log.cumulativeBestEV;
+    out["variance_reduced"] = log.varianceReduced;
+    out["ev_mbb_raw"] = log.rawEvP0;
+    out["stderr_raw"] = log.rawStandardError;
 
     // training
     out["infosets"] = log.infosetsCount;
@@ -328,16 +578,469 @@ BOSignal evaluatePostflopStrategy() {
     out["max_regret"] = log.maxAbsRegret;
     out["train_seconds"] = log.mccfrTrainingSeconds;
     out["trainer_seed"] = log.trainerSeed;
+    out["threads"] = log.trainingThreads;
+    out["node_budget"] = log.nodeBudget;
+    out["nodes_saved"] = log.nodesSaved;
+    out["warm_start_streets"] = log.warmStartStreets;
+    out["warm_start_infosets"] = log.warmStartInfosets;
+    out["rung"] = log.fidelityRung;
+    out["fidelity"] = log.fidelity;
 
     // evaluation
     out["eval_seconds"] = log.evaluationSeconds;
     out["duplicate_hands"] = log.duplicateHands;
+    out["stopped_early"] = log.stoppedEarly;
     out["evaluator_seed"] = log.evaluatorSeed;
+    out["match_threads"] = log.matchThreads;
+    
+    // pipelined schedule (step = this candidate's match + the next candidate's training)
+    out["pipelined"] = log.pipelined;
+    out["pipeline_step_seconds"] = log.pipelineStepSeconds;
+    out["pipeline_utilization"] = log.pipelineUtilization;
 
     file << out.dump() << "\n";
     file.flush();
+}
+
+// both stages back to back on the same cores
+BOSignal evaluateConfig(const BetAbstraction::BetConfig& config, int numThreads, int slot) {
+    Candidate candidate;
+    candidate.config = config;
+    trainCandidate(candidate, numThreads, slot);
+    matchCandidate(candidate, numThreads);
+    writeLog(candidate);
+    return candidate.signal;
+}
+
+BOSignal evaluateProposal(const json& betSizeInput) {
+    // build the proposed bet config from the BO's vector (before any work, a bad proposal costs nothing)
+    return evaluateConfig(betConfigFromJson(betSizeInput), threads, 0);
+}
+
+/*
+ Batch mode: q proposals trained and matched concurrently
+  - cores are split evenly between the pipelines (the first threads % q get one more),
+    more proposals than cores run in waves of at most `threads` pipelines
+  - every pipeline has its own bet config, trainer, strategy file and core share, the baseline is shared read-only
+  - runs candidates[i] for every i in indices, each one is logged when it is done
+ */
+void evaluateConcurrently(std::vector<Candidate>& candidates, const std::vector<size_t>& indices) {
+    if (indices.empty()) return;
+    
+    // shared state is built once, before the pipelines start
+    initializeModulesOnce();
+    getIsoEngine();
+    getBaselineProfile();
+    
+    const int totalThreads = std::max(1, threads);
+    for (size_t first = 0; first < indices.size(); first += totalThreads) {
+        const int wave = static_cast<int>(std::min<size_t>(totalThreads, indices.size() - first));
+        std::vector<std::thread> pipelines;
+        std::vector<std::exception_ptr> errors(wave);
+        
+        for (int p = 0; p < wave; ++p) {
+            const int share = totalThreads / wave + (p < totalThreads % wave ? 1 : 0);
+            pipelines.emplace_back([&, p, share]() {
+                try {
+                    Candidate& candidate = candidates[indices[first + p]];
+                    trainCandidate(candidate, share, p);
+                    matchCandidate(candidate, share);
+                    writeLog(candidate);
+                } catch (...) {
+                    errors[p] = std::current_exception();
+                }
+            });
+        }
+        for (auto& pipeline : pipelines) {
+            pipeline.join();
+        }
+        for (const auto& error : errors) {
+            if (error) std::rethrow_exception(error);
+        }
+    }
+    
+    // back to all cores for single proposals
+    omp_set_num_threads(totalThreads);
+}
+
+std::vector<BOSignal> evaluateConfigs(const std::vector<BetAbstraction::BetConfig>& configs) {
+    std::vector<Candidate> candidates(configs.size());
+    std::vector<size_t> indices(configs.size());
+    for (size_t i = 0; i < configs.size(); ++i) {
+        candidates[i].config = configs[i];
+        indices[i] = i;
+    }
+    evaluateConcurrently(candidates, indices);
+    
+    // signals come back in proposal order
+    std::vector<BOSignal> signals;
+    signals.reserve(candidates.size());
+    for (const Candidate& candidate : candidates) {
+        signals.push_back(candidate.signal);
+    }
+    return signals;
+}
+
+/*
+ Multi-fidelity mode: successive halving over the batch (one Hyperband bracket)
+  - rung r of halvingRungs trains with nodeBudget / halvingEta^(halvingRungs - 1 - r) nodes and plays
+    duplicateHands / halvingEta^(halvingRungs - 1 - r) duplicate hands, the last rung is the full evaluation
+  - every rung runs its proposals concurrently (evaluateConcurrently), then the best 1 / halvingEta of them by EV
+    (at least one) is promoted to the next rung
+  - a promoted proposal continues its own table: the next rung only trains the nodes missing to its budget
+  - each proposal returns the signal of the highest rung it reached, fidelity = its node budget / nodeBudget
+  - every run of every rung is logged (rung, fidelity)
+ */
+std::vector<BOSignal> evaluateHalving(const std::vector<BetAbstraction::BetConfig>& configs) {
+    std::vector<Candidate> candidates(configs.size());
+    std::vector<size_t> survivors(configs.size());
+    for (size_t i = 0; i < configs.size(); ++i) {
+        candidates[i].config = configs[i];
+        survivors[i] = i;
+    }
+    
+    for (int rung = 0; rung < halvingRungs && !survivors.empty(); ++rung) {
+        const bool lastRung = rung == halvingRungs - 1;
+        double scale = 1.0;
+        for (int r = rung; r < halvingRungs - 1; ++r) {
+            scale /= halvingEta;
+        }
+        
+        for (size_t i : survivors) {
+            Candidate& candidate = candidates[i];
+            candidate.rung = static_cast<uint32_t>(rung);
+            candidate.fidelity = scale;
+            candidate.nodeBudget = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(nodeBudget) * scale));
+            candidate.duplicateHands = std::max<uint64_t>(1, static_cast<uint64_t>(static_cast<double>(duplicateHands) * scale));
+            candidate.keepTable = !lastRung;
+        }
+        evaluateConcurrently(candidates, survivors);
+        
+        // promote the best ones, the tables of the others are freed
+        std::stable_sort(survivors.begin(), survivors.end(), [&](size_t a, size_t b) {
+            return candidates[a].signal.ev_mean > candidates[b].signal.ev_mean;
+        });
+        size_t promoted = lastRung ? 0 : std::max<size_t>(1, survivors.size() / halvingEta);
+        for (size_t k = promoted; k < survivors.size(); ++k) {
+            candidates[survivors[k]].table = {};
+        }
+        survivors.resize(promoted);
+        
+        std::cerr << "Successive halving: rung " << rung << " (fidelity " << scale << "), "
+                  << promoted << " promoted\n";
+    }
+    
+    std::vector<BOSignal> signals;
+    signals.reserve(candidates.size());
+    for (const Candidate& candidate : candidates) {
+        signals.push_back(candidate.signal);
+    }
+    return signals;
+}
+
+/*
+ Pipelined mode: the two stages of consecutive proposals overlap
+  - step k trains proposal k on trainCores while proposal k-1 plays its match on the rest of the cores
+    (first step trains only, last step matches only, both on all cores)
+  - the split follows the measured stage work (seconds x cores of the last train / match in LoggedValues),
+    so that both stages of a step end at about the same time; pipelineTrainShare until both were measured
+  - every proposal logs its step's wall time and core utilization (busy core-seconds / available core-seconds)
+  - signals come back in proposal order
+ */
+std::vector<BOSignal> evaluatePipelined(const std::vector<BetAbstraction::BetConfig>& configs) {
+    std::vector<BOSignal> signals(configs.size());
+    if (configs.empty()) return signals;
+    
+    const int totalThreads = std::max(1, threads);
+    if (totalThreads < 2) {
+        // nothing to split
+        return evaluateConfigs(configs);
+    }
+    
+    initializeModulesOnce();
+    getIsoEngine();
+    getBaselineProfile();
+    
+    std::vector<Candidate> candidates(configs.size());
+    for (size_t i = 0; i < configs.size(); ++i) {
+        candidates[i].config = configs[i];
+    }
     
-    return signal;
+    double trainWork = 0.0; // core-seconds of the last training stage
+    double matchWork = 0.0; // core-seconds of the last match stage
+    
+    for (size_t step = 0; step <= candidates.size(); ++step) {
+        const bool training = step < candidates.size();
+        const bool matching = step > 0;
+        
+        int trainCores = training ? totalThreads : 0;
+        int matchCores = matching ? totalThreads : 0;
+        if (training && matching) {
+            double share = pipelineTrainShare;
+            if (trainWork > 0.0 && matchWork > 0.0) {
+                share = trainWork / (trainWork + matchWork);
+            }
+            trainCores = std::clamp(static_cast<int>(std::lround(share * totalThreads)), 1, totalThreads - 1);
+            matchCores = totalThreads - trainCores;
+        }
+        
+        double trainSec = 0.0;
+        double matchSec = 0.0;
+        std::exception_ptr trainError;
+        std::exception_ptr matchError;
+        auto t_step_start = timerClock::now();
+        
+        std::thread trainStage;
+        std::thread matchStage;
+        if (training) {
+            trainStage = std::thread([&]() {
+                auto start = timerClock::now();
+                try {
+                    // two proposals are between their stages at most -> two strategy files
+                    trainCandidate(candidates[step], trainCores, static_cast<int>(step % 2));
+                } catch (...) {
+                    trainError = std::current_exception();
+                }
+                trainSec = elapsed_sec(start);
+            });
+        }
+        if (matching) {
+            matchStage = std::thread([&]() {
+                auto start = timerClock::now();
+                try {
+                    matchCandidate(candidates[step - 1], matchCores);
+                } catch (...) {
+                    matchError = std::current_exception();
+                }
+                matchSec = elapsed_sec(start);
+            });
+        }
+        if (trainStage.joinable()) trainStage.join();
+        if (matchStage.joinable()) matchStage.join();
+        if (trainError) std::rethrow_exception(trainError);
+        if (matchError) std::rethrow_exception(matchError);
+        
+        double stepSec = elapsed_sec(t_step_start);
+        
+        if (training) {
+            const LoggedValues& log = candidates[step].log;
+            trainWork = log.mccfrTrainingSeconds * log.trainingThreads;
+        }
+        if (matching) {
+            Candidate& done = candidates[step - 1];
+            matchWork = done.log.evaluationSeconds * done.log.matchThreads;
+            
+            done.log.pipelined = true;
+            done.log.pipelineStepSeconds = stepSec;
+            done.log.pipelineUtilization = (trainSec * trainCores + matchSec * matchCores) /
+                                           std::max(1e-9, stepSec * totalThreads);
+            writeLog(done);
+            signals[step - 1] = done.signal;
+            
+            std::cerr << "Pipeline step " << step << ": train " << trainCores << " cores " << trainSec
+                      << " s, match " << matchCores << " cores " << matchSec << " s, utilization "
+                      << done.log.pipelineUtilization << "\n";
+        }
+    }
+    
+    omp_set_num_threads(totalThreads);
+    return signals;
+}
+
+BetAbstraction::BetConfig betConfigFromParams(const BOParams& params) {
+    json input;
+    for (int i = 0; i < 3; ++i) input["x"].push_back(params.flopBetSizes[i]);
+    for (int i = 0; i < 3; ++i) input["x"].push_back(params.turnBetSizes[i]);
+    for (int i = 0; i < 3; ++i) input["x"].push_back(params.riverBetSizes[i]);
+    return betConfigFromJson(input);
+}
+
+std::vector<BOSignal> evaluateScheduled(const std::vector<BetAbstraction::BetConfig>& configs, BatchSchedule schedule) {
+    switch (schedule) {
+        case BatchSchedule::Pipelined: return evaluatePipelined(configs);
+        case BatchSchedule::SuccessiveHalving: return evaluateHalving(configs);
+        case BatchSchedule::Concurrent: break;
+    }
+    return evaluateConfigs(configs);
+}
+
+std::vector<BOSignal> evaluateBatch(const std::vector<BOParams>& proposals) {
+    std::vector<BetAbstraction::BetConfig> configs;
+    configs.reserve(proposals.size());
+    for (const BOParams& params : proposals) {
+        configs.push_back(betConfigFromParams(params));
+    }
+    return evaluateScheduled(configs, batchSchedule);
+}
+
+BOSignal evaluatePostflopStrategy() {
+    json betSizeInput = readInputJSON();
+    try {
+        return evaluateProposal(betSizeInput);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
+        std::exit(1);
+    }
+}
+
+/*
+ Daemon mode: one request per line, one result line per request, in order
+  - request:  {"x": [9 bet sizes], "id": <anything, optional>}
+  - response: {"id": ..., "ev_mean": ..., "ev_variance_of_mean": ..., "fidelity": 1} or {"id": ..., "error": "..."}
+  - batch request:  {"batch": [{"x": [...]}, ...], "id": ...} -> evaluated concurrently (evaluateConfigs)
+    optional "schedule": "concurrent" | "pipelined" (evaluatePipelined) | "halving" (evaluateHalving),
+    default is batchSchedule
+  - batch response: {"id": ..., "results": [{"ev_mean": ..., "ev_variance_of_mean": ..., "fidelity": ...}, ...]}
+    in request order (fidelity < 1: the proposal was not promoted to the full budget)
+  - modules, hand indexing engine and baseline profile are loaded once before the first request
+ */
+static std::string handleRequestLine(const std::string& line) {
+    json response;
+    try {
+        json request = json::parse(line);
+        if (request.is_object() && request.contains("id")) {
+            response["id"] = request["id"];
+        }
+        
+        if (request.is_object() && request.contains("batch")) {
+            if (!request["batch"].is_array()) {
+                throw std::invalid_argument("Invalid input: batch must be an array of proposals");
+            }
+            // every proposal is validated before any pipeline starts
+            std::vector<BetAbstraction::BetConfig> configs;
+            for (const auto& proposal : request["batch"]) {
+                configs.push_back(betConfigFromJson(proposal));
+            }
+            BatchSchedule schedule = batchSchedule;
+            if (request.contains("schedule")) {
+                const json& name = request["schedule"];
+                if (name == "pipelined") {
+                    schedule = BatchSchedule::Pipelined;
+                } else if (name == "halving") {
+                    schedule = BatchSchedule::SuccessiveHalving;
+                } else if (name == "concurrent") {
+                    schedule = BatchSchedule::Concurrent;
+                } else {
+                    throw std::invalid_argument("Invalid input: schedule must be \"concurrent\", \"pipelined\" or \"halving\"");
+                }
+            }
+            response["results"] = json::array();
+            for (const BOSignal& signal : evaluateScheduled(configs, schedule)) {
+                response["results"].push_back({{"ev_mean", signal.ev_mean},
+                                               {"ev_variance_of_mean", signal.ev_variance_of_mean},
+                                               {"fidelity", signal.fidelity}});
+            }
+            return response.dump() + "\n";
+        }
+        
+        BOSignal signal = evaluateProposal(request);
+        response["ev_mean"] = signal.ev_mean;
+        response["ev_variance_of_mean"] = signal.ev_variance_of_mean;
+        response["fidelity"] = signal.fidelity;
+    } catch (const std::exception& e) {
+        response["error"] = e.what();
+    }
+    return response.dump() + "\n";
+}
+
+static bool isBlank(const std::string& line) {
+    return line.find_first_not_of(" \t\r") == std::string::npos;
+}
+
+static void warmUp() {
+    auto start = timerClock::now();
+    initializeModulesOnce();
+    getIsoEngine();
+    getBaselineProfile();
+    std::cerr << "Evaluator daemon: ready (" << elapsed_sec(start) << " s warm-up)\n";
+}
+
+int serveStdio() {
+    // trainer / match progress goes to stdout -> move it to stderr, stdout carries results only
+    int resultFd = dup(STDOUT_FILENO);
+    FILE* results = resultFd >= 0 ? fdopen(resultFd, "w") : nullptr;
+    if (!results) {
+        std::cerr << "Evaluator daemon: cannot duplicate stdout\n";
+        return 1;
+    }
+    fflush(stdout);
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    warmUp();
+
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (isBlank(line)) continue;
+        std::string response = handleRequestLine(line);
+        fwrite(response.data(), 1, response.size(), results);
+        fflush(results);
+    }
+    fclose(results);
+    return 0;
+}
+
+int serveSocket(const std::string& path) {
+    sockaddr_un address{};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Evaluator daemon: bad socket path " << path << "\n";
+        return 1;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+    unlink(path.c_str()); // stale socket of an earlier daemon
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listener, 4) != 0) {
+        std::cerr << "Evaluator daemon: cannot listen on " << path << " (" << strerror(errno) << ")\n";
+        if (listener >= 0) close(listener);
+        return 1;
+    }
+
+    warmUp();
+
+    // one client at a time (every evaluation uses all threads anyway), the daemon outlives its clients
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "Evaluator daemon: accept failed (" << strerror(errno) << ")\n";
+            break;
+        }
+
+        std::string buffer;
+        char chunk[4096];
+        bool open = true;
+        while (open) {
+            ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) break;
+            buffer.append(chunk, static_cast<size_t>(received));
+
+            size_t newline;
+            while (open && (newline = buffer.find('\n')) != std::string::npos) {
+                std::string line = buffer.substr(0, newline);
+                buffer.erase(0, newline + 1);
+                if (isBlank(line)) continue;
+
+                std::string response = handleRequestLine(line);
+                const char* data = response.data();
+                size_t remaining = response.size();
+                while (remaining > 0) {
+                    ssize_t sent = send(client, data, remaining, MSG_NOSIGNAL);
+                    if (sent < 0 && errno == EINTR) continue;
+                    if (sent <= 0) { open = false; break; }
+                    data += sent;
+                    remaining -= static_cast<size_t>(sent);
+                }
+            }
+        }
+        close(client);
+    }
+
+    close(listener);
+    unlink(path.c_str());
+    return 1;
 }
 
 }
@@ -1,7 +1,10 @@
 #pragma once
 #include <cstdint>
 #include <cstddef>
+#include <string>
+#include <vector>
 #include <omp.h>
+#include "cfr/utils/deal_sampler.hpp"
 
 // NOTE: if you want to limit the number of threads used for training, reset the variable here!
 // NAO discovers the number of training-available cores
@@ -12,15 +15,57 @@ constexpr uint64_t nodeBudget = 200000000;
 // set duplicate hands amount run in heads up module here
 constexpr uint64_t duplicateHands = 2000000;
 
+// use the AIVAT-style corrected match estimate as the BO signal (raw estimate is still logged)
+// same confidence interval with far fewer duplicate hands -> duplicateHands can be lowered accordingly
+constexpr bool varianceReducedEvaluation = true;
+
+// screen candidates with the sequential match: stop as soon as the candidate is clearly worse than the baseline
+// (duplicateHands is then the upper limit, good candidates still play all of it)
+constexpr bool sequentialEvaluation = true;
+
+// warm start (daemon mode, see cfr-core/warm_start.hpp): a proposal is trained from the closest table trained earlier
+// in the process, keeping the streets whose sizes did not change, for warmStartBudgetFraction of nodeBudget
+// off by default: results then depend on the order of proposals
+constexpr bool warmStartTraining = false;
+constexpr double warmStartBudgetFraction = 0.5;
+constexpr int warmStartPoolSize = 2; // trained tables kept in memory as warm start candidates
+
+// how a batch of proposals shares the cores (the daemon's batch request can override it with "schedule")
+//  - Concurrent: q train-and-match pipelines side by side, cores split evenly
+//  - Pipelined: proposal N's match overlaps proposal N+1's training, the split adapts to the measured stage times
+//  - SuccessiveHalving: every proposal at a low budget first, only the best ones are promoted to more nodes and hands
+enum class BatchSchedule { Concurrent, Pipelined, SuccessiveHalving };
+constexpr BatchSchedule batchSchedule = BatchSchedule::Concurrent;
+constexpr double pipelineTrainShare = 0.75; // share of cores training in a pipelined step until both stages were measured
+
+// successive halving: rung r trains with nodeBudget / halvingEta^(halvingRungs - 1 - r) nodes (and as many fewer hands),
+// the best 1 / halvingEta of a rung are promoted -> 3 rungs, eta 3: 22M / 67M / 200M nodes
+constexpr int halvingRungs = 3;
+constexpr int halvingEta = 3;
+
+// shared training deals (see cfr/utils/deal_stream.hpp): cards, buckets and showdowns of dealStreamDeals deals are
+// computed once, mapped by every candidate's trainer, training then does no card abstraction work
+// off by default: the candidates then train on another deal sequence than before (results change)
+constexpr bool sharedDealStream = false;
+constexpr uint64_t dealStreamDeals = 8000000; // 22 bytes each, trainers wrap around when a run needs more
+inline const std::string dealStreamDir = "output/cache/deals";
+
+// deal sampling of the match: flop textures stratified over the canonical flops, stratified mean / standard error
+constexpr DealSampler::Mode evaluationDealSampling = DealSampler::Mode::Stratified;
+
 // constant seeds to minimize training and evaluation noise
 const uint64_t baseSeed = 42;
 const uint64_t trainingSeed = baseSeed;
 const uint64_t evaluatorSeed = baseSeed + 1337;
 
+// trained baselines are kept here (see baseline_cache.hpp), relative to the project root
+inline const std::string baselineCacheDir = "output/cache/baseline";
+
 // the evaluator will send these values as a signal back to the BO after running
 struct BOSignal {
     double ev_mean;
     double ev_variance_of_mean;
+    double fidelity = 1.0; // node budget of the run / nodeBudget (< 1 only in successive halving)
 };
 
 // the BO will propose a 9-dimension bet size vector, which will then be converted
@@ -40,18 +85,33 @@ struct LoggedValues {
     // using the bet sizes proposed by the BO which were then passed to the bet sequence module
     uint64_t infosetsCount;
     uint64_t totalNodesTouched; // how many nodes were touched across the whole MCCFR run
+    uint64_t nodeBudget; // node budget of this run (reduced when warm started)
+    uint64_t nodesSaved; // nodeBudget constant - budget of this run
+    uint32_t warmStartStreets; // leading streets reused from an earlier table (0 = cold start)
+    uint64_t warmStartInfosets; // infosets the run started from
+    uint32_t fidelityRung; // successive halving rung (0 otherwise)
+    double fidelity; // node budget / nodeBudget constant of the rung
     float averageRunPerNode; // totalNodesTouched / infosetCount - ratio number
     float avgAbsRegret;  // mean of the absolute values of all cumulative regrets across all nodes
     float maxAbsRegret; // single "worst" decision point in the entire game tree
     double mccfrTrainingSeconds; // how much time did it take to run the MCCFR on the game tree
     double evaluationSeconds; // time needed to evaluate the strategy with the heads up module
     uint64_t duplicateHands; // how many duplicate hands were used in the heads up simulation
+    bool stoppedEarly; // sequential evaluation ended before duplicateHands
+    bool varianceReduced; // evP0 / standardError are the corrected estimate
     double stdDevHandEV; // standard deviation of the N hand outcomes
     double standardError; // stdDev / sqrt(n)
     double evP0; // mean EV of P0 in chips (evP0 = -evP1)
     double evP0_bb100; // industry standard: Big Blinds per 100 hands
+    double rawEvP0; // duplicate-only estimate (equals evP0 when variance reduction is off)
+    double rawStandardError; // standard error of the duplicate-only estimate
     double cumulativeBestEV; // highest EV found up to the current evaluation iteration
     uint64_t trainerSeed; // seed used for MCCFR training
+    int trainingThreads; // cores of this evaluation (a share of them in batch mode)
+    int matchThreads; // cores of the match (differs from trainingThreads in pipelined mode)
+    bool pipelined; // the match overlapped the next proposal's training
+    double pipelineStepSeconds; // wall time of the pipeline step that ran this match
+    double pipelineUtilization; // busy core-seconds / (step seconds * threads) of that step
     uint64_t evaluatorSeed; // seed used for heads up evaluation run
 };
 
@@ -61,3 +121,29 @@ inline void sort3(double& a, double& b, double& c) {
     if (b > c) std::swap(b, c);
     if (a > b) std::swap(a, b);
 }
+
+namespace EvaluateBOProposal {
+
+// one proposal ({"x": [9 bet sizes]}) read from stdin, trained, matched against the baseline and logged to logs.jsonl
+BOSignal evaluatePostflopStrategy();
+
+/*
+Batch evaluation for TuRBO's q-point acquisition
+ - batchSchedule Concurrent: the q proposals run as concurrent train-and-match pipelines, the cores (threads) are split between them
+ - batchSchedule Pipelined: the proposals go through a two stage pipeline, a match runs next to the following training
+ - batchSchedule SuccessiveHalving: low fidelity runs for all, the best ones promoted to higher budgets (BOSignal::fidelity)
+ - each pipeline has its own bet config, trainer and strategy file, the baseline profile is shared
+ - returns one signal per proposal, in order, every proposal is logged like a single one
+ */
+std::vector<BOSignal> evaluateBatch(const std::vector<BOParams>& proposals);
+
+/*
+Long-running evaluator for the BO loop: newline-delimited JSON proposals in, one result line per proposal out
+ - modules, LUTs and the baseline profile are loaded once, a proposal then costs its training + match only
+ - serveStdio: requests on stdin, results on stdout (progress output is redirected to stderr), returns at EOF
+ - serveSocket: same protocol on a UNIX domain socket, clients are served one after another
+ */
+int serveStdio();
+int serveSocket(const std::string& path);
+
+}
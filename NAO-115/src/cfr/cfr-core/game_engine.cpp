@@ -141,12 +141,44 @@ bool isGamestateTerminal(const MCCFRState& state) {
     return state.isTerminal;
 }
 
+int showdownScore(const std::array<int,2>& hand, const std::array<int, 5>& board) {
+    return Eval::eval_7(hand[0], hand[1], board[0], board[1], board[2], board[3], board[4]);
+}
+
+int showdownWinner(const std::array<int,2>& player0hand,
+                   const std::array<int,2>& player1hand,
+                   const std::array<int, 5>& board) {
+    int score0 = showdownScore(player0hand, board);
+    int score1 = showdownScore(player1hand, board);
+    
+    if (score0 < score1) {
+        return 1;
+    }
+    
+    if (score1 < score0) {
+        return -1;
+    }
+    
+    return 0;
+}
+
 // calculate payoff of one game
 int getPayoff(const MCCFRState& state,
               const std::array<int,2>& player0hand,
               const std::array<int,2>& player1hand,
               const std::array<int, 5>& board) {
     
+    // fold -> cards don't matter
+    if (state.foldedPlayer != -1) {
+        return getPayoff(state, 0);
+    }
+    
+    // showdown, evaluate the winner
+    return getPayoff(state, showdownWinner(player0hand, player1hand, board));
+}
+
+int getPayoff(const MCCFRState& state, int showdownResult) {
+    
     // pot is the sum of what the two players have already contributed
     int pot = state.player0Contribution + state.player1Contribution;
     
@@ -159,22 +191,11 @@ int getPayoff(const MCCFRState& state,
         }
     }
     
-    // showdown, evaluate the winner
-    int score0 = Eval::eval_7(
-                              player0hand[0], player0hand[1],
-                              board[0], board[1], board[2], board[3], board[4]
-                              );
-    
-    int score1 = Eval::eval_7(
-                              player1hand[0], player1hand[1],
-                              board[0], board[1], board[2], board[3], board[4]
-                              );
-    
-    if (score0 < score1) {
+    if (showdownResult > 0) {
         return pot - state.player0Contribution;
     }
     
-    if (score1 < score0) {
+    if (showdownResult < 0) {
         return -state.player0Contribution;
     }
     
@@ -45,6 +45,28 @@ int getPayoff(const MCCFRState& state,
               const std::array<int,2>& player1hand,
               const std::array<int, 5>& board);
 
+/*
+Same payoff with the showdown already resolved (result of showdownWinner, ignored after a fold).
+ - walks that reach many terminals of one deal evaluate the hands once
+ */
+int getPayoff(const MCCFRState& state, int showdownResult);
+
+/*
+Showdown score of one hand on a complete board (eval_7, LOWER is stronger).
+ - range walks sort holdings by it instead of comparing hands pairwise
+ */
+int showdownScore(const std::array<int,2>& hand, const std::array<int, 5>& board);
+
+/*
+Showdown result between the two hands on a complete board.
+ - returns +1 if player 0 wins, -1 if player 1 wins, 0 on a split pot
+ - single place where hand strength is compared, getPayoff and anything estimating
+   showdown equity must go through it to stay consistent
+ */
+int showdownWinner(const std::array<int,2>& player0hand,
+                   const std::array<int,2>& player1hand,
+                   const std::array<int, 5>& board);
+
 /*
 Switch the current player — swap hero/villain fields.
 -> called internally by applyAction but exposed for testing
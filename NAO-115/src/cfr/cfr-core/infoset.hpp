@@ -42,6 +42,14 @@ struct alignas(64) Infoset {
     // Number of legal actions at this node (can be: 2 - MAX_ACTIONS)
     uint8_t numActions = 0; // 1 byte
     
+    // Street of the node (1 = flop .. 3 = river), set on first visit (lives in the padding, not serialized)
+    // a warm start uses it to keep only the streets whose bet sizes did not change
+    uint8_t street = 0; // 1 byte
+    
+    // Checkpoint epoch of the last update (lives in the padding, not serialized)
+    // the trainer compares it to its current epoch to collect the infosets a delta checkpoint has to write
+    uint32_t touchedEpoch = 0; // 4 bytes
+    
     // Set number ofa ctions on first visit, must be called exactly once (n must be in: 2 - MAX_ACTIONS)
     void initialize(int n) {
         numActions = static_cast<uint8_t>(n);
@@ -8,7 +8,8 @@
 
 namespace MCCFR {
 
-Trainer::Trainer(uint64_t seed) :
+Trainer::Trainer(uint64_t seed, const BetAbstraction::BetConfig& config) :
+    betConfig(config),
     targetNodeBudget(0),
     nodesTouched(0),
     rng(seed),
@@ -47,7 +48,8 @@ float Trainer::traverseExternalSampling(const MCCFRState& state,
     // check whether game is terminal
     if (GameEngine::isGamestateTerminal(state)) {
         // Calculate chips won/lost from Player 0's perspective
-        int payoff0 = GameEngine::getPayoff(state, p0_hand, p1_hand, board);
+        int payoff0 = currentDeal ? GameEngine::getPayoff(state, currentDeal->showdown)
+                                  : GameEngine::getPayoff(state, p0_hand, p1_hand, board);
         // Return payoff relative to the player we are currently updating
         if (updatePlayer == 0) {
             return static_cast<float>(payoff0);
@@ -58,7 +60,9 @@ float Trainer::traverseExternalSampling(const MCCFRState& state,
     
     // calculate bucketing locally
     int32_t currentBucket = 0;
-    if (state.currentPlayer == 0) {
+    if (currentDeal) {
+        currentBucket = currentDeal->buckets[state.currentPlayer][state.street - 1];
+    } else if (state.currentPlayer == 0) {
         currentBucket = getBucketId(state, p0_hand, board);
     } else {
         currentBucket = getBucketId(state, p1_hand, board);
@@ -67,12 +71,18 @@ float Trainer::traverseExternalSampling(const MCCFRState& state,
     // create infoset key
     InfosetKey key{state.historyHash, currentBucket};
     Infoset& infoset = infosetMap[key];
+    if (trackTouched && infoset.touchedEpoch != checkpointEpoch) {
+        if (trackIncrements) touchedBase.push_back(infoset);
+        infoset.touchedEpoch = checkpointEpoch;
+        touchedKeys.push_back(key);
+    }
     
-    BetAbstraction::ActionList legalActions = BetAbstraction::getLegalActions(state);
+    BetAbstraction::ActionList legalActions = BetAbstraction::getLegalActions(state, betConfig);
     
     
     if (infoset.numActions == 0) {
         infoset.initialize(legalActions.count);
+        infoset.street = static_cast<uint8_t>(state.street);
     }
     
     float strategy[MAX_ACTIONS];
@@ -151,6 +161,49 @@ float Trainer::traverseExternalSampling(const MCCFRState& state,
 }
 
 void Trainer::train(uint64_t nodeBudget) {
+    train(nodeBudget, 0, {});
+}
+
+robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> Trainer::takeTouched() {
+    robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> touched;
+    touched.reserve(touchedKeys.size());
+    for (const InfosetKey& key : touchedKeys) {
+        touched[key] = infosetMap[key];
+    }
+    touchedKeys.clear();
+    touchedBase.clear();
+    checkpointEpoch++;
+    return touched;
+}
+
+robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> Trainer::takeTouchedIncrements() {
+    robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> increments;
+    increments.reserve(touchedKeys.size());
+    for (size_t i = 0; i < touchedKeys.size(); ++i) {
+        Infoset increment = infosetMap[touchedKeys[i]];
+        const Infoset& base = touchedBase[i];
+        for (int a = 0; a < MAX_ACTIONS; ++a) {
+            increment.regretSum[a] -= base.regretSum[a];
+            increment.strategySum[a] -= base.strategySum[a];
+        }
+        increments[touchedKeys[i]] = increment;
+    }
+    touchedKeys.clear();
+    touchedBase.clear();
+    checkpointEpoch++;
+    return increments;
+}
+
+void Trainer::overwrite(const robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher>& values) {
+    for (const auto& [key, value] : values) {
+        Infoset& local = infosetMap[key];
+        uint32_t epoch = local.touchedEpoch; // an entry already touched in this epoch stays listed once
+        local = value;
+        local.touchedEpoch = epoch;
+    }
+}
+
+void Trainer::train(uint64_t nodeBudget, uint64_t checkpointNodes, const std::function<void()>& onCheckpoint) {
     targetNodeBudget = nodeBudget;
     nodesTouched = 0;
     iterations = 0;
@@ -160,10 +213,24 @@ void Trainer::train(uint64_t nodeBudget) {
     std::array<int, 52> deck;
     for (int i = 0; i < 52; ++i) deck[i] = i;
     
+    uint64_t nextCheckpoint = checkpointNodes;
+    trackTouched = checkpointNodes > 0;
+    
     while (nodesTouched < targetNodeBudget) {
-        for (int j = 0; j < 9; ++j) {
-            int k = j + rng() % (52 - j);
-            std::swap(deck[j], deck[k]);
+        if (checkpointNodes > 0 && nodesTouched >= nextCheckpoint) {
+            onCheckpoint();
+            nextCheckpoint = nodesTouched + checkpointNodes;
+        }
+        
+        if (dealStream) {
+            currentDeal = &(*dealStream)[nextDeal];
+            nextDeal += dealStride;
+            for (int j = 0; j < 9; ++j) deck[j] = currentDeal->cards[j];
+        } else {
+            for (int j = 0; j < 9; ++j) {
+                int k = j + rng() % (52 - j);
+                std::swap(deck[j], deck[k]);
+            }
         }
         
         std::array<int, 2> p0_hand = {deck[0], deck[1]};
@@ -197,6 +264,7 @@ void Trainer::train(uint64_t nodeBudget) {
         handsPlayed++;
         iterations++;
     }
+    currentDeal = nullptr;
     
     //std::cout << "Training Complete. Total Infosets: " << infosetMap.size() << "\n";
 }
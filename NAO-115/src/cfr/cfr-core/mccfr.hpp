@@ -3,10 +3,15 @@
 #include <cstdint>
 #include <array>
 #include <random>
+#include <functional>
+#include <memory>
+#include <vector>
 #include "mccfr_state.hpp"
 #include "hand-bucketing/mapping_engine.hpp"
 #include "infoset.hpp"
 #include "cfr/external/robin_hood.h"
+#include "bet-abstraction/bet_utils.hpp"
+#include "cfr/utils/deal_stream.hpp"
 
 namespace MCCFR {
 
@@ -17,12 +22,31 @@ private:
     // main strategy table - key: (HistoryHash ^ (BucketId << 32))
     robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> infosetMap;
     
+    // bet abstraction this trainer expands (own copy, never shared between threads)
+    const BetAbstraction::BetConfig betConfig;
+    
     uint64_t targetNodeBudget;
     uint64_t nodesTouched;
     
     std::mt19937 rng;
     std::uniform_real_distribution<float> dist;
     bool traceMode;
+    
+    // delta checkpoints: infosets updated since the last takeTouched() (first update in the epoch appends the key)
+    // only tracked while a checkpointing run is active, a plain run keeps no key list
+    bool trackTouched = false;
+    uint32_t checkpointEpoch = 1;
+    std::vector<InfosetKey> touchedKeys;
+    
+    // distributed training: value of each touched infoset before its first update in the epoch (parallel to touchedKeys)
+    bool trackIncrements = false;
+    std::vector<Infoset> touchedBase;
+    
+    // precomputed deals (see deal_stream.hpp): buckets and showdown come from the record of the current deal
+    std::shared_ptr<const DealStream::Stream> dealStream;
+    uint64_t nextDeal = 0;
+    uint64_t dealStride = 1;
+    const DealStream::Record* currentDeal = nullptr;
 
     // get abstraction bucket for acting player
     int32_t getBucketId(const MCCFRState& state, const std::array<int, 2>& hand, const std::array<int, 5>& board);
@@ -37,11 +61,39 @@ private:
 public:
     int threadId;
     
-    Trainer(uint64_t seed = 1337);
+    const BetAbstraction::BetConfig& getBetConfig() const {
+        return betConfig;
+    }
+    
+    explicit Trainer(uint64_t seed = 1337,
+                     const BetAbstraction::BetConfig& config = BetAbstraction::BetConfig{});
     uint64_t iterations = 0;
 
     // main training loop
     void train(uint64_t nodeBudget);
+    
+    // same loop, calls onCheckpoint on the training thread every checkpointNodes nodes (0 = never)
+    void train(uint64_t nodeBudget, uint64_t checkpointNodes, const std::function<void()>& onCheckpoint);
+    
+    // copies of the infosets updated since the previous call (all of them on the first call), starts a new epoch
+    robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> takeTouched();
+    
+    /*
+    Distributed training (see mccfr_distributed.hpp)
+     - with increment tracking on, the trainer also keeps the value an infoset had before its first update in the epoch
+     - takeTouchedIncrements returns current - previous regretSum / strategySum of the touched infosets, starts a new epoch
+     - overwrite replaces local entries with the synchronized (global) values
+     */
+    void setIncrementTracking(bool enabled) { trackIncrements = enabled; }
+    robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> takeTouchedIncrements();
+    void overwrite(const robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher>& values);
+    
+    // read deals first, first + stride, ... of the stream instead of sampling cards (nullptr: sample as usual)
+    void setDealStream(std::shared_ptr<const DealStream::Stream> stream, uint64_t first = 0, uint64_t stride = 1) {
+        dealStream = std::move(stream);
+        nextDeal = first;
+        dealStride = stride;
+    }
 
     // extract final table size after training
     size_t getNumInfosets() const {
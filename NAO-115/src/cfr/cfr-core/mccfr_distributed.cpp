@@ -0,0 +1,381 @@
+#include "mccfr_distributed.hpp"
+#include "mccfr_multithread.hpp"
+#include "cfr/strategy-eval/strategy_io.hpp"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <unistd.h>
+#include <cerrno>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace MCCFR {
+
+#pragma pack(push, 1)
+struct MessageHeader {
+    uint32_t magic;      // DISTRIBUTED_MAGIC
+    uint16_t version;    // DISTRIBUTED_VERSION
+    uint16_t type;       // MessageType
+    uint64_t numEntries; // FullEntry records following the header
+};
+static_assert(sizeof(MessageHeader) == 16, "Message Header must be 16 bytes");
+#pragma pack(pop)
+
+/*
+ Internal: endpoint parsing and blocking socket helpers
+ */
+struct Endpoint {
+    bool isUnix = false;
+    std::string path; // unix
+    std::string host; // tcp
+    std::string port;
+};
+
+static bool parseEndpoint(const std::string& text, Endpoint& out) {
+    if (text.rfind("unix:", 0) == 0) {
+        out.isUnix = true;
+        out.path = text.substr(5);
+        if (out.path.empty() || out.path.size() >= sizeof(sockaddr_un::sun_path)) {
+            fprintf(stderr, "Distributed: bad unix socket path '%s'\n", out.path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    // tcp:host:port (the prefix is optional)
+    std::string rest = text.rfind("tcp:", 0) == 0 ? text.substr(4) : text;
+    size_t colon = rest.rfind(':');
+    if (colon == std::string::npos || colon + 1 == rest.size()) {
+        fprintf(stderr, "Distributed: bad endpoint '%s' (unix:/path or tcp:host:port)\n", text.c_str());
+        return false;
+    }
+    out.isUnix = false;
+    out.host = rest.substr(0, colon);
+    out.port = rest.substr(colon + 1);
+    return true;
+}
+
+static bool sendAll(int fd, const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    while (size > 0) {
+        ssize_t sent = ::send(fd, bytes, size, MSG_NOSIGNAL);
+        if (sent < 0 && errno == EINTR) continue;
+        if (sent <= 0) return false;
+        bytes += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+static bool recvAll(int fd, void* data, size_t size) {
+    uint8_t* bytes = static_cast<uint8_t*>(data);
+    while (size > 0) {
+        ssize_t received = ::recv(fd, bytes, size, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        bytes += received;
+        size -= static_cast<size_t>(received);
+    }
+    return true;
+}
+
+static bool sendEncoded(int fd, MessageType type, const std::vector<uint8_t>& payload) {
+    MessageHeader header{DISTRIBUTED_MAGIC, DISTRIBUTED_VERSION, static_cast<uint16_t>(type),
+                         payload.size() / StrategyIO::FULL_ENTRY_BYTES};
+    if (header.numEntries > MAX_MESSAGE_ENTRIES) {
+        fprintf(stderr, "Distributed: message of %llu entries exceeds the limit\n",
+                static_cast<unsigned long long>(header.numEntries));
+        return false;
+    }
+    return sendAll(fd, &header, sizeof(header)) && sendAll(fd, payload.data(), payload.size());
+}
+
+static bool sendMessage(int fd, MessageType type, const DistributedMap& map) {
+    std::vector<uint8_t> payload;
+    StrategyIO::encodeEntries(map, payload);
+    return sendEncoded(fd, type, payload);
+}
+
+static bool receiveMessage(int fd, MessageType& type, DistributedMap& out) {
+    MessageHeader header{};
+    if (!recvAll(fd, &header, sizeof(header))) return false;
+    if (header.magic != DISTRIBUTED_MAGIC || header.version != DISTRIBUTED_VERSION) {
+        fprintf(stderr, "Distributed: unexpected message (magic %08X, version %u)\n", header.magic, header.version);
+        return false;
+    }
+    if (header.type < static_cast<uint16_t>(MessageType::Delta) || header.type > static_cast<uint16_t>(MessageType::Done) ||
+        header.numEntries > MAX_MESSAGE_ENTRIES) {
+        fprintf(stderr, "Distributed: garbage message (type %u, %llu entries)\n", header.type,
+                static_cast<unsigned long long>(header.numEntries));
+        return false;
+    }
+    type = static_cast<MessageType>(header.type);
+
+    // slice by slice: a header announcing more than is sent costs one slice, not the announced size
+    static constexpr uint64_t SLICE_ENTRIES = 1 << 16;
+    std::vector<uint8_t> slice;
+    out.clear();
+    for (uint64_t received = 0; received < header.numEntries;) {
+        uint64_t entries = std::min(SLICE_ENTRIES, header.numEntries - received);
+        slice.resize(entries * StrategyIO::FULL_ENTRY_BYTES);
+        if (!recvAll(fd, slice.data(), slice.size())) return false;
+        if (!StrategyIO::decodeEntries(slice.data(), entries, out)) return false;
+        received += entries;
+    }
+    return true;
+}
+
+static int listenOn(const Endpoint& endpoint, int backlog) {
+    if (endpoint.isUnix) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, endpoint.path.c_str(), sizeof(address.sun_path) - 1);
+        ::unlink(endpoint.path.c_str()); // stale socket of an earlier run
+
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, backlog) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    addrinfo* results = nullptr;
+    const char* host = endpoint.host.empty() || endpoint.host == "*" ? nullptr : endpoint.host.c_str();
+    if (getaddrinfo(host, endpoint.port.c_str(), &hints, &results) != 0) return -1;
+
+    int fd = -1;
+    for (addrinfo* ai = results; ai && fd < 0; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (::bind(fd, ai->ai_addr, ai->ai_addrlen) != 0 || ::listen(fd, backlog) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(results);
+    return fd;
+}
+
+static int connectOnce(const Endpoint& endpoint) {
+    if (endpoint.isUnix) {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, endpoint.path.c_str(), sizeof(address.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* results = nullptr;
+    if (getaddrinfo(endpoint.host.c_str(), endpoint.port.c_str(), &hints, &results) != 0) return -1;
+
+    int fd = -1;
+    for (addrinfo* ai = results; ai && fd < 0; ai = ai->ai_next) {
+        fd = ::socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(results);
+
+    if (fd >= 0) {
+        // messages are written header + payload, don't hold the small header back
+        int noDelay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    }
+    return fd;
+}
+
+// PUBLIC API functions
+
+WorkerLink::~WorkerLink() {
+    if (fd >= 0) ::close(fd);
+}
+
+bool WorkerLink::connect(const std::string& endpointText, int timeoutMs) {
+    Endpoint endpoint;
+    if (!parseEndpoint(endpointText, endpoint)) return false;
+
+    // the coordinator may not be listening yet -> retry until the timeout
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    while ((fd = connectOnce(endpoint)) < 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            fprintf(stderr, "Distributed: cannot connect to %s\n", endpointText.c_str());
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    return true;
+}
+
+bool WorkerLink::exchange(const DistributedMap& increments, DistributedMap& update) {
+    if (fd < 0 || !sendMessage(fd, MessageType::Delta, increments)) return false;
+
+    MessageType type;
+    if (!receiveMessage(fd, type, update)) return false;
+    if (type != MessageType::Update) {
+        fprintf(stderr, "Distributed: expected an update, got message type %u\n", static_cast<unsigned>(type));
+        return false;
+    }
+    return true;
+}
+
+bool WorkerLink::finish(const DistributedMap& increments) {
+    if (fd < 0) return false;
+    bool sent = sendMessage(fd, MessageType::Done, increments);
+    ::close(fd);
+    fd = -1;
+    return sent;
+}
+
+bool DistributedCoordinator::run() {
+    Endpoint address;
+    if (!parseEndpoint(endpoint, address)) return false;
+
+    int listener = listenOn(address, numWorkers);
+    if (listener < 0) {
+        fprintf(stderr, "Distributed: cannot listen on %s (%s)\n", endpoint.c_str(), strerror(errno));
+        return false;
+    }
+
+    printf("Distributed coordinator: %s, waiting for %d workers\n", endpoint.c_str(), numWorkers);
+
+    std::vector<int> workers;
+    while (static_cast<int>(workers.size()) < numWorkers) {
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            fprintf(stderr, "Distributed: accept failed (%s)\n", strerror(errno));
+            break;
+        }
+        if (!address.isUnix) {
+            int noDelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        }
+        workers.push_back(fd);
+    }
+    ::close(listener);
+    if (address.isUnix) ::unlink(address.path.c_str());
+
+    bool ok = static_cast<int>(workers.size()) == numWorkers;
+    std::vector<bool> active(workers.size(), true);
+    size_t numActive = workers.size();
+
+    DistributedMap received;
+    DistributedMap update;
+    std::vector<InfosetKey> roundKeys;
+    std::vector<int> waiting;
+    std::vector<uint8_t> payload;
+
+    while (numActive > 0) {
+        roundKeys.clear();
+        waiting.clear();
+
+        // 1. one message from every active worker (blocking, in connection order)
+        for (size_t w = 0; w < workers.size(); ++w) {
+            if (!active[w]) continue;
+
+            MessageType type;
+            if (!receiveMessage(workers[w], type, received) ||
+                (type != MessageType::Delta && type != MessageType::Done)) {
+                // lost worker: drop it, the others keep training
+                fprintf(stderr, "Distributed: worker %zu disconnected or sent garbage, dropped\n", w);
+                active[w] = false;
+                numActive--;
+                ok = false;
+                continue;
+            }
+
+            // 2. increments go straight into the global table
+            ParallelTrainer::mergeMaps(globalMap, received);
+
+            if (type == MessageType::Done) {
+                active[w] = false;
+                numActive--;
+                continue;
+            }
+
+            for (const auto& entry : received) {
+                roundKeys.push_back(entry.first);
+            }
+            waiting.push_back(workers[w]);
+        }
+
+        // 3. global values of everything touched this round, encoded once for all workers
+        update.clear();
+        update.reserve(roundKeys.size());
+        for (const InfosetKey& key : roundKeys) {
+            update[key] = globalMap[key];
+        }
+
+        payload.clear();
+        StrategyIO::encodeEntries(update, payload);
+        for (int fd : waiting) {
+            if (!sendEncoded(fd, MessageType::Update, payload)) {
+                // the worker's next receive fails and drops it
+                fprintf(stderr, "Distributed: failed to send update\n");
+            }
+        }
+        rounds++;
+    }
+
+    for (int fd : workers) {
+        ::close(fd);
+    }
+
+    printf("Distributed coordinator: %llu rounds, %zu infosets\n",
+           static_cast<unsigned long long>(rounds), globalMap.size());
+    return ok;
+}
+
+bool DistributedWorker::train(const std::string& endpoint, uint64_t nodeBudget, uint64_t syncNodes, uint64_t seed) {
+    WorkerLink link;
+    if (!link.connect(endpoint)) return false;
+
+    Trainer trainer(seed, betConfig);
+    trainer.setIncrementTracking(true);
+    if (syncNodes == 0) syncNodes = nodeBudget; // no intermediate syncs, touched infosets are still tracked for the DONE message
+
+    bool ok = true;
+    trainer.train(nodeBudget, syncNodes, [&]() {
+        DistributedMap increments = trainer.takeTouchedIncrements();
+        if (!ok) return; // connection lost earlier -> keep training locally
+
+        DistributedMap update;
+        ok = link.exchange(increments, update);
+        if (ok) trainer.overwrite(update);
+    });
+
+    if (ok) ok = link.finish(trainer.takeTouchedIncrements());
+
+    numInfosets = trainer.getNumInfosets();
+    nodesTouched = trainer.getNodesTouched();
+    return ok;
+}
+
+}
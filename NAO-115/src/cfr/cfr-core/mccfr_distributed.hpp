@@ -0,0 +1,122 @@
+#pragma once
+
+/*
+Distributed MCCFR: several processes (on one host or several) train the same table and synchronize it periodically.
+
+ Roles:
+    - coordinator: owns the global table, listens on an endpoint, waits for numWorkers workers
+    - worker: a normal Trainer on its own deal stream (own seed), every syncNodes nodes it sends the
+      increments of the infosets it touched since its last sync and overwrites them with the global values
+
+ Rounds (synchronous):
+    1. every active worker sends DELTA (regretSum / strategySum increments of its touched infosets) or DONE (last increments)
+    2. coordinator adds all increments to the global table (ParallelTrainer::mergeMaps, same rule as the threads' merge)
+    3. coordinator sends UPDATE (global values of every infoset touched by any worker this round) to the DELTA senders
+    -> after a sync every worker sees the other workers' updates on everything it touched, nothing is summed twice
+
+ Wire format (host byte order, all peers must share the architecture):
+    [MessageHeader]                       magic "NAOD", protocol version, type, entry count
+    [StrategyIO full entry x count]       61-byte FullEntry layout of the strategy files, uncompressed
+    - count is capped at MAX_MESSAGE_ENTRIES on both sides, a bigger header is rejected as garbage
+    - the payload is read in slices, memory follows the bytes that actually arrive, not the header's count
+
+ Endpoints:
+    - "unix:/tmp/nao.sock"      UNIX domain socket (one host, all workers on loopback)
+    - "tcp:127.0.0.1:7100"      TCP, the coordinator binds host:port, workers connect to it
+
+ Notes:
+    - a key-hash partition per worker does not fit external sampling (one traversal touches keys of every
+      partition), so workers split the work by deal stream instead
+    - traffic per sync is bounded by the touched set, not by the table size
+ */
+
+#include "mccfr.hpp"
+#include "cfr/external/robin_hood.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace MCCFR {
+
+using DistributedMap = robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher>;
+
+static constexpr uint32_t DISTRIBUTED_MAGIC = 0x4E414F44; // "NAOD"
+static constexpr uint16_t DISTRIBUTED_VERSION = 1;
+
+// largest message a peer sends or accepts (~8 GB of entries, beyond any table a single trainer holds)
+static constexpr uint64_t MAX_MESSAGE_ENTRIES = 1ULL << 27;
+
+enum class MessageType : uint16_t {
+    Delta  = 1, // worker -> coordinator, increments, waits for an Update
+    Update = 2, // coordinator -> worker, global values
+    Done   = 3  // worker -> coordinator, last increments, no reply
+};
+
+/*
+Worker side of the connection, used by DistributedWorker (and directly by tests)
+ - connect retries until timeoutMs, so workers may start before the coordinator
+ - every call returns false on a broken connection or protocol error
+ */
+class WorkerLink {
+public:
+    WorkerLink() = default;
+    ~WorkerLink();
+    WorkerLink(const WorkerLink&) = delete;
+    WorkerLink& operator=(const WorkerLink&) = delete;
+
+    bool connect(const std::string& endpoint, int timeoutMs = 10000);
+
+    // send increments, block until the coordinator's update arrives
+    bool exchange(const DistributedMap& increments, DistributedMap& update);
+
+    // send the last increments and close the connection
+    bool finish(const DistributedMap& increments);
+
+private:
+    int fd = -1;
+};
+
+class DistributedCoordinator {
+public:
+    DistributedCoordinator(std::string endpoint, int numWorkers)
+    : endpoint(std::move(endpoint)), numWorkers(numWorkers) {}
+
+    /*
+    Listen, accept numWorkers workers and run rounds until every worker sent DONE
+     - returns false if the endpoint cannot be opened or a worker breaks the protocol
+     */
+    bool run();
+
+    DistributedMap& getInfosetMap() { return globalMap; }
+    const DistributedMap& getInfosetMap() const { return globalMap; }
+    uint64_t getRounds() const { return rounds; }
+
+private:
+    std::string endpoint;
+    int numWorkers;
+    DistributedMap globalMap;
+    uint64_t rounds = 0;
+};
+
+class DistributedWorker {
+public:
+    explicit DistributedWorker(const BetAbstraction::BetConfig& config = BetAbstraction::BetConfig{})
+    : betConfig(config) {}
+
+    /*
+    Train nodeBudget nodes on the deal stream of seed, synchronize every syncNodes nodes
+     - returns false if the coordinator is unreachable or the connection breaks
+       (training then continues locally, the final increments are lost)
+     */
+    bool train(const std::string& endpoint, uint64_t nodeBudget, uint64_t syncNodes, uint64_t seed);
+
+    size_t getNumInfosets() const { return numInfosets; }
+    uint64_t getNodesTouched() const { return nodesTouched; }
+
+private:
+    BetAbstraction::BetConfig betConfig;
+    size_t numInfosets = 0;
+    uint64_t nodesTouched = 0;
+};
+
+}
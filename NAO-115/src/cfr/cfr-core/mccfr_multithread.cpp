@@ -1,4 +1,6 @@
 #include "mccfr_multithread.hpp"
+#include "cfr/strategy-eval/checkpoint.hpp"
+#include <memory>
 #include <thread>
 #include <vector>
 #include <cstdio>
@@ -41,7 +43,7 @@ void ParallelTrainer::mergeMaps(
     }
 }
 
-void ParallelTrainer::train(uint64_t totalNodesBudget, int numThreads, uint64_t baseSeed = 1337) {
+void ParallelTrainer::train(uint64_t totalNodesBudget, int numThreads, uint64_t baseSeed, const CheckpointOptions& checkpoints) {
 
     // get number of mccfr iterations each thread should perform in this run
     uint64_t nodesPerThread = totalNodesBudget / numThreads;
@@ -56,15 +58,49 @@ void ParallelTrainer::train(uint64_t totalNodesBudget, int numThreads, uint64_t
     
     for (int t = 0; t < numThreads; ++t) {
         // unique seed for each thread to generate different hand sequences
-        trainers[t] = new Trainer(baseSeed + t * 999983);
+        trainers[t] = new Trainer(baseSeed + t * 999983, betConfig);
         trainers[t]->threadId = t;
+        if (dealStream) {
+            trainers[t]->setDealStream(dealStream, dealStreamStart + t, numThreads);
+        }
+    }
+    
+    // delta checkpoints: each thread copies its touched infosets, the writer thread compresses + writes them
+    std::unique_ptr<Checkpoint::Writer> writer;
+    if (!checkpoints.prefix.empty() && checkpoints.intervalNodes > 0) {
+        writer = std::make_unique<Checkpoint::Writer>(checkpoints.prefix, 2 * static_cast<size_t>(numThreads));
     }
     
     // launch threads
     for (int t = 0; t < numThreads; ++t) {
-            threads.emplace_back([t, nodesPerThread, &trainers]() {
+            threads.emplace_back([this, t, numThreads, nodesPerThread, &trainers, &writer, &checkpoints]() {
+        
+                // warm start: scaled copy of the initial table, filled by the thread itself
+                if (!initialMap.empty()) {
+                    const float scale = 1.0f / static_cast<float>(numThreads);
+                    auto& local = trainers[t]->getInfosetMap();
+                    local.reserve(initialMap.size());
+                    for (const auto& [key, initial] : initialMap) {
+                        Infoset infoset = initial;
+                        for (int a = 0; a < MAX_ACTIONS; ++a) {
+                            infoset.regretSum[a] *= scale;
+                            infoset.strategySum[a] *= scale;
+                        }
+                        local[key] = infoset;
+                    }
+                }
         
-                trainers[t]->train(nodesPerThread);
+                if (!writer) {
+                    trainers[t]->train(nodesPerThread);
+                    return;
+                }
+                
+                uint64_t sequence = 0;
+                trainers[t]->train(nodesPerThread, checkpoints.intervalNodes, [&]() {
+                    writer->submit(t, sequence++, trainers[t]->takeTouched());
+                });
+                // closing delta, the chain covers the whole run
+                writer->submit(t, sequence, trainers[t]->takeTouched());
             });
         }
     
@@ -73,6 +109,13 @@ void ParallelTrainer::train(uint64_t totalNodesBudget, int numThreads, uint64_t
         th.join();
     }
     
+    // the warm start table is used by one run only
+    initialMap = {};
+    
+    if (writer && !writer->finish()) {
+        fprintf(stderr, "ParallelTrainer: some checkpoints under %s could not be written\n", checkpoints.prefix.c_str());
+    }
+    
     totalNodesTouched = 0;
     for (int t = 0; t < numThreads; ++t) {
         totalNodesTouched += trainers[t]->getNodesTouched();
@@ -99,7 +142,7 @@ size_t ParallelTrainer::getNumInfosets() const {
 int32_t ParallelTrainer::getBucketIdPublic(const MCCFRState& state, const std::array<int,2>& hand, const std::array<int,5>& board) {
     // delegate to a temporary trainer for bucket lookup
     // this is only used for testing — not called during training
-    Trainer tmp;
+    Trainer tmp(1337, betConfig);
     return tmp.getBucketIdPublic(state, hand, board);
 }
 
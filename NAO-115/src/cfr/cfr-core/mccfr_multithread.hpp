@@ -4,9 +4,24 @@
 #include <vector>
 #include <thread>
 #include <cstdint>
+#include <string>
+#include <utility>
 
 namespace MCCFR {
 
+/*
+Delta checkpoints during training (see strategy-eval/checkpoint.hpp)
+ - every intervalNodes nodes (per thread) each thread hands the infosets it updated since its previous
+   checkpoint to a background writer and keeps training
+ - disabled when prefix is empty or intervalNodes is 0
+ - the chains can be folded back into a full file with Checkpoint::compact(prefix, numThreads, ...)
+   (nao_compact tool, nao_run train enables checkpoints from the command line)
+ */
+struct CheckpointOptions {
+    std::string prefix;
+    uint64_t intervalNodes = 0;
+};
+
 /*
 Parallel MCCFR trainer:
  - threads runs 'N/numThreads' iterations in separation
@@ -16,7 +31,29 @@ Parallel MCCFR trainer:
 
 class ParallelTrainer {
 public:
-    void train(uint64_t totalNodesBudget, int numThreads, uint64_t baseSeed);
+    // every thread's Trainer gets a copy of this bet abstraction
+    explicit ParallelTrainer(const BetAbstraction::BetConfig& config = BetAbstraction::BetConfig{})
+    : betConfig(config) {}
+    
+    const BetAbstraction::BetConfig& getBetConfig() const {
+        return betConfig;
+    }
+    
+    void train(uint64_t totalNodesBudget, int numThreads, uint64_t baseSeed,
+               const CheckpointOptions& checkpoints = CheckpointOptions{});
+    
+    // warm start for the next train() call (see warm_start.hpp): every thread starts from initial scaled by 1/numThreads
+    // -> same regret-matching strategy in every thread, the merged map is initial + the run's updates
+    void setInitialMap(robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> initial) {
+        initialMap = std::move(initial);
+    }
+    
+    // precomputed deals for every following train() call (see deal_stream.hpp), nullptr = sampled deals
+    // thread t reads deals firstDeal + t, firstDeal + t + numThreads, ...
+    void setDealStream(std::shared_ptr<const DealStream::Stream> stream, uint64_t firstDeal = 0) {
+        dealStream = std::move(stream);
+        dealStreamStart = firstDeal;
+    }
 
     // report how many unique infosets were learned across all threads
     size_t getNumInfosets() const;
@@ -36,16 +73,25 @@ public:
                                const std::array<int,2>& hand,
                                const std::array<int,5>& board);
 
-private:
-    // global, merged infoset map
-    robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> mergedMap;
-    uint64_t totalNodesTouched = 0;
-
     // merge srcMap into dstMap by adding regretSum and strategySum
     // numActions is taken from whichever map has the entry, if both have the entry, sums are added
+    // (also used to fold per-thread checkpoints)
     static void mergeMaps(
         robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher>& dst,
         const robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher>& src);
+
+private:
+    BetAbstraction::BetConfig betConfig;
+    
+    // global, merged infoset map
+    robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> mergedMap;
+    
+    // warm start table, consumed by the next train()
+    robin_hood::unordered_flat_map<InfosetKey, Infoset, InfosetKeyHasher> initialMap;
+    
+    std::shared_ptr<const DealStream::Stream> dealStream;
+    uint64_t dealStreamStart = 0;
+    uint64_t totalNodesTouched = 0;
 };
 
 }
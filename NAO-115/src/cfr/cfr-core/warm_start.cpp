@@ -0,0 +1,54 @@
+#include "warm_start.hpp"
+#include <cmath>
+#include <cstdint>
+
+namespace WarmStart {
+
+static bool sameStreet(const int32_t* numA, const int32_t* denA, const int32_t* numB, const int32_t* denB) {
+    for (int i = 0; i < 3; ++i) {
+        // compare the fractions, not the ratio representation
+        if (static_cast<int64_t>(numA[i]) * denB[i] != static_cast<int64_t>(numB[i]) * denA[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static double streetDistance(const int32_t* numA, const int32_t* denA, const int32_t* numB, const int32_t* denB) {
+    double distance = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        double a = static_cast<double>(numA[i]) / denA[i];
+        double b = static_cast<double>(numB[i]) / denB[i];
+        distance += std::abs(std::log(a / b));
+    }
+    return distance;
+}
+
+int sharedStreets(const BetAbstraction::BetConfig& a, const BetAbstraction::BetConfig& b) {
+    if (!sameStreet(a.flop_numerators, a.flop_denominators, b.flop_numerators, b.flop_denominators)) return 0;
+    if (!sameStreet(a.turn_numerators, a.turn_denominators, b.turn_numerators, b.turn_denominators)) return 1;
+    if (!sameStreet(a.river_numerators, a.river_denominators, b.river_numerators, b.river_denominators)) return 2;
+    return 3;
+}
+
+double sizeDistance(const BetAbstraction::BetConfig& a, const BetAbstraction::BetConfig& b) {
+    return streetDistance(a.flop_numerators, a.flop_denominators, b.flop_numerators, b.flop_denominators)
+         + streetDistance(a.turn_numerators, a.turn_denominators, b.turn_numerators, b.turn_denominators)
+         + streetDistance(a.river_numerators, a.river_denominators, b.river_numerators, b.river_denominators);
+}
+
+InfosetMap transfer(const InfosetMap& source, int streets) {
+    InfosetMap out;
+    if (streets <= 0) return out;
+
+    for (const auto& [key, infoset] : source) {
+        if (infoset.street >= 1 && infoset.street <= streets) {
+            MCCFR::Infoset copy = infoset;
+            copy.touchedEpoch = 0;
+            out[key] = copy;
+        }
+    }
+    return out;
+}
+
+}
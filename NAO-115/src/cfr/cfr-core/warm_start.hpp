@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+Warm start of an MCCFR run from a table trained with a nearby bet abstraction.
+
+ Infosets are matched across abstractions by structure: the history hash XORs Zobrist keys of
+ (street, player, raiseCount, action index), never of bet amounts -> the same key is the same action
+ sequence (by size index) under both configs.
+
+ What can be reused:
+    - an infoset on street s depends on the sizes of streets 1..s (pot and stacks come from them, its own actions are sized by s)
+    - so with the first k streets unchanged (sharedStreets), infosets on streets 1..k keep their regrets and strategy sums
+      e.g. only river sizes moved -> flop and turn infosets are reused, river infosets start from zero
+    - entries whose street is unknown (loaded from a file, Infoset::street = 0) are never reused
+ */
+
+#include "infoset.hpp"
+#include "cfr/external/robin_hood.h"
+#include "bet-abstraction/bet_utils.hpp"
+
+namespace WarmStart {
+
+using InfosetMap = robin_hood::unordered_flat_map<MCCFR::InfosetKey, MCCFR::Infoset, MCCFR::InfosetKeyHasher>;
+
+// leading postflop streets with identical sizes: 0 (flop differs) .. 3 (same config)
+int sharedStreets(const BetAbstraction::BetConfig& a, const BetAbstraction::BetConfig& b);
+
+// sum of |log(size_a / size_b)| over the 9 pot fractions, 0 for identical configs (ranks candidates with equal sharedStreets)
+double sizeDistance(const BetAbstraction::BetConfig& a, const BetAbstraction::BetConfig& b);
+
+// the infosets of source on streets 1..streets
+InfosetMap transfer(const InfosetMap& source, int streets);
+
+}
@@ -8,13 +8,15 @@
 
 namespace BestResponse {
 
-float computeBestResponse(
+template <typename StrategySource>
+static float bestResponseWalk(
     int brPlayer,
     const MCCFRState& state,
     const std::array<int, 2>& p0_hand,
     const std::array<int, 2>& p1_hand,
     const std::array<int, 5>& board,
-    const InfosetMap& map,
+    const StrategySource& map,
+    const BetAbstraction::BetConfig& betConfig,
     Bucketer::IsomorphismEngine& mappingEngine)
 {
 
@@ -31,7 +33,7 @@ float computeBestResponse(
     }
 
     // get branching factor at this node
-    auto actions = BetAbstraction::getLegalActions(state);
+    auto actions = BetAbstraction::getLegalActions(state, betConfig);
 
     // Infoset key construction part
     // compute hand abstraction bucket for acting player (used in key)
@@ -69,8 +71,8 @@ float computeBestResponse(
             // update game state with the action's consequences
             next = GameEngine::applyAction(next, actions.actions[i]);
 
-            float ev = computeBestResponse(
-                brPlayer, next, p0_hand, p1_hand, board, map, mappingEngine);
+            float ev = bestResponseWalk(
+                brPlayer, next, p0_hand, p1_hand, board, map, betConfig, mappingEngine);
 
             // evaluate all actions and take max EV (best response)
             if (ev > bestEV) {
@@ -87,12 +89,8 @@ float computeBestResponse(
     bool validStrategy = false;
 
     // -> 'do we know opponent strategy at this infoset?'
-    InfosetMap::const_iterator it = map.find(key);
-    
-    // if infoset exists and the count of the actions is a match
-    if (it != map.end() && it->second.numActions == actions.count) {
-        // then fill the strategy buffer
-        it->second.getAverageStrategy(strategy);
+    // if infoset exists and the count of the actions is a match, fill the strategy buffer
+    if (lookupAverageStrategy(map, key, actions.count, strategy)) {
 
         // validate distribution
         float sum = 0.0f;
@@ -130,11 +128,173 @@ float computeBestResponse(
         next.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][i];
         next = GameEngine::applyAction(next, actions.actions[i]);
 
-        ev += prob * computeBestResponse(
-            brPlayer, next, p0_hand, p1_hand, board, map, mappingEngine);
+        ev += prob * bestResponseWalk(
+            brPlayer, next, p0_hand, p1_hand, board, map, betConfig, mappingEngine);
     }
 
     return ev;
 }
 
+// per deal: hands, board, showdown result and buckets are fixed -> evaluated once, shared by both BR players
+struct DealContext {
+    const std::array<int, 2>* hands[2];
+    const std::array<int, 5>* board;
+    int showdown;            // GameEngine::showdownWinner for this deal
+    int32_t buckets[2][4];   // [player][street], -1 = not looked up yet
+};
+
+template <typename StrategySource>
+static BestResponsePair fusedWalk(
+    const MCCFRState& state,
+    DealContext& deal,
+    const StrategySource& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine)
+{
+    // one payoff serves both players (zero sum)
+    if (state.isTerminal) {
+        float payoff0 = static_cast<float>(GameEngine::getPayoff(state, deal.showdown));
+        return {payoff0, -payoff0};
+    }
+
+    auto actions = BetAbstraction::getLegalActions(state, betConfig);
+    int player = state.currentPlayer;
+
+    // bucket of the acting player only changes with the street
+    int32_t bucket = 0;
+    if (state.street > 0) {
+        int32_t& cached = deal.buckets[player][state.street];
+        if (cached < 0) {
+            cached = Bucketer::lookup_bucket(
+                mappingEngine, deal.hands[player]->data(), deal.board->data(), state.street + 2);
+        }
+        bucket = cached;
+    }
+
+    MCCFR::InfosetKey key{state.historyHash, bucket};
+
+    // acting player's average strategy, needed by the other player's best response
+    float strategy[MCCFR::MAX_ACTIONS];
+    bool validStrategy = false;
+
+    if (lookupAverageStrategy(map, key, actions.count, strategy)) {
+        float sum = 0.0f;
+        for (int i = 0; i < actions.count; ++i) {
+            sum += strategy[i];
+        }
+        if (sum > 1e-6f) {
+            for (int i = 0; i < actions.count; ++i) {
+                strategy[i] /= sum;
+            }
+            validStrategy = true;
+        }
+    }
+
+    if (!validStrategy) {
+        float uniform = 1.0f / (float)actions.count;
+        for (int i = 0; i < actions.count; ++i) {
+            strategy[i] = uniform;
+        }
+    }
+
+    // acting player: max over its own BR values, other player: expectation under the acting player's strategy
+    float bestEV = -1e30f;
+    float expectedEV = 0.0f;
+
+    for (int i = 0; i < actions.count; ++i) {
+        MCCFRState next = state;
+        next.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][i];
+        next = GameEngine::applyAction(next, actions.actions[i]);
+
+        BestResponsePair child = fusedWalk(next, deal, map, betConfig, mappingEngine);
+        float actingEV = (player == 0) ? child.br_p0 : child.br_p1;
+        float otherEV = (player == 0) ? child.br_p1 : child.br_p0;
+
+        if (actingEV > bestEV) {
+            bestEV = actingEV;
+        }
+        if (strategy[i] >= 1e-8f) {
+            expectedEV += strategy[i] * otherEV;
+        }
+    }
+
+    if (player == 0) {
+        return {bestEV, expectedEV};
+    }
+    return {expectedEV, bestEV};
+}
+
+template <typename StrategySource>
+static BestResponsePair fusedBestResponses(
+    const MCCFRState& state,
+    const std::array<int, 2>& p0_hand,
+    const std::array<int, 2>& p1_hand,
+    const std::array<int, 5>& board,
+    const StrategySource& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine)
+{
+    DealContext deal;
+    deal.hands[0] = &p0_hand;
+    deal.hands[1] = &p1_hand;
+    deal.board = &board;
+    deal.showdown = GameEngine::showdownWinner(p0_hand, p1_hand, board);
+    for (int p = 0; p < 2; ++p) {
+        for (int street = 0; street < 4; ++street) {
+            deal.buckets[p][street] = -1;
+        }
+    }
+    return fusedWalk(state, deal, map, betConfig, mappingEngine);
+}
+
+float computeBestResponse(
+    int brPlayer,
+    const MCCFRState& state,
+    const std::array<int, 2>& p0_hand,
+    const std::array<int, 2>& p1_hand,
+    const std::array<int, 5>& board,
+    const InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine)
+{
+    return bestResponseWalk(brPlayer, state, p0_hand, p1_hand, board, map, betConfig, mappingEngine);
+}
+
+float computeBestResponse(
+    int brPlayer,
+    const MCCFRState& state,
+    const std::array<int, 2>& p0_hand,
+    const std::array<int, 2>& p1_hand,
+    const std::array<int, 5>& board,
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine)
+{
+    return bestResponseWalk(brPlayer, state, p0_hand, p1_hand, board, table, betConfig, mappingEngine);
+}
+
+BestResponsePair computeBestResponses(
+    const MCCFRState& state,
+    const std::array<int, 2>& p0_hand,
+    const std::array<int, 2>& p1_hand,
+    const std::array<int, 5>& board,
+    const InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine)
+{
+    return fusedBestResponses(state, p0_hand, p1_hand, board, map, betConfig, mappingEngine);
+}
+
+BestResponsePair computeBestResponses(
+    const MCCFRState& state,
+    const std::array<int, 2>& p0_hand,
+    const std::array<int, 2>& p1_hand,
+    const std::array<int, 5>& board,
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine)
+{
+    return fusedBestResponses(state, p0_hand, p1_hand, board, table, betConfig, mappingEngine);
+}
+
 }
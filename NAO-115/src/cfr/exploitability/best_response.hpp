@@ -6,6 +6,8 @@
 #include "../cfr-core/infoset.hpp"
 #include "../external/robin_hood.h"
 #include "hand-bucketing/mapping_engine.hpp"
+#include "bet-abstraction/bet_utils.hpp"
+#include "cfr/strategy-eval/frozen_strategy.hpp"
 
 namespace BestResponse {
 
@@ -25,6 +27,21 @@ Computes the best response EV for one player against the other's fixed average s
 
 using InfosetMap = robin_hood::unordered_flat_map<MCCFR::InfosetKey, MCCFR::Infoset, MCCFR::InfosetKeyHasher>;
 
+// strategy sources: the training map (normalized on every lookup) or the frozen table (pre-normalized)
+// -> false if the infoset is unknown or has a different action count, callers fall back to uniform
+inline bool lookupAverageStrategy(const InfosetMap& map, const MCCFR::InfosetKey& key, int actionCount, float* strategy) {
+    InfosetMap::const_iterator it = map.find(key);
+    if (it == map.end() || it->second.numActions != actionCount) {
+        return false;
+    }
+    it->second.getAverageStrategy(strategy);
+    return true;
+}
+
+inline bool lookupAverageStrategy(const FrozenStrategy::Table& table, const MCCFR::InfosetKey& key, int actionCount, float* strategy) {
+    return table.getStrategy(key, actionCount, strategy);
+}
+
 // Compute best response EV for brPlayer against the fixed average strategy stored in the infoset map
 // -> returns EV in chips from brPlayer's perspective.
 float computeBestResponse(
@@ -34,7 +51,52 @@ float computeBestResponse(
                           const std::array<int, 2>& p1_hand, // P1 hole cards
                           const std::array<int, 5>& board, // all dealt board cards
                           const InfosetMap& map, // infoset map from completed MCCFR training
+                          const BetAbstraction::BetConfig& betConfig, // bet abstraction the map was trained with
                           Bucketer::IsomorphismEngine& mappingEngine // for bucket lookups
 );
 
+// same walk, opponent strategy read from a frozen (pre-normalized) table
+float computeBestResponse(
+                          int brPlayer,
+                          const MCCFRState& state,
+                          const std::array<int, 2>& p0_hand,
+                          const std::array<int, 2>& p1_hand,
+                          const std::array<int, 5>& board,
+                          const FrozenStrategy::Table& table,
+                          const BetAbstraction::BetConfig& betConfig,
+                          Bucketer::IsomorphismEngine& mappingEngine
+);
+
+/*
+Both best responses of one deal in a single walk.
+ - every node is visited once: the acting player maxes over its own values,
+   the other player's value is the expectation under the acting player's average strategy
+ - buckets are looked up once per player and street, the showdown is evaluated once per deal
+ - same results as two computeBestResponse calls
+ */
+struct BestResponsePair {
+    float br_p0; // P0's BR EV vs P1's average strategy, chips
+    float br_p1; // P1's BR EV vs P0's average strategy, chips
+};
+
+BestResponsePair computeBestResponses(
+                          const MCCFRState& state,
+                          const std::array<int, 2>& p0_hand,
+                          const std::array<int, 2>& p1_hand,
+                          const std::array<int, 5>& board,
+                          const InfosetMap& map,
+                          const BetAbstraction::BetConfig& betConfig,
+                          Bucketer::IsomorphismEngine& mappingEngine
+);
+
+BestResponsePair computeBestResponses(
+                          const MCCFRState& state,
+                          const std::array<int, 2>& p0_hand,
+                          const std::array<int, 2>& p1_hand,
+                          const std::array<int, 5>& board,
+                          const FrozenStrategy::Table& table,
+                          const BetAbstraction::BetConfig& betConfig,
+                          Bucketer::IsomorphismEngine& mappingEngine
+);
+
 }
@@ -1,70 +1,267 @@
 #include "exploitability.hpp"
-#include <random>
+#include <algorithm>
+#include <vector>
 #include <array>
 #include <cstdint>
 #include <omp.h>
+#include <cstdio>
 
 namespace Exploitability {
 
-ExploitabilityResult compute(
-    const BestResponse::InfosetMap& map,
+// running estimates of both best responses and their sum
+struct Estimates {
+    DealSampler::StratifiedAccumulator br_p0;
+    DealSampler::StratifiedAccumulator br_p1;
+    DealSampler::StratifiedAccumulator total;
+
+    explicit Estimates(const DealSampler::Sampler& sampler)
+    : br_p0(sampler.weights()), br_p1(sampler.weights()), total(sampler.weights()) {}
+};
+
+/*
+Run the deals [firstSample, lastSample) and add them to the estimates.
+ - per-sample values in double, accumulated in sample order afterwards -> same result for any thread count
+ - antithetic deals are averaged per unit before they are accumulated (batches must hold whole units)
+ */
+template <typename StrategySource>
+static void addSamples(
+    const StrategySource& map,
+    const BetAbstraction::BetConfig& betConfig,
     Bucketer::IsomorphismEngine& mappingEngine,
     const MCCFRState& rootState,
-    int bigBlind,
-    int numSamples,
-    uint64_t seed)
+    const DealSampler::Sampler& sampler,
+    int firstSample,
+    int lastSample,
+    Estimates& estimates)
 {
-    float sum_br_p0 = 0.0f;
-    float sum_br_p1 = 0.0f;
-    
-#pragma omp parallel reduction(+:sum_br_p0, sum_br_p1)
-    {
-        
-        std::mt19937 rng(seed + 1337 * omp_get_thread_num());
-        
-        // build deck, where cards represented as integers [0 - 51], Nao's standard
-        int deck[52];
-        
-#pragma omp for schedule(dynamic)
-        // Monte Carlo expectation over chance nodes
-        for (int s = 0; s < numSamples; ++s) {
-            // partially shuffle deck (Fisher–Yates), sample 9 unique cards
-            for (int i = 0; i < 52; ++i) {
-                deck[i] = i;
-            }
-                
-            for (int i = 0; i < 9; ++i) {
-                std::uniform_int_distribution<int> dist(i, 51);
-                int j = dist(rng);
-                std::swap(deck[i], deck[j]);
-            }
-            
-            std::array<int, 2> p0_hand = {deck[0], deck[1]};
-            std::array<int, 2> p1_hand = {deck[2], deck[3]};
-            std::array<int, 5> board   = {deck[4], deck[5], deck[6], deck[7], deck[8]};
-            
-            // BR for P0 against P1's average strategy
-            sum_br_p0 += BestResponse::computeBestResponse(0, rootState, p0_hand, p1_hand, board, map, mappingEngine);
-            
-            // BR for P1 against P0's average strategy
-            sum_br_p1 += BestResponse::computeBestResponse(1, rootState, p0_hand, p1_hand, board, map, mappingEngine);
-        }
+    int count = lastSample - firstSample;
+    std::vector<double> br_p0(count, 0.0);
+    std::vector<double> br_p1(count, 0.0);
+    std::vector<int> strata(count, 0);
+
+#pragma omp parallel for schedule(dynamic)
+    // Monte Carlo expectation over chance nodes
+    for (int i = 0; i < count; ++i) {
+        DealSampler::Deal deal = sampler.deal(static_cast<uint64_t>(firstSample + i));
+
+        // BR for P0 against P1's average strategy and P1 against P0's, one fused walk
+        BestResponse::BestResponsePair br = BestResponse::computeBestResponses(rootState, deal.p0hand, deal.p1hand, deal.board, map, betConfig, mappingEngine);
+        br_p0[i] = br.br_p0;
+        br_p1[i] = br.br_p1;
+        strata[i] = deal.stratum;
     }
 
-    float avg_br_p0 = sum_br_p0 / static_cast<float>(numSamples);
-    float avg_br_p1 = sum_br_p1 / static_cast<float>(numSamples);
+    int unit = sampler.dealsPerUnit();
+    for (int first = 0; first < count; first += unit) {
+        int last = std::min(count, first + unit);
+        double sum_p0 = 0.0;
+        double sum_p1 = 0.0;
+        for (int i = first; i < last; ++i) {
+            sum_p0 += br_p0[i];
+            sum_p1 += br_p1[i];
+        }
+        double size = static_cast<double>(last - first);
+        estimates.br_p0.add(strata[first], sum_p0 / size);
+        estimates.br_p1.add(strata[first], sum_p1 / size);
+        estimates.total.add(strata[first], (sum_p0 + sum_p1) / size);
+    }
+}
 
+static ExploitabilityResult toResult(const Estimates& estimates, int bigBlind, int samplesUsed) {
     // convert chips to mbb/hand
     // 1 BB = bigBlind chips, 1 mbb = bigBlind/1000 chips
-    float chips_to_mbb = 1000.0f / static_cast<float>(bigBlind);
+    double chips_to_mbb = 1000.0 / static_cast<double>(bigBlind);
 
     ExploitabilityResult result;
-    result.br_p0_mbb     = avg_br_p0 * chips_to_mbb;
-    result.br_p1_mbb     = avg_br_p1 * chips_to_mbb;
-    result.mbb_per_hand  = result.br_p0_mbb + result.br_p1_mbb;
-    result.samples_used  = numSamples;
+    result.br_p0_mbb     = static_cast<float>(estimates.br_p0.mean() * chips_to_mbb);
+    result.br_p1_mbb     = static_cast<float>(estimates.br_p1.mean() * chips_to_mbb);
+    result.mbb_per_hand  = static_cast<float>(estimates.total.mean() * chips_to_mbb);
+    result.std_error_mbb = static_cast<float>(estimates.total.standardError() * chips_to_mbb);
+    result.confidence_95_mbb = 1.96f * result.std_error_mbb;
+    result.samples_used  = samplesUsed;
+    result.converged     = true;
 
     return result;
 }
 
+template <typename StrategySource>
+static ExploitabilityResult computeWith(
+    const StrategySource& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    int numSamples,
+    uint64_t seed,
+    DealSampler::Mode sampling)
+{
+    DealSampler::Sampler sampler(mappingEngine, seed, sampling);
+    Estimates estimates(sampler);
+    addSamples(map, betConfig, mappingEngine, rootState, sampler, 0, numSamples, estimates);
+    return toResult(estimates, bigBlind, numSamples);
+}
+
+template <typename StrategySource>
+static ExploitabilityResult computeAdaptiveWith(
+    const StrategySource& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const AdaptiveOptions& options,
+    uint64_t seed,
+    DealSampler::Mode sampling)
+{
+    DealSampler::Sampler sampler(mappingEngine, seed, sampling);
+    Estimates estimates(sampler);
+
+    // whole antithetic units per batch
+    int unit = sampler.dealsPerUnit();
+    int batch = std::max(unit, options.batchSamples / unit * unit);
+    int maxSamples = std::max(0, options.maxSamples);
+    double chips_to_mbb = 1000.0 / static_cast<double>(bigBlind);
+
+    int used = 0;
+    bool converged = false;
+    while (used < maxSamples) {
+        int last = std::min(maxSamples, used + batch);
+        addSamples(map, betConfig, mappingEngine, rootState, sampler, used, last, estimates);
+        used = last;
+
+        double halfWidth = 1.96 * estimates.total.standardError() * chips_to_mbb;
+        if (options.verbose) {
+            fprintf(stderr, "[exploitability] %d samples: %.2f mbb/hand +- %.2f (tolerance %.2f)\n",
+                    used, estimates.total.mean() * chips_to_mbb, halfWidth, options.tolerance_mbb);
+        }
+
+        if (used >= options.minSamples && halfWidth <= options.tolerance_mbb) {
+            converged = true;
+            break;
+        }
+    }
+
+    ExploitabilityResult result = toResult(estimates, bigBlind, used);
+    result.converged = converged;
+    return result;
+}
+
+ExploitabilityResult compute(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    int numSamples,
+    uint64_t seed,
+    DealSampler::Mode sampling)
+{
+    return computeWith(map, betConfig, mappingEngine, rootState, bigBlind, numSamples, seed, sampling);
+}
+
+ExploitabilityResult compute(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    int numSamples,
+    uint64_t seed,
+    DealSampler::Mode sampling)
+{
+    return computeWith(table, betConfig, mappingEngine, rootState, bigBlind, numSamples, seed, sampling);
+}
+
+ExploitabilityResult computeAdaptive(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const AdaptiveOptions& options,
+    uint64_t seed,
+    DealSampler::Mode sampling)
+{
+    return computeAdaptiveWith(map, betConfig, mappingEngine, rootState, bigBlind, options, seed, sampling);
+}
+
+ExploitabilityResult computeAdaptive(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const AdaptiveOptions& options,
+    uint64_t seed,
+    DealSampler::Mode sampling)
+{
+    return computeAdaptiveWith(table, betConfig, mappingEngine, rootState, bigBlind, options, seed, sampling);
+}
+
+static ExploitabilityResult rangeResult(const RangeBestResponse::Values& values, int bigBlind, bool sampled) {
+    double chips_to_mbb = 1000.0 / static_cast<double>(bigBlind);
+
+    ExploitabilityResult result;
+    result.br_p0_mbb     = static_cast<float>(values.br_p0 * chips_to_mbb);
+    result.br_p1_mbb     = static_cast<float>(values.br_p1 * chips_to_mbb);
+    result.mbb_per_hand  = static_cast<float>((values.br_p0 + values.br_p1) * chips_to_mbb);
+    result.std_error_mbb = 0.0f; // exact, or unknown when sampled (converged = false)
+    result.confidence_95_mbb = 0.0f;
+    result.samples_used  = values.flops_evaluated;
+    result.converged     = !sampled;
+    return result;
+}
+
+ExploitabilityResult computeRange(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const RangeBestResponse::Options& options)
+{
+    return rangeResult(RangeBestResponse::compute(map, betConfig, mappingEngine, rootState, options), bigBlind,
+                       options.sampled());
+}
+
+ExploitabilityResult computeRange(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const RangeBestResponse::Options& options)
+{
+    return rangeResult(RangeBestResponse::compute(table, betConfig, mappingEngine, rootState, options), bigBlind,
+                       options.sampled());
+}
+
+// full enumeration: all flops, turns and rivers
+static RangeBestResponse::Options exactOptions(int numThreads) {
+    RangeBestResponse::Options options;
+    options.numThreads = numThreads;
+    return options;
+}
+
+ExploitabilityResult computeExact(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    int numThreads)
+{
+    return computeRange(map, betConfig, mappingEngine, rootState, bigBlind, exactOptions(numThreads));
+}
+
+ExploitabilityResult computeExact(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    int numThreads)
+{
+    return computeRange(table, betConfig, mappingEngine, rootState, bigBlind, exactOptions(numThreads));
+}
+
 }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "best_response.hpp"
+#include "range_best_response.hpp"
+#include "cfr/utils/deal_sampler.hpp"
 
 namespace Exploitability {
 
@@ -8,26 +10,127 @@ namespace Exploitability {
 Computes exploitability of a strategy profile stored in an infoset map.
  exploitability = BR(P0 vs avg_P1) + BR(P1 vs avg_P0)
  - uses Monte Carlo sampling over card deals.
- - each sample draws random p0_hand, p1_hand, board and runs best response for both players, results are averaged
+ - each sample draws p0_hand, p1_hand, board (DealSampler, optionally stratified over canonical flops)
+   and runs best response for both players, results are averaged (stratified mean when stratified)
  - returns exploitability in mbb/hand.
  - (chips / (bigBlind / 1000.0f) = chips * 10.0f for bigBlind=100)
+ - NOTE: the sampled BR player sees the opponent's cards, so compute() over-estimates exploitability,
+   computeExact() runs the public-tree range best response instead (range_best_response.hpp)
  */
 
 struct ExploitabilityResult {
     float mbb_per_hand;      // total exploitability in mbb/hand
     float br_p0_mbb;         // P0's best response gain in mbb/hand
     float br_p1_mbb;         // P1's best response gain in mbb/hand
-    int   samples_used;      // number of Monte Carlo samples
+    float std_error_mbb;     // standard error of mbb_per_hand (Monte Carlo over deals)
+    float confidence_95_mbb; // 95% confidence interval half-width (mbb_per_hand ± this)
+    int   samples_used;      // number of Monte Carlo samples actually run (computeExact: canonical flops evaluated)
+    bool  converged;         // computeAdaptive: tolerance reached before maxSamples, computeRange: false when sampled
+                             // (always true otherwise)
+};
+
+/*
+Settings of the adaptive estimate.
+ - deals are run in batches, after each batch the 95% half-width (1.96 * standard error) is checked
+ - stops once it is <= tolerance_mbb (and at least minSamples were run), or at maxSamples
+ - deals are the same as compute() with the same seed, so the result is a prefix of the fixed-size run
+ */
+struct AdaptiveOptions {
+    float tolerance_mbb = 5.0f; // requested 95% half-width in mbb/hand
+    int   maxSamples = 200000;  // hard cap on deals
+    int   minSamples = 4000;    // never stop before this many deals (variance estimate must settle)
+    int   batchSamples = 2000;  // deals between two checks
+    bool  verbose = false;      // one stderr line per batch (deals, estimate, half-width)
 };
 
 // Compute exploitability via Monte Carlo sampling
 ExploitabilityResult compute(
     const BestResponse::InfosetMap& map, // infoset map from completed MCCFR training
+    const BetAbstraction::BetConfig& betConfig, // bet abstraction the map was trained with
     Bucketer::IsomorphismEngine& mappingEngine, // for bucket lookups
     const MCCFRState& rootState, // starting game state (research version: street=1, pot=2000, stacks=9000)
     int bigBlind, // big blind size in chips (100)
     int numSamples, // number of random card deals to average over (10000)
-    uint64_t seed
+    uint64_t seed,
+    DealSampler::Mode sampling = DealSampler::Mode::Stratified // deal sampling scheme
+);
+
+// same estimate, strategy read from a frozen table
+ExploitabilityResult compute(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    int numSamples,
+    uint64_t seed,
+    DealSampler::Mode sampling = DealSampler::Mode::Stratified
+);
+
+// Run deals until the 95% confidence half-width drops below options.tolerance_mbb (see AdaptiveOptions)
+ExploitabilityResult computeAdaptive(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const AdaptiveOptions& options,
+    uint64_t seed,
+    DealSampler::Mode sampling = DealSampler::Mode::Stratified
+);
+
+ExploitabilityResult computeAdaptive(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const AdaptiveOptions& options,
+    uint64_t seed,
+    DealSampler::Mode sampling = DealSampler::Mode::Stratified
+);
+
+// Exploitability of the abstract game from the range best response (BR sees only its own cards)
+// every flop, turn and river card is enumerated -> exact, std_error 0, converged true
+ExploitabilityResult computeExact(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState, // start of the flop
+    int bigBlind,
+    int numThreads = 0 // 0 = OpenMP default
+);
+
+ExploitabilityResult computeExact(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    int numThreads = 0
+);
+
+/*
+Same range best response with the card enumeration set by options (e.g. RangeBestResponse::sampledOptions()).
+ - a sampled run is an estimate, biased upwards (max over sample averages), its error is not estimated:
+   converged is false and std_error / confidence_95 are 0 (unknown) unless options enumerate everything
+ */
+ExploitabilityResult computeRange(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const RangeBestResponse::Options& options
+);
+
+ExploitabilityResult computeRange(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const RangeBestResponse::Options& options
 );
 
 } // namespace Exploitability
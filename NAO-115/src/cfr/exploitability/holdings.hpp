@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/*
+The 1326 two-card holdings, shared by the range based evaluators (range best response, local best response).
+ - holding h <-> (c1 < c2), enumerated in lexicographic order
+ - byCard: the 51 holdings that contain each card (card removal when a board card is dealt)
+ */
+namespace Holdings {
+
+static constexpr int NUM_HOLDINGS = 1326;
+
+struct Table {
+    std::array<std::array<int, 2>, NUM_HOLDINGS> cards;
+    std::array<std::array<uint16_t, 51>, 52> byCard;
+    std::array<std::array<int16_t, 52>, 52> index; // -1 on the diagonal
+
+    Table() {
+        std::array<int, 52> filled{};
+        for (auto& row : index) {
+            row.fill(-1);
+        }
+        int h = 0;
+        for (int a = 0; a < 52; ++a) {
+            for (int b = a + 1; b < 52; ++b) {
+                cards[h] = {a, b};
+                byCard[a][filled[a]++] = static_cast<uint16_t>(h);
+                byCard[b][filled[b]++] = static_cast<uint16_t>(h);
+                index[a][b] = static_cast<int16_t>(h);
+                index[b][a] = static_cast<int16_t>(h);
+                h++;
+            }
+        }
+    }
+};
+
+inline const Table& table() {
+    static const Table holdings;
+    return holdings;
+}
+
+// true if the holding shares a card with the mask (bit c = card c)
+inline bool blocked(int holding, uint64_t mask) {
+    const auto& c = table().cards[holding];
+    return ((mask >> c[0]) & 1ULL) || ((mask >> c[1]) & 1ULL);
+}
+
+}
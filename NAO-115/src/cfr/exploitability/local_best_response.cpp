@@ -0,0 +1,443 @@
+#include "local_best_response.hpp"
+#include "../cfr-core/game_engine.hpp"
+#include "../include/bucket-lookups/lut_indexer.hpp"
+#include "../utils/zobrist.hpp"
+#include "../utils/counter_rng.hpp"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <vector>
+#include <omp.h>
+
+namespace LocalBestResponse {
+
+namespace {
+
+using Holdings::NUM_HOLDINGS;
+
+inline int contribution(const MCCFRState& state, int player) {
+    return (player == 0) ? state.player0Contribution : state.player1Contribution;
+}
+
+inline uint64_t cardMask(int c1, int c2) {
+    return (1ULL << c1) | (1ULL << c2);
+}
+
+// plays single hands as LBR against the fixed strategy, one instance per thread (owns the range buffers)
+template <typename StrategySource>
+class HandPlayer {
+public:
+    HandPlayer(const StrategySource& strategy,
+               const BetAbstraction::BetConfig& betConfig,
+               Bucketer::IsomorphismEngine& mappingEngine,
+               const Options& options)
+    : strategy(strategy), betConfig(betConfig), mappingEngine(mappingEngine), options(options),
+      range(NUM_HOLDINGS), callWeights(NUM_HOLDINGS), equity(NUM_HOLDINGS),
+      equitySum(NUM_HOLDINGS), equityCount(NUM_HOLDINGS), slot(NUM_HOLDINGS) {}
+
+    // LBR's payoff in chips for one hand
+    double play(int player, const MCCFRState& root, const DealSampler::Deal& deal, CounterRNG::Stream& rng) {
+        lbrPlayer = player;
+        lbrHand = (player == 0) ? deal.p0hand : deal.p1hand;
+        const std::array<int, 2>& oppHand = (player == 0) ? deal.p1hand : deal.p0hand;
+        oppHolding = Holdings::table().index[oppHand[0]][oppHand[1]];
+        board = deal.board;
+        numBoard = 0;
+        boardMask = 0;
+        bucketBoard = -1;
+
+        // LBR only knows its own cards
+        uint64_t lbrMask = cardMask(lbrHand[0], lbrHand[1]);
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            range[h] = Holdings::blocked(h, lbrMask) ? 0.0 : 1.0;
+        }
+
+        MCCFRState state = root;
+        while (!state.isTerminal) {
+            if (numBoard != state.street + 2) {
+                revealBoard(state.street + 2);
+            }
+
+            auto actions = BetAbstraction::getLegalActions(state, betConfig);
+            int chosen = 0;
+
+            if (state.currentPlayer == lbrPlayer) {
+                chosen = chooseAction(state, actions, rng);
+            } else {
+                // opponent plays its real cards, LBR updates its belief with the same strategy
+                nodeStrategies(state, actions.count);
+                const float* own = &strategies[slot[oppHolding] * MCCFR::MAX_ACTIONS];
+                chosen = sampleAction(own, actions.count, rng.uniform01());
+
+                double mass = 0.0;
+                for (int h = 0; h < NUM_HOLDINGS; ++h) {
+                    if (range[h] > 0.0) {
+                        range[h] *= strategies[slot[h] * MCCFR::MAX_ACTIONS + chosen];
+                        mass += range[h];
+                    }
+                }
+                normalize(mass);
+            }
+
+            MCCFRState next = state;
+            next.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][chosen];
+            state = GameEngine::applyAction(next, actions.actions[chosen]);
+        }
+
+        int payoff0 = GameEngine::getPayoff(state, deal.p0hand, deal.p1hand, deal.board);
+        return (lbrPlayer == 0) ? payoff0 : -payoff0;
+    }
+
+private:
+    const StrategySource& strategy;
+    const BetAbstraction::BetConfig& betConfig;
+    Bucketer::IsomorphismEngine& mappingEngine;
+    const Options& options;
+
+    int lbrPlayer = 0;
+    std::array<int, 2> lbrHand{};
+    int oppHolding = 0;
+    std::array<int, 5> board{};
+    int numBoard = 0;
+    uint64_t boardMask = 0;
+
+    std::vector<double> range;        // opponent holdings, normalized
+    std::vector<double> callWeights;
+    std::vector<double> equity;       // LBR vs each live holding
+    std::vector<double> equitySum;
+    std::vector<int> equityCount;
+
+    // buckets of the live opponent holdings on the current board
+    int bucketBoard = -1;
+    std::vector<uint16_t> slot;
+    std::vector<int32_t> bucketIds;
+    std::vector<float> strategies;    // per distinct bucket, MAX_ACTIONS each
+
+    void normalize(double mass) {
+        if (mass <= 0.0) {
+            return;
+        }
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            range[h] /= mass;
+        }
+    }
+
+    void revealBoard(int count) {
+        numBoard = count;
+        boardMask = 0;
+        for (int k = 0; k < count; ++k) {
+            boardMask |= 1ULL << board[k];
+        }
+
+        double mass = 0.0;
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            if (range[h] > 0.0 && Holdings::blocked(h, boardMask)) {
+                range[h] = 0.0;
+            }
+            mass += range[h];
+        }
+        normalize(mass);
+    }
+
+    // the range only shrinks within a street -> buckets of the holdings still alive when first needed
+    void ensureBuckets() {
+        if (bucketBoard == numBoard) {
+            return;
+        }
+
+        const auto& cards = Holdings::table().cards;
+        robin_hood::unordered_flat_map<int32_t, uint16_t> slots;
+        bucketIds.clear();
+        std::fill(slot.begin(), slot.end(), 0);
+
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            if (range[h] <= 0.0 && h != oppHolding) {
+                continue;
+            }
+            int32_t bucket = Bucketer::lookup_bucket(mappingEngine, cards[h].data(), board.data(), numBoard);
+            auto it = slots.find(bucket);
+            if (it == slots.end()) {
+                it = slots.emplace(bucket, static_cast<uint16_t>(bucketIds.size())).first;
+                bucketIds.push_back(bucket);
+            }
+            slot[h] = it->second;
+        }
+        bucketBoard = numBoard;
+    }
+
+    // opponent's normalized strategy for every live bucket at this node (uniform if unknown)
+    void nodeStrategies(const MCCFRState& state, int actionCount) {
+        ensureBuckets();
+        strategies.assign(bucketIds.size() * MCCFR::MAX_ACTIONS, 0.0f);
+
+        for (size_t b = 0; b < bucketIds.size(); ++b) {
+            float* out = &strategies[b * MCCFR::MAX_ACTIONS];
+            MCCFR::InfosetKey key{state.historyHash, bucketIds[b]};
+
+            float sum = 0.0f;
+            if (BestResponse::lookupAverageStrategy(strategy, key, actionCount, out)) {
+                for (int i = 0; i < actionCount; ++i) {
+                    sum += out[i];
+                }
+            }
+            for (int i = 0; i < actionCount; ++i) {
+                out[i] = (sum > 1e-6f) ? out[i] / sum : 1.0f / static_cast<float>(actionCount);
+            }
+        }
+    }
+
+    static int sampleAction(const float* probabilities, int actionCount, float random01) {
+        float cumulative = 0.0f;
+        for (int i = 0; i < actionCount - 1; ++i) {
+            cumulative += probabilities[i];
+            if (random01 < cumulative) {
+                return i;
+            }
+        }
+        return actionCount - 1;
+    }
+
+    // one complete board: 1 win, 0.5 tie, 0 loss vs every live holding not blocked by the runout
+    void addRunout(const std::array<int, 5>& fullBoard, uint64_t runoutMask) {
+        const auto& cards = Holdings::table().cards;
+        int own = GameEngine::showdownScore(lbrHand, fullBoard);
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            if (range[h] <= 0.0 || Holdings::blocked(h, runoutMask)) {
+                continue;
+            }
+            int score = GameEngine::showdownScore(cards[h], fullBoard);
+            equitySum[h] += (own < score) ? 1.0 : (own == score ? 0.5 : 0.0);
+            equityCount[h]++;
+        }
+    }
+
+    void computeEquity(CounterRNG::Stream& rng) {
+        std::fill(equitySum.begin(), equitySum.end(), 0.0);
+        std::fill(equityCount.begin(), equityCount.end(), 0);
+
+        uint64_t known = boardMask | cardMask(lbrHand[0], lbrHand[1]);
+        std::vector<int> deck;
+        for (int c = 0; c < 52; ++c) {
+            if (!((known >> c) & 1ULL)) {
+                deck.push_back(c);
+            }
+        }
+
+        std::array<int, 5> fullBoard = board;
+        if (numBoard == 5) {
+            addRunout(fullBoard, 0);
+        } else if (numBoard == 4) {
+            for (int river : deck) {
+                fullBoard[4] = river;
+                addRunout(fullBoard, 1ULL << river);
+            }
+        } else if (options.rolloutBoards <= 0) {
+            for (size_t i = 0; i < deck.size(); ++i) {
+                for (size_t j = i + 1; j < deck.size(); ++j) {
+                    fullBoard[3] = deck[i];
+                    fullBoard[4] = deck[j];
+                    addRunout(fullBoard, cardMask(deck[i], deck[j]));
+                }
+            }
+        } else {
+            int n = static_cast<int>(deck.size());
+            for (int r = 0; r < options.rolloutBoards; ++r) {
+                int first = rng.uniformInt(0, n - 1);
+                int second = rng.uniformInt(0, n - 2);
+                if (second >= first) {
+                    second++;
+                }
+                fullBoard[3] = deck[first];
+                fullBoard[4] = deck[second];
+                addRunout(fullBoard, cardMask(deck[first], deck[second]));
+            }
+        }
+
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            equity[h] = equityCount[h] > 0 ? equitySum[h] / equityCount[h] : 0.5;
+        }
+    }
+
+    double rangeEquity(const std::vector<double>& weights) const {
+        double total = 0.0;
+        double won = 0.0;
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            if (weights[h] > 0.0) {
+                total += weights[h];
+                won += weights[h] * equity[h];
+            }
+        }
+        return total > 0.0 ? won / total : 0.5;
+    }
+
+    // greedy one-step lookahead, the rest of the hand is assumed to be checked down
+    int chooseAction(const MCCFRState& state, const BetAbstraction::ActionList& actions, CounterRNG::Stream& rng) {
+        computeEquity(rng);
+        double winProbability = rangeEquity(range);
+        int own = contribution(state, lbrPlayer);
+
+        int bestIndex = 0;
+        double bestEV = -1e30;
+
+        for (int i = 0; i < actions.count; ++i) {
+            const auto& action = actions.actions[i];
+            double ev;
+
+            if (action.type == BetAbstraction::FOLD) {
+                ev = -own;
+            } else {
+                MCCFRState next = state;
+                next.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][i];
+                next = GameEngine::applyAction(next, action);
+
+                int ownNext = contribution(next, lbrPlayer);
+                int potNext = next.player0Contribution + next.player1Contribution;
+                ev = winProbability * potNext - ownNext;
+
+                // bet / raise: the opponent folds part of its range, the rest calls
+                if (action.type == BetAbstraction::RAISE && !next.isTerminal && next.currentPlayer != lbrPlayer) {
+                    ev = raiseValue(next, ownNext, potNext, ev);
+                }
+            }
+
+            if (ev > bestEV) {
+                bestEV = ev;
+                bestIndex = i;
+            }
+        }
+        return bestIndex;
+    }
+
+    double raiseValue(const MCCFRState& next, int ownNext, int potNext, double checkedDownEV) {
+        auto replies = BetAbstraction::getLegalActions(next, betConfig);
+        int foldIndex = -1;
+        for (int i = 0; i < replies.count; ++i) {
+            if (replies.actions[i].type == BetAbstraction::FOLD) {
+                foldIndex = i;
+                break;
+            }
+        }
+        if (foldIndex < 0) {
+            return checkedDownEV;
+        }
+
+        nodeStrategies(next, replies.count);
+        double total = 0.0;
+        double folded = 0.0;
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            callWeights[h] = 0.0;
+            if (range[h] <= 0.0) {
+                continue;
+            }
+            double fold = strategies[slot[h] * MCCFR::MAX_ACTIONS + foldIndex];
+            total += range[h];
+            folded += range[h] * fold;
+            callWeights[h] = range[h] * (1.0 - fold);
+        }
+        if (total <= 0.0) {
+            return checkedDownEV;
+        }
+        double foldProbability = folded / total;
+
+        // next is from the opponent's perspective: hero = opponent, it can only call up to its stack
+        int toCall = next.villainStreetBet - next.heroStreetBet;
+        int oppCalled = contribution(next, 1 - lbrPlayer) + std::min(toCall, next.heroStack);
+        int potCalled = ownNext + oppCalled;
+
+        return foldProbability * (potNext - ownNext)
+             + (1.0 - foldProbability) * (rangeEquity(callWeights) * potCalled - ownNext);
+    }
+};
+
+template <typename StrategySource>
+Result computeWith(
+    const StrategySource& strategy,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const Options& options)
+{
+    if (rootState.street < 1) {
+        throw std::runtime_error("LocalBestResponse: root state must be postflop");
+    }
+
+    DealSampler::Sampler sampler(mappingEngine, options.seed, options.sampling);
+    int numDeals = std::max(0, options.numDeals);
+    std::vector<double> lbr_p0(numDeals, 0.0);
+    std::vector<double> lbr_p1(numDeals, 0.0);
+    std::vector<int> strata(numDeals, 0);
+    int numThreads = options.numThreads > 0 ? options.numThreads : omp_get_max_threads();
+
+#pragma omp parallel num_threads(numThreads)
+    {
+        HandPlayer<StrategySource> player(strategy, betConfig, mappingEngine, options);
+
+#pragma omp for schedule(dynamic, 16)
+        for (int i = 0; i < numDeals; ++i) {
+            DealSampler::Deal deal = sampler.deal(static_cast<uint64_t>(i));
+
+            // own action / rollout stream per deal and seat -> independent of the thread
+            CounterRNG::Stream seat0(options.seed, 2 * static_cast<uint64_t>(i));
+            CounterRNG::Stream seat1(options.seed, 2 * static_cast<uint64_t>(i) + 1);
+            lbr_p0[i] = player.play(0, rootState, deal, seat0);
+            lbr_p1[i] = player.play(1, rootState, deal, seat1);
+            strata[i] = deal.stratum;
+        }
+    }
+
+    // sample order accumulation, antithetic deals averaged per unit
+    DealSampler::StratifiedAccumulator acc_p0(sampler.weights());
+    DealSampler::StratifiedAccumulator acc_p1(sampler.weights());
+    DealSampler::StratifiedAccumulator acc_total(sampler.weights());
+    int unit = sampler.dealsPerUnit();
+    for (int first = 0; first < numDeals; first += unit) {
+        int last = std::min(numDeals, first + unit);
+        double sum_p0 = 0.0;
+        double sum_p1 = 0.0;
+        for (int i = first; i < last; ++i) {
+            sum_p0 += lbr_p0[i];
+            sum_p1 += lbr_p1[i];
+        }
+        double size = static_cast<double>(last - first);
+        acc_p0.add(strata[first], sum_p0 / size);
+        acc_p1.add(strata[first], sum_p1 / size);
+        acc_total.add(strata[first], (sum_p0 + sum_p1) / size);
+    }
+
+    double chips_to_mbb = 1000.0 / static_cast<double>(bigBlind);
+
+    Result result;
+    result.lbr_p0_mbb = static_cast<float>(acc_p0.mean() * chips_to_mbb);
+    result.lbr_p1_mbb = static_cast<float>(acc_p1.mean() * chips_to_mbb);
+    result.mbb_per_hand = static_cast<float>(acc_total.mean() * chips_to_mbb);
+    result.std_error_mbb = static_cast<float>(acc_total.standardError() * chips_to_mbb);
+    result.deals = numDeals;
+    return result;
+}
+
+}
+
+Result compute(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const Options& options)
+{
+    return computeWith(map, betConfig, mappingEngine, rootState, bigBlind, options);
+}
+
+Result compute(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const Options& options)
+{
+    return computeWith(table, betConfig, mappingEngine, rootState, bigBlind, options);
+}
+
+}
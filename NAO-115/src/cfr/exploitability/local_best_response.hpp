@@ -0,0 +1,66 @@
+#pragma once
+
+#include "best_response.hpp"
+#include "holdings.hpp"
+#include "cfr/utils/deal_sampler.hpp"
+#include <cstdint>
+
+namespace LocalBestResponse {
+
+/*
+Local Best Response (LBR): a cheap lower bound on exploitability.
+ -> source: Lisý & Bowling (2017), "Equilibrium Approximation Quality of Current No-Limit Poker Bots", AAAI workshops
+ -> source: https://arxiv.org/abs/1612.07547
+
+ Hands are played against the fixed average strategy, LBR sees only its own cards:
+ - opponent range: 1326 holdings, Bayes-updated with the opponent's strategy (through each holding's bucket) after every action it takes
+ - LBR decision, one-step lookahead with the rest of the hand assumed checked down:
+      fold       -> -own contribution
+      check/call -> equity vs range * pot - own contribution
+      bet/raise  -> P(fold) * (pot - own) + (1 - P(fold)) * (equity vs calling range * pot after call - own)
+   P(fold) comes from the opponent's strategy at the node after the bet, per holding, weighted by the range
+ - equity: showdown scores (GameEngine::showdownScore) on the river, all river cards on the turn,
+   rolloutBoards sampled turn + river pairs on the flop
+ - opponent actions are sampled from its strategy with its real cards
+
+ Every deal is played with LBR in both seats, LBR(P0) + LBR(P1) is a lower bound on exploitability
+ (any fixed exploit is, up to sampling noise). Deals come from DealSampler, run in parallel over OpenMP.
+ */
+
+struct Options {
+    int numDeals = 10000;     // deals, LBR plays both seats on each
+    int rolloutBoards = 32;   // sampled runouts for flop equity (turn / river are exact)
+    uint64_t seed = 1;        // deal i uses DealSampler(seed) and action stream (seed, i)
+    int numThreads = 0;       // 0 = OpenMP default
+    DealSampler::Mode sampling = DealSampler::Mode::Stratified;
+};
+
+struct Result {
+    float mbb_per_hand;   // LBR(P0) + LBR(P1), lower bound on exploitability in mbb/hand
+    float lbr_p0_mbb;     // LBR as P0 vs P1's average strategy
+    float lbr_p1_mbb;     // LBR as P1 vs P0's average strategy
+    float std_error_mbb;  // standard error of mbb_per_hand
+    int   deals;
+};
+
+// rootState: start of the flop (research version: street=1, pot=2000, stacks=9000)
+Result compute(
+    const BestResponse::InfosetMap& map, // infoset map from completed MCCFR training
+    const BetAbstraction::BetConfig& betConfig, // bet abstraction the map was trained with
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const Options& options = Options{}
+);
+
+// same evaluation, strategy read from a frozen table
+Result compute(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    int bigBlind,
+    const Options& options = Options{}
+);
+
+}
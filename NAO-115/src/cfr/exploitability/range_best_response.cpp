@@ -0,0 +1,485 @@
+#include "range_best_response.hpp"
+#include "../cfr-core/game_engine.hpp"
+#include "../include/bucket-lookups/lut_indexer.hpp"
+#include "../utils/zobrist.hpp"
+#include "../utils/counter_rng.hpp"
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <omp.h>
+
+namespace RangeBestResponse {
+
+namespace {
+
+/*
+One board of the chance tree, shared by every history that reaches it.
+ - buckets and showdown order are filled on first use
+ - the dealt / sampled next cards are fixed on first use too, so both BR players and all histories see the same runouts
+ */
+struct BoardNode {
+    std::array<int, 5> cards{};
+    int numCards = 0;
+    uint64_t mask = 0;
+
+    bool hasBuckets = false;
+    std::vector<uint16_t> slot;      // per holding: index into bucketIds (0 for blocked holdings)
+    std::vector<int32_t> bucketIds;  // distinct buckets on this board
+
+    bool hasRanking = false;
+    std::vector<uint16_t> order;     // live holdings, weakest first
+    std::vector<int32_t> scores;     // showdown score per order entry (lower = stronger)
+
+    bool hasNextCards = false;
+    std::vector<int> nextCards;
+    double nextScale = 0.0;          // (#candidates / #drawn) / #cards valid for a pair of live holdings
+    std::array<std::unique_ptr<BoardNode>, 52> next;
+
+    bool blocks(int holding) const {
+        return Holdings::blocked(holding, mask);
+    }
+};
+
+template <typename StrategySource>
+class Walker {
+public:
+    Walker(const StrategySource& strategy,
+           const BetAbstraction::BetConfig& betConfig,
+           Bucketer::IsomorphismEngine& mappingEngine,
+           const Options& options,
+           uint64_t streamId)
+    : strategy(strategy), betConfig(betConfig), mappingEngine(mappingEngine), options(options), rng(options.seed, streamId) {}
+
+    // sum of the BR values over all live BR holdings on this flop (each against all compatible opponent holdings)
+    double evaluate(int player, const MCCFRState& root, BoardNode& flop) {
+        brPlayer = player;
+
+        std::vector<float> reach(NUM_HOLDINGS);
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            reach[h] = flop.blocks(h) ? 0.0f : 1.0f;
+        }
+
+        std::vector<double> values(NUM_HOLDINGS);
+        walk(root, flop, reach.data(), values.data());
+
+        double total = 0.0;
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            total += values[h];
+        }
+        return total;
+    }
+
+private:
+    const StrategySource& strategy;
+    const BetAbstraction::BetConfig& betConfig;
+    Bucketer::IsomorphismEngine& mappingEngine;
+    const Options& options;
+    CounterRNG::Stream rng;
+    int brPlayer = 0;
+
+    void walk(const MCCFRState& state, BoardNode& board, const float* reach, double* values) {
+        std::fill(values, values + NUM_HOLDINGS, 0.0);
+
+        // fold -> board stays, showdown -> run the board out, otherwise the street's cards must be out
+        int needed = state.isTerminal ? (state.foldedPlayer != -1 ? board.numCards : 5) : state.street + 2;
+        if (board.numCards < needed) {
+            chance(state, board, reach, values);
+            return;
+        }
+
+        if (state.isTerminal) {
+            if (state.foldedPlayer != -1) {
+                foldValues(state, board, reach, values);
+            } else {
+                showdownValues(state, board, reach, values);
+            }
+            return;
+        }
+
+        auto actions = BetAbstraction::getLegalActions(state, betConfig);
+
+        // 'Best Response player' node: max per holding
+        if (state.currentPlayer == brPlayer) {
+            std::vector<double> child(NUM_HOLDINGS);
+            for (int i = 0; i < actions.count; ++i) {
+                MCCFRState next = state;
+                next.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][i];
+                next = GameEngine::applyAction(next, actions.actions[i]);
+
+                if (i == 0) {
+                    walk(next, board, reach, values);
+                    continue;
+                }
+                walk(next, board, reach, child.data());
+                for (int h = 0; h < NUM_HOLDINGS; ++h) {
+                    values[h] = std::max(values[h], child[h]);
+                }
+            }
+            return;
+        }
+
+        // opponent node: one strategy lookup per distinct bucket, reach split by action
+        ensureBuckets(board);
+        size_t numBuckets = board.bucketIds.size();
+        std::vector<float> strategies(numBuckets * MCCFR::MAX_ACTIONS);
+
+        for (size_t b = 0; b < numBuckets; ++b) {
+            float* out = &strategies[b * MCCFR::MAX_ACTIONS];
+            MCCFR::InfosetKey key{state.historyHash, board.bucketIds[b]};
+
+            float sum = 0.0f;
+            if (BestResponse::lookupAverageStrategy(strategy, key, actions.count, out)) {
+                for (int i = 0; i < actions.count; ++i) {
+                    sum += out[i];
+                }
+            }
+
+            // missing infoset or empty vector -> uniform, same as the sampled BR
+            for (int i = 0; i < actions.count; ++i) {
+                out[i] = (sum > 1e-6f) ? out[i] / sum : 1.0f / static_cast<float>(actions.count);
+            }
+        }
+
+        std::vector<float> childReach(NUM_HOLDINGS);
+        std::vector<double> child(NUM_HOLDINGS);
+        for (int i = 0; i < actions.count; ++i) {
+            float mass = 0.0f;
+            for (int h = 0; h < NUM_HOLDINGS; ++h) {
+                childReach[h] = reach[h] * strategies[board.slot[h] * MCCFR::MAX_ACTIONS + i];
+                mass += childReach[h];
+            }
+            if (mass <= 0.0f) {
+                continue;
+            }
+
+            MCCFRState next = state;
+            next.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][i];
+            next = GameEngine::applyAction(next, actions.actions[i]);
+
+            walk(next, board, childReach.data(), child.data());
+            for (int h = 0; h < NUM_HOLDINGS; ++h) {
+                values[h] += child[h];
+            }
+        }
+    }
+
+    // next board card: average over the dealt (or sampled) cards, holdings containing the card drop out on both sides
+    void chance(const MCCFRState& state, BoardNode& board, const float* reach, double* values) {
+        ensureNextCards(board);
+
+        std::vector<float> childReach(NUM_HOLDINGS);
+        std::vector<double> child(NUM_HOLDINGS);
+        for (int card : board.nextCards) {
+            BoardNode& next = childBoard(board, card);
+
+            std::copy(reach, reach + NUM_HOLDINGS, childReach.begin());
+            for (uint16_t h : Holdings::table().byCard[card]) {
+                childReach[h] = 0.0f;
+            }
+
+            walk(state, next, childReach.data(), child.data());
+            for (int h = 0; h < NUM_HOLDINGS; ++h) {
+                values[h] += child[h];
+            }
+        }
+
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            values[h] *= board.nextScale;
+        }
+    }
+
+    void foldValues(const MCCFRState& state, const BoardNode& board, const float* reach, double* values) {
+        const auto& cards = Holdings::table().cards;
+        int pot = state.player0Contribution + state.player1Contribution;
+        int own = (brPlayer == 0) ? state.player0Contribution : state.player1Contribution;
+        double payoff = (state.foldedPlayer == brPlayer) ? -own : pot - own;
+
+        double total = 0.0;
+        std::array<double, 52> cardSum{};
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            total += reach[h];
+            cardSum[cards[h][0]] += reach[h];
+            cardSum[cards[h][1]] += reach[h];
+        }
+
+        // opponent holdings compatible with h: h itself was subtracted twice
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            if (board.blocks(h)) {
+                continue;
+            }
+            values[h] = payoff * (total - cardSum[cards[h][0]] - cardSum[cards[h][1]] + reach[h]);
+        }
+    }
+
+    void showdownValues(const MCCFRState& state, BoardNode& board, const float* reach, double* values) {
+        ensureRanking(board);
+
+        const auto& cards = Holdings::table().cards;
+        int pot = state.player0Contribution + state.player1Contribution;
+        int own = (brPlayer == 0) ? state.player0Contribution : state.player1Contribution;
+        int split = (brPlayer == 0) ? pot / 2 + pot % 2 : pot / 2; // odd chip to player 0, same as getPayoff
+
+        size_t n = board.order.size();
+        std::vector<double> win(NUM_HOLDINGS, 0.0);
+        std::vector<double> lose(NUM_HOLDINGS, 0.0);
+
+        // weakest -> strongest: everything added before a score group is beaten by it
+        double total = 0.0;
+        std::array<double, 52> cardSum{};
+        for (size_t i = 0; i < n;) {
+            size_t j = i;
+            while (j < n && board.scores[j] == board.scores[i]) {
+                j++;
+            }
+            for (size_t k = i; k < j; ++k) {
+                int h = board.order[k];
+                win[h] = total - cardSum[cards[h][0]] - cardSum[cards[h][1]];
+            }
+            for (size_t k = i; k < j; ++k) {
+                int h = board.order[k];
+                total += reach[h];
+                cardSum[cards[h][0]] += reach[h];
+                cardSum[cards[h][1]] += reach[h];
+            }
+            i = j;
+        }
+
+        // strongest -> weakest for the losses
+        double stronger = 0.0;
+        std::array<double, 52> strongerCardSum{};
+        for (size_t i = n; i > 0;) {
+            size_t j = i;
+            while (j > 0 && board.scores[j - 1] == board.scores[i - 1]) {
+                j--;
+            }
+            for (size_t k = j; k < i; ++k) {
+                int h = board.order[k];
+                lose[h] = stronger - strongerCardSum[cards[h][0]] - strongerCardSum[cards[h][1]];
+            }
+            for (size_t k = j; k < i; ++k) {
+                int h = board.order[k];
+                stronger += reach[h];
+                strongerCardSum[cards[h][0]] += reach[h];
+                strongerCardSum[cards[h][1]] += reach[h];
+            }
+            i = j;
+        }
+
+        for (size_t k = 0; k < n; ++k) {
+            int h = board.order[k];
+            double compatible = total - cardSum[cards[h][0]] - cardSum[cards[h][1]] + reach[h];
+            double tie = compatible - win[h] - lose[h];
+            values[h] = win[h] * pot + tie * split - compatible * own;
+        }
+    }
+
+    void ensureBuckets(BoardNode& board) {
+        if (board.hasBuckets) {
+            return;
+        }
+
+        const auto& cards = Holdings::table().cards;
+        robin_hood::unordered_flat_map<int32_t, uint16_t> slots;
+        board.slot.assign(NUM_HOLDINGS, 0);
+        board.bucketIds.clear();
+
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            if (board.blocks(h)) {
+                continue;
+            }
+            int32_t bucket = Bucketer::lookup_bucket(mappingEngine, cards[h].data(), board.cards.data(), board.numCards);
+            auto it = slots.find(bucket);
+            if (it == slots.end()) {
+                it = slots.emplace(bucket, static_cast<uint16_t>(board.bucketIds.size())).first;
+                board.bucketIds.push_back(bucket);
+            }
+            board.slot[h] = it->second;
+        }
+
+        // everything blocked cannot happen on a legal board, keep slot 0 valid anyway
+        if (board.bucketIds.empty()) {
+            board.bucketIds.push_back(0);
+        }
+        board.hasBuckets = true;
+    }
+
+    void ensureRanking(BoardNode& board) {
+        if (board.hasRanking) {
+            return;
+        }
+
+        const auto& cards = Holdings::table().cards;
+        std::vector<std::pair<int32_t, uint16_t>> ranked;
+        ranked.reserve(NUM_HOLDINGS);
+        for (int h = 0; h < NUM_HOLDINGS; ++h) {
+            if (board.blocks(h)) {
+                continue;
+            }
+            int32_t score = GameEngine::showdownScore({cards[h][0], cards[h][1]}, board.cards);
+            ranked.emplace_back(score, static_cast<uint16_t>(h));
+        }
+
+        // higher score = weaker hand -> weakest first
+        std::sort(ranked.begin(), ranked.end(),
+                  [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        board.order.resize(ranked.size());
+        board.scores.resize(ranked.size());
+        for (size_t k = 0; k < ranked.size(); ++k) {
+            board.scores[k] = ranked[k].first;
+            board.order[k] = ranked[k].second;
+        }
+        board.hasRanking = true;
+    }
+
+    void ensureNextCards(BoardNode& board) {
+        if (board.hasNextCards) {
+            return;
+        }
+
+        std::vector<int> candidates;
+        for (int c = 0; c < 52; ++c) {
+            if (!((board.mask >> c) & 1ULL)) {
+                candidates.push_back(c);
+            }
+        }
+
+        int limit = (board.numCards == 3) ? options.turnCards : options.riverCards;
+        int count = static_cast<int>(candidates.size());
+        int drawn = (limit > 0 && limit < count) ? limit : count;
+
+        // partial Fisher-Yates, only the first 'drawn' cards are used
+        if (drawn < count) {
+            for (int i = 0; i < drawn; ++i) {
+                int j = rng.uniformInt(i, count - 1);
+                std::swap(candidates[i], candidates[j]);
+            }
+            candidates.resize(drawn);
+        }
+
+        // a pair of live holdings leaves 52 - board - 4 possible cards, all of them equally likely
+        int validCards = 52 - board.numCards - 4;
+        board.nextCards = std::move(candidates);
+        board.nextScale = static_cast<double>(count) / (static_cast<double>(drawn) * validCards);
+        board.hasNextCards = true;
+    }
+
+    BoardNode& childBoard(BoardNode& board, int card) {
+        std::unique_ptr<BoardNode>& next = board.next[card];
+        if (!next) {
+            next = std::make_unique<BoardNode>();
+            next->cards = board.cards;
+            next->cards[board.numCards] = card;
+            next->numCards = board.numCards + 1;
+            next->mask = board.mask | (1ULL << card);
+        }
+        return *next;
+    }
+};
+
+template <typename StrategySource>
+Values computeWith(
+    const StrategySource& strategy,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    const Options& options)
+{
+    if (rootState.street != 1) {
+        throw std::runtime_error("RangeBestResponse: root state must be the start of the flop");
+    }
+
+    // weight of each canonical flop = number of raw flops mapping to it
+    int64_t numFlops = static_cast<int64_t>(mappingEngine.getBoardFlopCombinations());
+    std::vector<double> weight(numFlops, 0.0);
+    for (int a = 0; a < 52; ++a) {
+        for (int b = a + 1; b < 52; ++b) {
+            for (int c = b + 1; c < 52; ++c) {
+                std::array<uint8_t, 3> flop = {static_cast<uint8_t>(a), static_cast<uint8_t>(b), static_cast<uint8_t>(c)};
+                weight[mappingEngine.getBoardFlopIndex(flop)] += 1.0;
+            }
+        }
+    }
+
+    // optional uniform subset of canonical flops, reweighted so the estimate stays unbiased
+    std::vector<int64_t> selected(numFlops);
+    std::iota(selected.begin(), selected.end(), 0);
+    double selectionScale = 1.0;
+    if (options.maxFlops > 0 && options.maxFlops < numFlops) {
+        CounterRNG::Stream selectionRng(options.seed, static_cast<uint64_t>(numFlops));
+        for (int i = 0; i < options.maxFlops; ++i) {
+            int j = selectionRng.uniformInt(i, static_cast<int>(numFlops) - 1);
+            std::swap(selected[i], selected[j]);
+        }
+        selected.resize(options.maxFlops);
+        std::sort(selected.begin(), selected.end());
+        selectionScale = static_cast<double>(numFlops) / options.maxFlops;
+    }
+
+    int64_t numSelected = static_cast<int64_t>(selected.size());
+    std::vector<double> flopValue0(numSelected, 0.0);
+    std::vector<double> flopValue1(numSelected, 0.0);
+    int numThreads = options.numThreads > 0 ? options.numThreads : omp_get_max_threads();
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(numThreads)
+    for (int64_t i = 0; i < numSelected; ++i) {
+        std::array<uint8_t, 3> cards = mappingEngine.unindexBoardFlop(static_cast<uint64_t>(selected[i]));
+
+        BoardNode flop;
+        flop.numCards = 3;
+        for (int k = 0; k < 3; ++k) {
+            flop.cards[k] = cards[k];
+            flop.mask |= 1ULL << cards[k];
+        }
+
+        // stream per canonical flop -> same runouts regardless of thread count or subset
+        Walker<StrategySource> walker(strategy, betConfig, mappingEngine, options, static_cast<uint64_t>(selected[i]));
+        flopValue0[i] = walker.evaluate(0, rootState, flop);
+        flopValue1[i] = walker.evaluate(1, rootState, flop);
+    }
+
+    // deals per flop: C(49,2) BR holdings * C(47,2) opponent holdings, C(52,3) raw flops
+    const double dealsPerFlop = 1176.0 * 1081.0;
+    const double rawFlops = 22100.0;
+
+    // fixed order reduction -> reproducible sums
+    double sum0 = 0.0;
+    double sum1 = 0.0;
+    for (int64_t i = 0; i < numSelected; ++i) {
+        sum0 += weight[selected[i]] * flopValue0[i];
+        sum1 += weight[selected[i]] * flopValue1[i];
+    }
+
+    Values values;
+    values.br_p0 = sum0 * selectionScale / (dealsPerFlop * rawFlops);
+    values.br_p1 = sum1 * selectionScale / (dealsPerFlop * rawFlops);
+    values.flops_evaluated = static_cast<int>(numSelected);
+    return values;
+}
+
+}
+
+Values compute(
+    const BestResponse::InfosetMap& map,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    const Options& options)
+{
+    return computeWith(map, betConfig, mappingEngine, rootState, options);
+}
+
+Values compute(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    const Options& options)
+{
+    return computeWith(table, betConfig, mappingEngine, rootState, options);
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "best_response.hpp"
+#include "holdings.hpp"
+#include <cstdint>
+
+namespace RangeBestResponse {
+
+/*
+Public-tree best response against a fixed average strategy.
+ -> source: Johanson, Waugh, Bowling & Zinkevich (2011), "Accelerating Best Response Calculation in Large Extensive Games", IJCAI
+
+ Instead of one walk per sampled deal (where the BR player also sees the opponent's cards), the betting tree is
+ walked once per board with vectors over all 1326 holdings:
+ - opponent side: reach probability of every holding, multiplied by the average strategy of its bucket at each node
+ - BR side: value of every BR holding, max over actions at BR nodes -> the BR only knows its own cards and the board
+ - fold terminals: reach sums with card removal (total - sum[c1] - sum[c2] + reach[h])
+ - showdowns: holdings sorted by showdown score, win / lose reach from running sums, O(n) per terminal
+ - chance (turn / river, also all-in runouts): enumerated or sampled per board, buckets and showdown order cached per board
+
+ Flops are the 1755 suit-isomorphic flop boards weighted by their number of raw flops, in parallel over OpenMP.
+ The result is the exploitability of the strategy in the postflop game with real cards (the opponent plays through its buckets).
+
+ Cost: river buckets are computed from features, so a full enumeration (every turn and river card) is expensive.
+ The defaults enumerate everything (exact value). Options can sample turn / river cards and flops instead, samples are
+ shared by every history that reaches the same board. A max over sample averages is biased upwards, so sampled values
+ are an estimate (usually above the exact value), not a bound.
+ */
+
+static constexpr int NUM_HOLDINGS = Holdings::NUM_HOLDINGS;
+
+struct Options {
+    int turnCards  = 0;   // turn cards per flop, 0 = all 49
+    int riverCards = 0;   // river cards per turn, 0 = all 48
+    int maxFlops   = 0;   // canonical flops evaluated (uniform subset, reweighted), 0 = all 1755
+    uint64_t seed  = 1;   // card sampling, flop i uses stream (seed, i)
+    int numThreads = 0;   // 0 = OpenMP default
+
+    // anything but a full enumeration
+    bool sampled() const {
+        return turnCards > 0 || riverCards > 0 || maxFlops > 0;
+    }
+};
+
+// the previous defaults: 8 turn and 4 river cards per board, quick but sampled
+inline Options sampledOptions(uint64_t seed = 1) {
+    Options options;
+    options.turnCards = 8;
+    options.riverCards = 4;
+    options.seed = seed;
+    return options;
+}
+
+// best response values in chips per hand, from each BR player's perspective
+struct Values {
+    double br_p0;        // P0 best response vs P1's average strategy
+    double br_p1;        // P1 best response vs P0's average strategy
+    int flops_evaluated;
+};
+
+// rootState must be the start of the flop (street = 1), both hands and the flop are dealt uniformly
+Values compute(
+    const BestResponse::InfosetMap& map, // infoset map from completed MCCFR training
+    const BetAbstraction::BetConfig& betConfig, // bet abstraction the map was trained with
+    Bucketer::IsomorphismEngine& mappingEngine, // bucket lookups + canonical flops
+    const MCCFRState& rootState,
+    const Options& options = Options{}
+);
+
+// same walk, strategy read from a frozen table
+Values compute(
+    const FrozenStrategy::Table& table,
+    const BetAbstraction::BetConfig& betConfig,
+    Bucketer::IsomorphismEngine& mappingEngine,
+    const MCCFRState& rootState,
+    const Options& options = Options{}
+);
+
+}
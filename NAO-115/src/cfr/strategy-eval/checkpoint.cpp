@@ -0,0 +1,154 @@
+#include "checkpoint.hpp"
+#include "cfr/cfr-core/mccfr_multithread.hpp"
+#include <cstdio>
+#include <utility>
+
+namespace Checkpoint {
+
+std::string deltaPath(const std::string& prefix, int thread, uint64_t sequence) {
+    return prefix + ".t" + std::to_string(thread) + "." + std::to_string(sequence) + ".delta";
+}
+
+std::string manifestPath(const std::string& prefix) {
+    return prefix + ".manifest";
+}
+
+// "<thread> <chain length>" per line, through a temporary file so a reader never sees half a manifest
+static bool writeManifest(const std::string& prefix, const std::map<int, uint64_t>& chainLengths) {
+    const std::string path = manifestPath(prefix);
+    const std::string temporary = path + ".tmp";
+    FILE* f = fopen(temporary.c_str(), "w");
+    if (!f) {
+        fprintf(stderr, "Checkpoint: cannot write %s\n", temporary.c_str());
+        return false;
+    }
+    bool ok = true;
+    for (const auto& [thread, length] : chainLengths) {
+        ok = ok && fprintf(f, "%d %llu\n", thread, static_cast<unsigned long long>(length)) > 0;
+    }
+    if (fclose(f) != 0 || !ok || std::rename(temporary.c_str(), path.c_str()) != 0) {
+        fprintf(stderr, "Checkpoint: cannot write %s\n", path.c_str());
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return true;
+}
+
+static bool readManifest(const std::string& prefix, std::map<int, uint64_t>& chainLengths) {
+    const std::string path = manifestPath(prefix);
+    FILE* f = fopen(path.c_str(), "r");
+    if (!f) {
+        fprintf(stderr, "Checkpoint: no manifest %s\n", path.c_str());
+        return false;
+    }
+    int thread;
+    unsigned long long length;
+    while (fscanf(f, "%d %llu", &thread, &length) == 2) {
+        chainLengths[thread] = length;
+    }
+    fclose(f);
+    return true;
+}
+
+Writer::Writer(std::string prefix, size_t maxPending)
+: prefix(std::move(prefix)), maxPending(maxPending > 0 ? maxPending : 1) {
+    // a new run: chains of an earlier run on this prefix no longer count
+    failed = !writeManifest(this->prefix, chainLengths);
+    worker = std::thread([this] { run(); });
+}
+
+Writer::~Writer() {
+    finish();
+}
+
+void Writer::submit(int thread, uint64_t sequence, StrategyIO::InfosetMap delta) {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return pending.size() < maxPending; });
+    pending.push_back(Job{thread, sequence, std::move(delta)});
+    changed.notify_all();
+}
+
+bool Writer::finish() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stopping = true;
+        changed.notify_all();
+    }
+    if (worker.joinable()) {
+        worker.join();
+    }
+    return !failed;
+}
+
+void Writer::run() {
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [this] { return !pending.empty() || stopping; });
+            if (pending.empty()) {
+                return;
+            }
+            job = std::move(pending.front());
+            pending.pop_front();
+            changed.notify_all(); // a blocked submit can go on
+        }
+
+        // single stream writer: no OpenMP team competing with the training threads
+        bool ok = StrategyIO::save(job.delta, deltaPath(prefix, job.thread, job.sequence), StrategyIO::Format::Stream);
+        
+        // the chain only grows without gaps
+        uint64_t& length = chainLengths[job.thread];
+        if (ok && job.sequence == length) {
+            ++length;
+            ok = writeManifest(prefix, chainLengths);
+        }
+        if (!ok) {
+            std::lock_guard<std::mutex> lock(mutex);
+            failed = true;
+        }
+    }
+}
+
+bool fold(StrategyIO::InfosetMap& out, const std::string& prefix, int numThreads) {
+    out.clear();
+
+    std::map<int, uint64_t> chainLengths;
+    if (!readManifest(prefix, chainLengths)) {
+        return false;
+    }
+
+    for (int t = 0; t < numThreads; ++t) {
+        const uint64_t length = chainLengths.count(t) ? chainLengths[t] : 0;
+        if (length == 0) {
+            fprintf(stderr, "Checkpoint: no checkpoint for thread %d under %s\n", t, prefix.c_str());
+            return false;
+        }
+
+        // thread chain: later deltas replace earlier values
+        StrategyIO::InfosetMap threadMap;
+        StrategyIO::InfosetMap delta;
+        for (uint64_t sequence = 0; sequence < length; ++sequence) {
+            if (!StrategyIO::load(delta, deltaPath(prefix, t, sequence))) {
+                return false;
+            }
+            for (const auto& [key, infoset] : delta) {
+                threadMap[key] = infoset;
+            }
+        }
+
+        // threads are summed like the trainer's final merge
+        MCCFR::ParallelTrainer::mergeMaps(out, threadMap);
+    }
+    return true;
+}
+
+bool compact(const std::string& prefix, int numThreads, const std::string& outPath, StrategyIO::Format format) {
+    StrategyIO::InfosetMap map;
+    if (!fold(map, prefix, numThreads)) {
+        return false;
+    }
+    return StrategyIO::save(map, outPath, format);
+}
+
+}
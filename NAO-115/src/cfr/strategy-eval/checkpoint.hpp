@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+Delta (incremental) checkpoints for long training runs.
+ A full StrategyIO::save of the regret table stalls training and rewrites mostly unchanged entries,
+ a delta checkpoint only writes the infosets updated since the previous one.
+
+ - every Infoset carries the epoch of its last update (touchedEpoch), the trainer keeps the keys of the
+   infosets first updated in the current epoch -> collecting a delta is O(touched), not a scan of the table
+ - training threads keep their own maps (see ParallelTrainer), so checkpoints are chains per thread:
+      <prefix>.t<thread>.<seq>.delta, seq 0 holds everything the thread had seen at the first checkpoint
+ - <prefix>.manifest lists the chain length of every thread of the current run (rewritten after each delta,
+   emptied when a run starts) -> deltas left over by an earlier run on the same prefix are never folded in
+ - each delta is a regular full-mode StrategyIO file (v2 stream, single threaded so it does not steal
+   cores from training) holding the thread's current values of its touched infosets
+ - the training thread only copies its touched infosets, compression and disk writes run on a background
+   writer thread while training continues
+
+ Compaction: per thread the chain is folded in order (later entries replace earlier ones), then the threads
+ are summed like ParallelTrainer's final merge -> the same table a full save at that point would have written.
+ */
+
+#include "strategy_io.hpp"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace Checkpoint {
+
+// file of one delta in a thread's chain
+std::string deltaPath(const std::string& prefix, int thread, uint64_t sequence);
+
+// chain lengths of the run that last wrote under prefix
+std::string manifestPath(const std::string& prefix);
+
+/*
+Background writer for delta checkpoints.
+ - submit hands a delta over and returns immediately, unless maxPending deltas are already waiting
+   (then it blocks, so a slow disk cannot grow memory without bound)
+ - finish waits for every submitted delta, returns false if any write failed
+ - the manifest only counts a delta once it and every earlier delta of its thread are on disk
+ */
+class Writer {
+public:
+    explicit Writer(std::string prefix, size_t maxPending = 8);
+    ~Writer();
+
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void submit(int thread, uint64_t sequence, StrategyIO::InfosetMap delta);
+    bool finish();
+
+private:
+    struct Job {
+        int thread;
+        uint64_t sequence;
+        StrategyIO::InfosetMap delta;
+    };
+
+    std::string prefix;
+    size_t maxPending;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<Job> pending;
+    std::map<int, uint64_t> chainLengths; // written deltas per thread (writer thread only)
+    bool stopping = false;
+    bool failed = false;
+    std::thread worker;
+
+    void run();
+};
+
+/*
+Fold the chains of numThreads threads into one full table
+ - each chain is read up to the length in the manifest, later files with the same prefix are ignored
+ - returns false if the manifest is missing, a thread has no checkpoint or a file cannot be read
+ */
+bool fold(StrategyIO::InfosetMap& out, const std::string& prefix, int numThreads);
+
+// fold + write a full v2 / v3 file (StrategyIO::save)
+bool compact(const std::string& prefix, int numThreads, const std::string& outPath,
+             StrategyIO::Format format = StrategyIO::Format::Chunked);
+
+}
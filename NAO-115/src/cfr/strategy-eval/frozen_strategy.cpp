@@ -0,0 +1,428 @@
+#include "frozen_strategy.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace FrozenStrategy {
+
+size_t Table::bytesPerThreshold(Precision precision) {
+    switch (precision) {
+        case Precision::Float32:
+            return 4;
+        case Precision::UInt16:
+            return 2;
+        case Precision::UInt8:
+            return 1;
+    }
+    return 4;
+}
+
+Table::Table(const Table& other)
+: storedPrecision(other.storedPrecision),
+  numEntries(other.numEntries),
+  keys(other.keys),
+  actionCounts(other.actionCounts),
+  thresholds(other.thresholds),
+  radix(other.radix),
+  ownedKeys(other.ownedKeys),
+  ownedActionCounts(other.ownedActionCounts),
+  ownedThresholds(other.ownedThresholds),
+  ownedRadix(other.ownedRadix),
+  externalOwner(other.externalOwner)
+{
+    // owned copy -> re-point, attached copy -> share the external buffers
+    if (!ownedKeys.empty() || !ownedRadix.empty()) {
+        pointAtOwned();
+    }
+}
+
+Table& Table::operator=(const Table& other) {
+    if (this != &other) {
+        Table copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+void Table::pointAtOwned() {
+    keys = ownedKeys.data();
+    actionCounts = ownedActionCounts.data();
+    thresholds = ownedThresholds.data();
+    radix = ownedRadix.data();
+}
+
+void Table::attach(Precision precision, size_t count,
+                   const uint64_t* keyBuffer, const uint8_t* actionCountBuffer,
+                   const uint8_t* thresholdBuffer, const uint32_t* radixBuffer,
+                   std::shared_ptr<const void> owner) {
+    ownedKeys.clear();
+    ownedActionCounts.clear();
+    ownedThresholds.clear();
+    ownedRadix.clear();
+
+    storedPrecision = precision;
+    numEntries = count;
+    keys = keyBuffer;
+    actionCounts = actionCountBuffer;
+    thresholds = thresholdBuffer;
+    radix = radixBuffer;
+    externalOwner = std::move(owner);
+}
+
+float Table::scale() const {
+    switch (storedPrecision) {
+        case Precision::Float32:
+            return 1.0f;
+        case Precision::UInt16:
+            return 65535.0f;
+        case Precision::UInt8:
+            return 255.0f;
+    }
+    return 1.0f;
+}
+
+size_t Table::memoryBytes() const {
+    return numEntries * (sizeof(uint64_t) + sizeof(uint8_t)) + thresholdBytes() + RADIX_SIZE * sizeof(uint32_t);
+}
+
+Table Table::freeze(const InfosetMap& map, Precision precision) {
+    // sort entries by fused key
+    std::vector<SortEntry> entries;
+    entries.reserve(map.size());
+    for (const auto& [key, infoset] : map) {
+        entries.emplace_back(fuseKey(key), &infoset);
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    return fromSorted(entries, precision);
+}
+
+Table Table::freeze(const std::vector<InfosetMap>& shards, Precision precision) {
+    std::vector<size_t> offsets(shards.size() + 1, 0);
+    for (size_t s = 0; s < shards.size(); ++s) {
+        offsets[s + 1] = offsets[s] + shards[s].size();
+    }
+
+    // every shard is gathered and sorted on its own thread into its slice
+    std::vector<SortEntry> entries(offsets.back());
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int s = 0; s < static_cast<int>(shards.size()); ++s) {
+        SortEntry* out = entries.data() + offsets[s];
+        for (const auto& [key, infoset] : shards[s]) {
+            *out++ = SortEntry(fuseKey(key), &infoset);
+        }
+        std::sort(entries.begin() + offsets[s], entries.begin() + offsets[s + 1],
+                  [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+
+    // shards split by top key bits (StrategyIO::shardOf) are already in order, anything else is merged here
+    auto less = [](const auto& a, const auto& b) { return a.first < b.first; };
+    if (!std::is_sorted(entries.begin(), entries.end(), less)) {
+        std::sort(entries.begin(), entries.end(), less);
+    }
+
+    return fromSorted(entries, precision);
+}
+
+Table Table::fromSorted(const std::vector<SortEntry>& entries, Precision precision) {
+    Table table;
+    table.storedPrecision = precision;
+    table.numEntries = entries.size();
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        if (entries[i].first == entries[i - 1].first) {
+            throw std::runtime_error("FrozenStrategy: fused key collision at key " + std::to_string(entries[i].first));
+        }
+    }
+
+    size_t width = bytesPerThreshold(precision);
+    float maxValue = table.scale();
+
+    table.ownedKeys.resize(entries.size());
+    table.ownedActionCounts.resize(entries.size());
+    table.ownedThresholds.assign(entries.size() * MCCFR::MAX_ACTIONS * width, 0);
+    table.ownedRadix.assign(RADIX_SIZE, 0);
+
+    for (size_t e = 0; e < entries.size(); ++e) {
+        const MCCFR::Infoset& infoset = *entries[e].second;
+        int count = infoset.numActions;
+
+        table.ownedKeys[e] = entries[e].first;
+        table.ownedActionCounts[e] = infoset.numActions;
+
+        float strategy[MCCFR::MAX_ACTIONS] = {0.0f};
+        if (count > 0) {
+            infoset.getAverageStrategy(strategy);
+        }
+
+        // cumulative thresholds, rounded per prefix so they stay monotone, last one is exactly the scale
+        uint8_t* out = table.ownedThresholds.data() + e * MCCFR::MAX_ACTIONS * width;
+        double cumulative = 0.0;
+        for (int i = 0; i < MCCFR::MAX_ACTIONS; ++i) {
+            if (i < count) {
+                cumulative += strategy[i];
+            }
+            double value = (i >= count - 1) ? 1.0 : std::min(cumulative, 1.0);
+
+            if (precision == Precision::Float32) {
+                float stored = static_cast<float>(value);
+                std::memcpy(out + i * width, &stored, sizeof(float));
+            } else if (precision == Precision::UInt16) {
+                uint16_t stored = static_cast<uint16_t>(std::lround(value * maxValue));
+                std::memcpy(out + i * width, &stored, sizeof(uint16_t));
+            } else {
+                out[i] = static_cast<uint8_t>(std::lround(value * maxValue));
+            }
+        }
+    }
+
+    // radix index: radix[b] = first entry whose top bits are >= b
+    size_t entry = 0;
+    for (size_t b = 0; b < RADIX_SIZE; ++b) {
+        while (entry < entries.size() && (table.ownedKeys[entry] >> (64 - RADIX_BITS)) < b) {
+            entry++;
+        }
+        table.ownedRadix[b] = static_cast<uint32_t>(entry);
+    }
+
+    table.pointAtOwned();
+    return table;
+}
+
+int64_t Table::find(const MCCFR::InfosetKey& key, int actionCount) const {
+    if (numEntries == 0) {
+        return -1;
+    }
+
+    uint64_t fused = fuseKey(key);
+    size_t top = static_cast<size_t>(fused >> (64 - RADIX_BITS));
+    const uint64_t* first = keys + radix[top];
+    const uint64_t* last = keys + radix[top + 1];
+
+    const uint64_t* it = std::lower_bound(first, last, fused);
+    if (it == last || *it != fused) {
+        return -1;
+    }
+
+    int64_t entry = it - keys;
+    if (actionCounts[entry] != actionCount) {
+        return -1;
+    }
+    return entry;
+}
+
+float Table::threshold(size_t entry, int action) const {
+    size_t width = bytesPerThreshold(storedPrecision);
+    const uint8_t* in = thresholds + (entry * MCCFR::MAX_ACTIONS + action) * width;
+
+    if (storedPrecision == Precision::Float32) {
+        float value;
+        std::memcpy(&value, in, sizeof(float));
+        return value;
+    }
+    if (storedPrecision == Precision::UInt16) {
+        uint16_t value;
+        std::memcpy(&value, in, sizeof(uint16_t));
+        return static_cast<float>(value);
+    }
+    return static_cast<float>(*in);
+}
+
+bool Table::getStrategy(const MCCFR::InfosetKey& key, int actionCount, float* out) const {
+    int64_t entry = find(key, actionCount);
+    if (entry < 0) {
+        return false;
+    }
+
+    float inverseScale = 1.0f / scale();
+    float previous = 0.0f;
+    for (int i = 0; i < actionCount; ++i) {
+        float current = threshold(static_cast<size_t>(entry), i);
+        out[i] = (current - previous) * inverseScale;
+        previous = current;
+    }
+    return true;
+}
+
+int Table::sampleAction(const MCCFR::InfosetKey& key, int actionCount, float random01) const {
+    int64_t entry = find(key, actionCount);
+    if (entry < 0) {
+        return -1;
+    }
+
+    float target = random01 * scale();
+    for (int i = 0; i < actionCount - 1; ++i) {
+        if (target < threshold(static_cast<size_t>(entry), i)) {
+            return i;
+        }
+    }
+    return actionCount - 1;
+}
+
+namespace {
+
+constexpr uint64_t MAPPED_FILE_MAGIC = 0x315A5246544F414EULL; // "NAOTFRZ1" as the first 8 bytes
+constexpr uint32_t MAPPED_VERSION = 1;
+constexpr uint64_t SECTION_ALIGNMENT = 64;
+
+#pragma pack(push, 1)
+struct MappedHeader {
+    uint64_t fileMagic;
+    uint32_t version;
+    uint8_t  precision;
+    uint8_t  radixBits;
+    uint8_t  maxActions;
+    uint8_t  reserved;
+    uint64_t numEntries;
+    uint64_t keysOffset;
+    uint64_t actionCountsOffset;
+    uint64_t thresholdsOffset;
+    uint64_t radixOffset;
+    uint64_t fileSize;
+};
+#pragma pack(pop)
+static_assert(sizeof(MappedHeader) == 64, "Mapped Header must be 64 bytes");
+
+uint64_t alignSection(uint64_t offset) {
+    return (offset + SECTION_ALIGNMENT - 1) & ~(SECTION_ALIGNMENT - 1);
+}
+
+// section offsets for a table of this size
+MappedHeader layoutFor(Precision precision, uint64_t numEntries) {
+    MappedHeader header{};
+    header.fileMagic = MAPPED_FILE_MAGIC;
+    header.version = MAPPED_VERSION;
+    header.precision = static_cast<uint8_t>(precision);
+    header.radixBits = RADIX_BITS;
+    header.maxActions = MCCFR::MAX_ACTIONS;
+    header.numEntries = numEntries;
+    header.keysOffset = alignSection(sizeof(MappedHeader));
+    header.actionCountsOffset = alignSection(header.keysOffset + numEntries * sizeof(uint64_t));
+    header.thresholdsOffset = alignSection(header.actionCountsOffset + numEntries);
+    header.radixOffset = alignSection(header.thresholdsOffset
+                                      + numEntries * MCCFR::MAX_ACTIONS * Table::bytesPerThreshold(precision));
+    header.fileSize = header.radixOffset + RADIX_SIZE * sizeof(uint32_t);
+    return header;
+}
+
+// owner of one read-only mapping
+struct Mapping {
+    void* address = nullptr;
+    size_t length = 0;
+
+    ~Mapping() {
+        if (address) munmap(address, length);
+    }
+};
+
+}
+
+bool saveMapped(const Table& table, const std::string& path) {
+    MappedHeader header = layoutFor(table.precision(), table.size());
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        fprintf(stderr, "FrozenStrategy: cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    // sections in file order, zero padding in between
+    const std::pair<uint64_t, std::pair<const void*, size_t>> sections[5] = {
+        {0, {&header, sizeof(header)}},
+        {header.keysOffset, {table.keyData(), table.size() * sizeof(uint64_t)}},
+        {header.actionCountsOffset, {table.actionCountData(), table.size()}},
+        {header.thresholdsOffset, {table.thresholdData(), table.thresholdBytes()}},
+        {header.radixOffset, {table.radixData(), table.empty() ? 0 : RADIX_SIZE * sizeof(uint32_t)}},
+    };
+    const uint8_t zeros[SECTION_ALIGNMENT] = {0};
+
+    bool ok = true;
+    uint64_t position = 0;
+    for (const auto& [offset, section] : sections) {
+        while (ok && position < offset) {
+            size_t pad = static_cast<size_t>(std::min<uint64_t>(offset - position, SECTION_ALIGNMENT));
+            ok = fwrite(zeros, 1, pad, f) == pad;
+            position += pad;
+        }
+        if (ok && section.second > 0) {
+            ok = fwrite(section.first, 1, section.second, f) == section.second;
+        }
+        position += section.second;
+    }
+
+    // an empty table has no radix array, keep the file size in the header valid
+    if (ok && table.empty()) {
+        std::vector<uint32_t> emptyRadix(RADIX_SIZE, 0);
+        ok = fwrite(emptyRadix.data(), sizeof(uint32_t), RADIX_SIZE, f) == RADIX_SIZE;
+    }
+
+    if (fclose(f) != 0 || !ok) {
+        fprintf(stderr, "FrozenStrategy: failed to write %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool loadMapped(Table& out, const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "FrozenStrategy: cannot open %s for reading\n", path.c_str());
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(MappedHeader)) {
+        fprintf(stderr, "FrozenStrategy: %s is too small for a table file\n", path.c_str());
+        close(fd);
+        return false;
+    }
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->length = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, mapping->length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file referenced
+    if (address == MAP_FAILED) {
+        fprintf(stderr, "FrozenStrategy: mmap failed for %s\n", path.c_str());
+        return false;
+    }
+    mapping->address = address;
+
+    MappedHeader header;
+    std::memcpy(&header, address, sizeof(header));
+
+    if (header.fileMagic != MAPPED_FILE_MAGIC || header.version != MAPPED_VERSION) {
+        fprintf(stderr, "FrozenStrategy: %s is not a table file (or has another version)\n", path.c_str());
+        return false;
+    }
+    if (header.radixBits != RADIX_BITS || header.maxActions != MCCFR::MAX_ACTIONS
+        || header.precision > static_cast<uint8_t>(Precision::UInt8)) {
+        fprintf(stderr, "FrozenStrategy: %s was written with an incompatible layout\n", path.c_str());
+        return false;
+    }
+
+    Precision precision = static_cast<Precision>(header.precision);
+    MappedHeader expected = layoutFor(precision, header.numEntries);
+    if (std::memcmp(&expected, &header, sizeof(header)) != 0 || header.fileSize != mapping->length) {
+        fprintf(stderr, "FrozenStrategy: inconsistent section offsets or truncated file %s\n", path.c_str());
+        return false;
+    }
+
+    const uint8_t* base = static_cast<const uint8_t*>(address);
+    out.attach(precision, header.numEntries,
+               reinterpret_cast<const uint64_t*>(base + header.keysOffset),
+               base + header.actionCountsOffset,
+               base + header.thresholdsOffset,
+               reinterpret_cast<const uint32_t*>(base + header.radixOffset),
+               std::shared_ptr<const void>(mapping, mapping->address));
+    return true;
+}
+
+}
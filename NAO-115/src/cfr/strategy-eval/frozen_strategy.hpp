@@ -0,0 +1,151 @@
+#pragma once
+
+/*
+Frozen, read-only play-time strategy table.
+ Built once after training from the (huge) robin_hood map of 64-byte Infosets, used by the match engine and best response.
+
+ What changes compared to the training map:
+    - average strategies are normalized once at freeze time (no division per lookup)
+    - stored as cumulative thresholds -> sampling an action is a short scan over <= 6 small integers, no prefix sums
+    - optional quantization: float (4 bytes / action), uint16 (2 bytes) or uint8 (1 byte)
+    - struct of arrays: keys, action counts and thresholds live in separate dense arrays
+
+ Layout:
+    - fused 64-bit key: historyHash ^ (bucketId * golden ratio constant), collisions are rejected at freeze time
+    - entries sorted by fused key
+    - radix index over the top 16 key bits -> a lookup is one index read + a binary search in a small range
+
+ The arrays are accessed through raw pointers only, owned vectors are just one possible backing
+ (the same table can point into a memory mapped file).
+ */
+
+#include "cfr/cfr-core/infoset.hpp"
+#include "cfr/external/robin_hood.h"
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace FrozenStrategy {
+
+using InfosetMap = robin_hood::unordered_flat_map<MCCFR::InfosetKey, MCCFR::Infoset, MCCFR::InfosetKeyHasher>;
+
+enum class Precision : uint8_t {
+    Float32 = 0,
+    UInt16  = 1,
+    UInt8   = 2
+};
+
+static constexpr int RADIX_BITS = 16;
+static constexpr size_t RADIX_SIZE = (size_t(1) << RADIX_BITS) + 1; // one extra slot closes the last range
+
+// single 64-bit key used by the frozen table
+inline uint64_t fuseKey(const MCCFR::InfosetKey& key) {
+    return key.historyHash ^ (static_cast<uint64_t>(static_cast<uint32_t>(key.bucketId)) * 0x9E3779B97F4A7C15ULL);
+}
+
+class Table {
+public:
+    Table() = default;
+
+    // pointers refer to the owned vectors -> copies must re-point, moves keep the buffers
+    Table(const Table& other);
+    Table& operator=(const Table& other);
+    Table(Table&&) noexcept = default;
+    Table& operator=(Table&&) noexcept = default;
+
+    /*
+    Build the table from a trained (or loaded) infoset map.
+     - throws std::runtime_error if two infosets fuse to the same 64-bit key
+     */
+    static Table freeze(const InfosetMap& map, Precision precision = Precision::UInt16);
+
+    // same table from a sharded map (StrategyIO::loadSharded), shards are gathered and sorted in parallel
+    static Table freeze(const std::vector<InfosetMap>& shards, Precision precision = Precision::UInt16);
+
+    /*
+    Normalized average strategy of the infoset.
+     - returns false if the key is unknown or was stored with a different action count
+       (callers fall back to uniform, same as with the map)
+     */
+    bool getStrategy(const MCCFR::InfosetKey& key, int actionCount, float* out) const;
+
+    /*
+    Sample an action directly from the cumulative thresholds.
+     - random01 in [0, 1)
+     - returns -1 if the key is unknown or the action count does not match
+     */
+    int sampleAction(const MCCFR::InfosetKey& key, int actionCount, float random01) const;
+
+    size_t size() const { return numEntries; }
+    bool empty() const { return numEntries == 0; }
+    Precision precision() const { return storedPrecision; }
+    size_t memoryBytes() const;
+
+    // raw views (serialization / memory mapping)
+    const uint64_t* keyData() const { return keys; }
+    const uint8_t* actionCountData() const { return actionCounts; }
+    const uint8_t* thresholdData() const { return thresholds; }
+    const uint32_t* radixData() const { return radix; }
+    size_t thresholdBytes() const { return numEntries * MCCFR::MAX_ACTIONS * bytesPerThreshold(storedPrecision); }
+
+    // point the table at external (read-only) buffers, the caller keeps them alive
+    // (or hands over an owner, e.g. a file mapping, that copies of the table share)
+    void attach(Precision precision, size_t count,
+                const uint64_t* keyBuffer, const uint8_t* actionCountBuffer,
+                const uint8_t* thresholdBuffer, const uint32_t* radixBuffer,
+                std::shared_ptr<const void> owner = nullptr);
+
+    static size_t bytesPerThreshold(Precision precision);
+
+private:
+    Precision storedPrecision = Precision::Float32;
+    size_t numEntries = 0;
+
+    const uint64_t* keys = nullptr;         // sorted fused keys
+    const uint8_t* actionCounts = nullptr;  // numActions per entry
+    const uint8_t* thresholds = nullptr;    // MAX_ACTIONS cumulative thresholds per entry, width depends on precision
+    const uint32_t* radix = nullptr;        // RADIX_SIZE start offsets by top key bits
+
+    // owned backing storage (empty when attached to external buffers)
+    std::vector<uint64_t> ownedKeys;
+    std::vector<uint8_t> ownedActionCounts;
+    std::vector<uint8_t> ownedThresholds;
+    std::vector<uint32_t> ownedRadix;
+
+    // keeps external buffers alive when attached with an owner
+    std::shared_ptr<const void> externalOwner;
+
+    void pointAtOwned();
+
+    using SortEntry = std::pair<uint64_t, const MCCFR::Infoset*>;
+    static Table fromSorted(const std::vector<SortEntry>& entries, Precision precision);
+
+    // index of the entry or -1
+    int64_t find(const MCCFR::InfosetKey& key, int actionCount) const;
+    float threshold(size_t entry, int action) const;
+    float scale() const;
+};
+
+/*
+Memory mappable table file: the four arrays of a Table written as they are, queried in place after mmap.
+ No decompression and no map construction on load, pages are read on first touch and shared through
+ the page cache by every process mapping the same file.
+
+ Layout (host byte order, sections 64-byte aligned):
+    [MappedHeader]  magic "NAOTFRZ1", version, precision, radix bits, entry count, section offsets, file size
+    [uint64_t keys[n]]                          sorted fused keys
+    [uint8_t  actionCounts[n]]
+    [thresholds, n * MAX_ACTIONS * width]       cumulative, precision dependent width
+    [uint32_t radix[RADIX_SIZE]]                index block: entry range per top 16 key bits
+
+ - saveMapped returns false if the file cannot be written
+ - loadMapped returns false if the file is missing, not a table file or inconsistent,
+   on success out is attached to the mapping (read-only, unmapped when the last copy of the table goes away)
+ */
+bool saveMapped(const Table& table, const std::string& path);
+bool loadMapped(Table& out, const std::string& path);
+
+}
@@ -3,17 +3,21 @@
 #include "cfr/cfr-core/game_engine.hpp"
 #include "cfr/cfr-core/infoset.hpp"
 #include "cfr/utils/zobrist.hpp"
+#include "cfr/utils/counter_rng.hpp"
+#include "cfr/utils/deal_sampler.hpp"
 #include "bet-abstraction/bet_sequence.hpp"
 #include "bet-abstraction/bet_utils.hpp"
 #include "eval/evaluator.hpp"
 #include "../include/bucket-lookups/lut_indexer.hpp"
 
-#include <random>
+#include <omp.h>
 #include <cmath>
 #include <cstring>
 #include <cstdio>
 #include <vector>
 #include <algorithm>
+#include <limits>
+#include <memory>
 
 namespace MatchEngine {
 
@@ -72,26 +76,14 @@ StrategyProfile buildProfile(StrategyIO::InfosetMap map,
         profile.turn[i]  = turnSizes[i];
         profile.river[i] = riverSizes[i];
         
-        fractionToRatio(flopSizes[i],  profile.flop_n[i],  profile.flop_d[i]);
-        fractionToRatio(turnSizes[i],  profile.turn_n[i],  profile.turn_d[i]);
-        fractionToRatio(riverSizes[i], profile.river_n[i], profile.river_d[i]);
+        fractionToRatio(flopSizes[i],  profile.betConfig.flop_numerators[i],  profile.betConfig.flop_denominators[i]);
+        fractionToRatio(turnSizes[i],  profile.betConfig.turn_numerators[i],  profile.betConfig.turn_denominators[i]);
+        fractionToRatio(riverSizes[i], profile.betConfig.river_numerators[i], profile.betConfig.river_denominators[i]);
     }
     
     return profile;
 }
 
-static void applyConfig(const StrategyProfile& profile) {
-    auto& bc = BetAbstraction::g_betConfig;
-    for (int i = 0; i < 3; ++i) {
-        bc.flop_numerators[i]    = profile.flop_n[i];
-        bc.flop_denominators[i]  = profile.flop_d[i];
-        bc.turn_numerators[i]    = profile.turn_n[i];
-        bc.turn_denominators[i]  = profile.turn_d[i];
-        bc.river_numerators[i]   = profile.river_n[i];
-        bc.river_denominators[i] = profile.river_d[i];
-    }
-}
-
 static MCCFRState makeRoot() {
     MCCFRState state{};
     state.bigBlind            = 100;
@@ -138,21 +130,55 @@ static int32_t getBucket(const MCCFRState& state,
     return Bucketer::lookup_bucket(isoEngine, actingHand.data(), boardCards.data(), boardCardCount);
 }
 
-static int sampleAction(const StrategyIO::InfosetMap& map, const MCCFR::InfosetKey& infosetKey, int actionCount, float random01) {
-    float strategy[MCCFR::MAX_ACTIONS];
+void freezeProfile(StrategyProfile& profile, FrozenStrategy::Precision precision) {
+    profile.frozen = FrozenStrategy::Table::freeze(profile.map, precision);
+    // the training map is no longer needed for play
+    StrategyIO::InfosetMap().swap(profile.map);
+}
+
+void freezeProfile(StrategyProfile& profile, const StrategyIO::ShardedMap& shards, FrozenStrategy::Precision precision) {
+    profile.frozen = FrozenStrategy::Table::freeze(shards, precision);
+    StrategyIO::InfosetMap().swap(profile.map);
+}
+
+bool mapProfile(StrategyProfile& profile, const std::string& path) {
+    FrozenStrategy::Table mapped;
+    if (!FrozenStrategy::loadMapped(mapped, path)) {
+        return false;
+    }
+    profile.frozen = std::move(mapped);
+    StrategyIO::InfosetMap().swap(profile.map);
+    return true;
+}
+
+static void uniformStrategy(int actionCount, float* strategy) {
+    float u = 1.0f / actionCount;
+    for (int i = 0; i < actionCount; ++i) {
+        strategy[i] = u;
+    }
+}
+
+// average strategy of the infoset, or uniform if Nao has never seen it
+// reads the frozen table when the profile has one, the training map otherwise
+static void getStrategy(const StrategyProfile& profile, const MCCFR::InfosetKey& infosetKey, int actionCount, float* strategy) {
+    if (!profile.frozen.empty()) {
+        if (!profile.frozen.getStrategy(infosetKey, actionCount, strategy)) {
+            uniformStrategy(actionCount, strategy);
+        }
+        return;
+    }
     
-    auto infosetIt = map.find(infosetKey);
-    if (infosetIt != map.end() && infosetIt->second.numActions == actionCount) {
+    auto infosetIt = profile.map.find(infosetKey);
+    if (infosetIt != profile.map.end() && infosetIt->second.numActions == actionCount) {
         // use learned average strategy for current game situation
         infosetIt->second.getAverageStrategy(strategy);
     } else {
         // fallback: uniform random over available actions
-        float u = 1.0f / actionCount;
-        for (int i = 0; i < actionCount; ++i) {
-            strategy[i] = u;
-        }
+        uniformStrategy(actionCount, strategy);
     }
-    
+}
+
+static int sampleFromStrategy(const float* strategy, int actionCount, float random01) {
     // sample action using cumulative probability
     float cumulativeProb = 0.0f;
     for (int i = 0; i < actionCount - 1; ++i) {
@@ -166,6 +192,20 @@ static int sampleAction(const StrategyIO::InfosetMap& map, const MCCFR::InfosetK
     return actionCount - 1;
 }
 
+// frozen profiles sample straight from the stored cumulative thresholds
+static int sampleAction(const StrategyProfile& profile, const MCCFR::InfosetKey& infosetKey, int actionCount, float random01) {
+    if (!profile.frozen.empty()) {
+        int chosen = profile.frozen.sampleAction(infosetKey, actionCount, random01);
+        if (chosen >= 0) {
+            return chosen;
+        }
+    }
+    
+    float strategy[MCCFR::MAX_ACTIONS];
+    getStrategy(profile, infosetKey, actionCount, strategy);
+    return sampleFromStrategy(strategy, actionCount, random01);
+}
+
 static const float* getAbstractSizes(const StrategyProfile& profile, int street) {
     switch (street) {
         case 1: 
@@ -187,12 +227,109 @@ inline int translateBetFraction(const float* abstractSizes,
     return PHM::translateBet(abstractSizes, numSizes, x, 1.0f, rng);
 }
 
+/*
+Showdown odds of player 0 for one deal, one entry per revealed street (1 = flop, 2 = turn, 3 = river).
+ - computed once per duplicate pair by enumerating the remaining board cards (both seatings share them)
+ - comparisons go through GameEngine::showdownWinner, so the odds match getPayoff exactly
+ - E[odds of street s+1 | street s] = odds of street s -> the chance corrections below have zero mean
+ */
+struct ShowdownOdds {
+    double win[4];
+    double tie[4];
+};
+
+static ShowdownOdds computeShowdownOdds(const std::array<int,2>& player0hand,
+                                        const std::array<int,2>& player1hand,
+                                        const std::array<int,5>& board) {
+    ShowdownOdds odds{};
+    
+    bool used[52] = {false};
+    used[player0hand[0]] = used[player0hand[1]] = true;
+    used[player1hand[0]] = used[player1hand[1]] = true;
+    for (int c : board) {
+        used[c] = true;
+    }
+    
+    // cards that are still unseen on the flop: the real turn & river are among them
+    int unseen[52];
+    int numUnseen = 0;
+    for (int c = 0; c < 52; ++c) {
+        if (!used[c] || c == board[3] || c == board[4]) {
+            unseen[numUnseen++] = c;
+        }
+    }
+    
+    std::array<int,5> runout = board;
+    
+    // flop: all unordered turn + river pairs
+    double wins = 0.0, ties = 0.0, total = 0.0;
+    for (int i = 0; i < numUnseen; ++i) {
+        for (int j = i + 1; j < numUnseen; ++j) {
+            runout[3] = unseen[i];
+            runout[4] = unseen[j];
+            int winner = GameEngine::showdownWinner(player0hand, player1hand, runout);
+            wins += (winner > 0);
+            ties += (winner == 0);
+            total += 1.0;
+        }
+    }
+    odds.win[1] = wins / total;
+    odds.tie[1] = ties / total;
+    
+    // turn: the real turn card, every river
+    wins = ties = total = 0.0;
+    runout[3] = board[3];
+    for (int i = 0; i < numUnseen; ++i) {
+        if (unseen[i] == board[3]) {
+            continue;
+        }
+        runout[4] = unseen[i];
+        int winner = GameEngine::showdownWinner(player0hand, player1hand, runout);
+        wins += (winner > 0);
+        ties += (winner == 0);
+        total += 1.0;
+    }
+    odds.win[2] = wins / total;
+    odds.tie[2] = ties / total;
+    
+    // river: the real result
+    int winner = GameEngine::showdownWinner(player0hand, player1hand, board);
+    odds.win[3] = (winner > 0) ? 1.0 : 0.0;
+    odds.tie[3] = (winner == 0) ? 1.0 : 0.0;
+    
+    return odds;
+}
+
+/*
+Baseline value of a state for player 0 in chips, given the board revealed up to `revealedStreet`.
+ - folds and completed showdowns return the exact payoff
+ - otherwise: expected showdown payoff of the current pot (win * pot + tie * split - contribution)
+ */
+static double stateValue(const MCCFRState& state,
+                         int revealedStreet,
+                         const ShowdownOdds& odds,
+                         const std::array<int,2>& player0hand,
+                         const std::array<int,2>& player1hand,
+                         const std::array<int,5>& board) {
+    if (state.foldedPlayer != -1 || (state.isTerminal && revealedStreet >= 3)) {
+        return GameEngine::getPayoff(state, player0hand, player1hand, board);
+    }
+    
+    int pot = state.player0Contribution + state.player1Contribution;
+    int split = pot / 2 + pot % 2; // odd chip to player 0, same as getPayoff
+    return odds.win[revealedStreet] * pot + odds.tie[revealedStreet] * split - state.player0Contribution;
+}
+
 /*
 Internal: Simulates one full poker hand and returns payoff for Player 0 in chips amount
  if the opponent's last bet was off-tree, PHM handles the case: search the bracketing abstract actions and sample one
  probabilistically before looking up the actor's strategy
  
  - returns P0 payoff
+ - odds != nullptr: also accumulates the AIVAT-style correction into `correction`
+   * action steps: V(chosen child) - sum_a pi(a) * V(child a), pi = the actor's effective (PHM-mixed) strategy
+   * chance steps: V(after the card) - V(before the card), the odds are a martingale so the expectation is exact
+   payoff - correction is an unbiased estimate of the same EV with most of the luck removed
  
  Note: assumption made - P1 payoff = -result
  */
@@ -202,10 +339,11 @@ static float playHand(const StrategyProfile& p0Profile, // strategy + bet abstra
                       const std::array<int,2>& player1hand,
                       const std::array<int,5>& board,
                       Bucketer::IsomorphismEngine& isoEngine,
-                      std::mt19937& random01) {
-    // converts random to float for action and pseudo-harmonic mapping
-    std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+                      CounterRNG::Stream& random01,
+                      const ShowdownOdds* odds,
+                      double& correction) {
     MCCFRState state = makeRoot();
+    correction = 0.0;
     
     // we keep playing until fold / showdown / all-in resolve
     while (!state.isTerminal) {
@@ -220,12 +358,19 @@ static float playHand(const StrategyProfile& p0Profile, // strategy + bet abstra
 
         const StrategyProfile& actor = *actorPointer;
         
-        // writes the bet sizes for current player into global bet configuration (used in bet sequencing)
-        applyConfig(actor);
-        // call bet sequencing module to get possible actions for this game moment
-        auto legalActions = BetAbstraction::getLegalActions(state);
+        // call bet sequencing module with the acting player's own bet sizes
+        auto legalActions = BetAbstraction::getLegalActions(state, actor.betConfig);
         const float* abstractBetSizes = getAbstractSizes(actor, state.street);
         
+        // acting player's bucket, PHM only rewrites the bet, so it is the same for the translated state
+        int32_t handBucket = getBucket(state, player0hand, player1hand, board, isoEngine);
+        MCCFR::InfosetKey infosetKey{state.historyHash, handBucket};
+        
+        // effective distribution over legalActions, only filled when corrections are requested
+        float effective[MCCFR::MAX_ACTIONS] = {0.0f};
+        int chosenIdx = 0;
+        bool translated = false;
+        
         // compute call amount, because if 0, we can skip pseudo-harmonic mapping
         int32_t chipsToCall = state.villainStreetBet - state.heroStreetBet;
         
@@ -251,8 +396,28 @@ static float playHand(const StrategyProfile& p0Profile, // strategy + bet abstra
             }
             
             if (!isOnTree) {
-               // if bet is off-tree, we need to kick in pseudo-harmonic mapping (PHM) module
-                float rngVal = dist(random01); // PHM needs random value to work
+                translated = true;
+                
+                // action count of the strategy as if the opponent bet was the abstract size at raiseActionIdx
+                // (a 'fake state', PHM-world logic, the infoset key itself does not change)
+                auto translatedCount = [&](int translatedIdx) {
+                    // fold and call/check are always the first two entries in the current list
+                    // PLEASE MIND: layout will break if bet sequence logic is overwritten
+                    int raiseActionIdx = 2 + translatedIdx;
+                    if (raiseActionIdx >= legalActions.count) {
+                        raiseActionIdx = legalActions.count - 1;
+                    }
+                    
+                    MCCFRState phmState = state;
+                    phmState.villainStreetBet = legalActions.actions[raiseActionIdx].amount;
+                    
+                    // need actions from the translated state to know the sizing of the strategy array
+                    auto translatedActions = BetAbstraction::getLegalActions(phmState, actor.betConfig);
+                    return static_cast<int>(translatedActions.count);
+                };
+                
+                // if bet is off-tree, we need to kick in pseudo-harmonic mapping (PHM) module
+                float rngVal = random01.uniform01(); // PHM needs random value to work
                 int translatedIdx = PHM::translateBet(
                     abstractBetSizes,
                     actor.numSizes,
@@ -261,46 +426,75 @@ static float playHand(const StrategyProfile& p0Profile, // strategy + bet abstra
                     rngVal
                 );
                 
-                // fold and call/check are always the first two entries in the current list
-                // PLEASE MIND: layout will break if bet sequence logic is overwritten
-                int raiseActionIdx = 2 + translatedIdx;
-                if (raiseActionIdx >= legalActions.count) {
-                    raiseActionIdx = legalActions.count - 1;
-                }
-                
-                // here I construct a 'fake state', to be able to query the strategy as if the opponent bet was abstract
-                MCCFRState phmState = state;
-                phmState.villainStreetBet = legalActions.actions[raiseActionIdx].amount;
-                
-                // run hand bucket query through LUT module and get infoset from MCCFR map
-                int32_t handBucket = getBucket(phmState, player0hand, player1hand, board, isoEngine);
-                MCCFR::InfosetKey infosetKey{phmState.historyHash, handBucket};
-                
-                // need actions from the translated state to know the sizing of the strategy array
-                auto translatedActions = BetAbstraction::getLegalActions(phmState);
-                
                 // get sample from average MCCFR strategy or uniform fallback case
-                int chosenIdx = sampleAction(actor.map, infosetKey, translatedActions.count, dist(random01));
+                chosenIdx = sampleAction(actor, infosetKey, translatedCount(translatedIdx), random01.uniform01());
+                // translated list can be longer than the real one (e.g. all-in slot collapses) -> last real action
+                chosenIdx = std::min(chosenIdx, legalActions.count - 1);
                 
-                // apply real action (devised by 'PHM-world' logic, executed in real-world)
-                BetAbstraction::AbstractAction physicalAction = legalActions.actions[chosenIdx];
-                
-                // apply action and advance game
-                state.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][chosenIdx];
-                state = GameEngine::applyAction(state, physicalAction);
-                continue;
+                if (odds) {
+                    // mix the strategies of both bracketing translations with their PHM weights
+                    int lowerIdx, higherIdx;
+                    float probLower;
+                    PHM::bracketBet(abstractBetSizes, actor.numSizes, opponentBetFraction, 1.0f,
+                                    lowerIdx, higherIdx, probLower);
+                    
+                    const int bracket[2] = {lowerIdx, higherIdx};
+                    const float weight[2] = {probLower, 1.0f - probLower};
+                    for (int b = 0; b < 2; ++b) {
+                        if (weight[b] <= 0.0f) {
+                            continue;
+                        }
+                        float bracketStrategy[MCCFR::MAX_ACTIONS];
+                        int count = translatedCount(bracket[b]);
+                        getStrategy(actor, infosetKey, count, bracketStrategy);
+                        for (int i = 0; i < count; ++i) {
+                            effective[std::min(i, legalActions.count - 1)] += weight[b] * bracketStrategy[i];
+                        }
+                    }
+                }
             }
         }
         
-        // if no PHM is needed, we construct a real state and sample directly from relevant strategy map
-        int32_t handBucket = getBucket(state, player0hand, player1hand, board, isoEngine);
-        MCCFR::InfosetKey infosetKey{state.historyHash, handBucket};
+        if (!translated) {
+            // if no PHM is needed, we sample directly from the real state's strategy
+            chosenIdx = sampleAction(actor, infosetKey, legalActions.count, random01.uniform01());
+            
+            if (odds) {
+                getStrategy(actor, infosetKey, legalActions.count, effective);
+            }
+        }
         
-        int chosenIdx = sampleAction(actor.map, infosetKey, legalActions.count, dist(random01));
+        // apply real action (for translated bets: devised by 'PHM-world' logic, executed in real-world)
         BetAbstraction::AbstractAction chosenAction = legalActions.actions[chosenIdx];
+        MCCFRState next = state;
+        next.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][chosenIdx];
+        next = GameEngine::applyAction(next, chosenAction);
+        
+        if (odds) {
+            // action correction: board stays at the current street, only the betting changes
+            int revealed = state.street;
+            double expected = 0.0;
+            double chosenValue = 0.0;
+            for (int i = 0; i < legalActions.count; ++i) {
+                MCCFRState child = (i == chosenIdx) ? next : GameEngine::applyAction(state, legalActions.actions[i]);
+                double value = stateValue(child, revealed, *odds, player0hand, player1hand, board);
+                expected += effective[i] * value;
+                if (i == chosenIdx) {
+                    chosenValue = value;
+                }
+            }
+            correction += chosenValue - expected;
+            
+            // chance corrections: one per card revealed after this action
+            // (street transition, or the rest of the board on an all-in / showdown)
+            int revealedAfter = next.isTerminal && next.foldedPlayer == -1 ? 3 : next.street;
+            for (int s = revealed; s < revealedAfter; ++s) {
+                correction += stateValue(next, s + 1, *odds, player0hand, player1hand, board)
+                            - stateValue(next, s, *odds, player0hand, player1hand, board);
+            }
+        }
         
-        state.historyHash ^= Zobrist::TABLE[state.street][state.currentPlayer][state.raiseCount][chosenIdx];
-        state = GameEngine::applyAction(state, chosenAction);
+        state = next;
     }
     // compute result
     int payoff = GameEngine::getPayoff(state, player0hand, player1hand, board);
@@ -309,73 +503,355 @@ static float playHand(const StrategyProfile& p0Profile, // strategy + bet abstra
     return static_cast<float>(payoff);
 }
 
+/*
+Duplicate score of A for one deal.
+ - returns the raw score, `corrected` receives the variance-reduced score (equal to raw when odds == nullptr)
+ */
 static float playDuplicatePair(const StrategyProfile& profileA,
                                const StrategyProfile& profileB,
                                const std::array<int,2>& player0hand,
                                const std::array<int,2>& player1hand,
                                const std::array<int,5>& board,
                                Bucketer::IsomorphismEngine& isoEngine,
-                               std::mt19937& random01) {
+                               CounterRNG::Stream& random01,
+                               const ShowdownOdds* odds,
+                               double& corrected) {
+    double correction1 = 0.0;
+    double correction2 = 0.0;
+    
     // Hand 1: A as P0, B as P1 — get A's payoff directly
-    float ev1 = playHand(profileA, profileB, player0hand, player1hand, board, isoEngine, random01);
+    float ev1 = playHand(profileA, profileB, player0hand, player1hand, board, isoEngine, random01, odds, correction1);
     
     // Hand 2: B as P0, A as P1
     // A's EV as P1 = -(P0's payoff) since zero-sum
-    float ev2 = -playHand(profileB, profileA, player0hand, player1hand, board, isoEngine, random01);
+    float ev2 = -playHand(profileB, profileA, player0hand, player1hand, board, isoEngine, random01, odds, correction2);
+    
+    // corrections are from P0's perspective -> flip the second one like the payoff
+    corrected = ((ev1 - correction1) + (ev2 + correction2)) * 0.5;
     
     // duplicate score: average of A's EV in both positions
     return (ev1 + ev2) * 0.5f;
 }
 
+// pairs per reduction block - fixed, so the summation tree never depends on thread count
+static constexpr int PAIRS_PER_BLOCK = 1024;
+
+// running statistics of one block of duplicate scores (Welford)
+struct BlockStats {
+    double count = 0.0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    
+    void add(double x) {
+        count += 1.0;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+    
+    // Chan et al. pairwise combination
+    void merge(const BlockStats& other) {
+        if (other.count == 0.0) {
+            return;
+        }
+        double total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
+    }
+    
+    double standardError() const {
+        return count > 0.0 ? std::sqrt((m2 / count) / count) : 0.0;
+    }
+};
+
+// per pair scores of a stratified match, accumulated in pair order after the blocks are played
+struct PairRecord {
+    double raw = 0.0;
+    double corrected = 0.0;
+    int stratum = 0;
+};
+
+/*
+Play the pairs of blocks [firstBlock, lastBlock) in parallel, writing one BlockStats per block.
+ - pair p always uses stream (seed, p), so the content of a block never depends on the thread that plays it
+ - with a sampler the deal comes from sampler->deal(p) (own salted stream) and every pair is also recorded
+ */
+static void playBlocks(const StrategyProfile& profileA,
+                       const StrategyProfile& profileB,
+                       Bucketer::IsomorphismEngine& isoEngine,
+                       int numPairs,
+                       uint64_t seed,
+                       int numThreads,
+                       bool varianceReduction,
+                       const DealSampler::Sampler* sampler,
+                       int firstBlock,
+                       int lastBlock,
+                       std::vector<BlockStats>& rawBlocks,
+                       std::vector<BlockStats>& correctedBlocks,
+                       std::vector<PairRecord>& records) {
+    
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(std::max(1, numThreads))
+    for (int b = firstBlock; b < lastBlock; ++b) {
+        int firstPair = b * PAIRS_PER_BLOCK;
+        int lastPair = std::min(numPairs, firstPair + PAIRS_PER_BLOCK);
+        
+        for (int p = firstPair; p < lastPair; ++p) {
+            // every pair owns its stream -> same deal & same action draws on any thread
+            CounterRNG::Stream random01(seed, static_cast<uint64_t>(p));
+            
+            std::array<int,2> player0hand;
+            std::array<int,2> player1hand;
+            std::array<int,5> board;
+            int stratum = 0;
+            
+            if (sampler) {
+                DealSampler::Deal deal = sampler->deal(static_cast<uint64_t>(p));
+                player0hand = deal.p0hand;
+                player1hand = deal.p1hand;
+                board = deal.board;
+                stratum = deal.stratum;
+            } else {
+                int deck[52];
+                for (int i = 0; i < 52; ++i) {
+                    deck[i] = i;
+                }
+                // partial Fisher-Yates: only shuffle first 9 cards
+                for (int i = 0; i < 9; ++i) {
+                    int j = random01.uniformInt(i, 51);
+                    std::swap(deck[i], deck[j]);
+                }
+                
+                player0hand = {deck[0], deck[1]};
+                player1hand = {deck[2], deck[3]};
+                board = {deck[4], deck[5], deck[6], deck[7], deck[8]};
+            }
+            
+            ShowdownOdds odds;
+            if (varianceReduction) {
+                odds = computeShowdownOdds(player0hand, player1hand, board);
+            }
+            
+            double corrected = 0.0;
+            float score = playDuplicatePair(profileA, profileB, player0hand, player1hand, board, isoEngine, random01,
+                                            varianceReduction ? &odds : nullptr, corrected);
+            rawBlocks[b].add(static_cast<double>(score));
+            correctedBlocks[b].add(corrected);
+            
+            if (sampler) {
+                records[p].raw = static_cast<double>(score);
+                records[p].corrected = corrected;
+                records[p].stratum = stratum;
+            }
+        }
+    }
+}
+
+/*
+Add pairs [firstPair, lastPair) to the stratified estimates, in pair order.
+ - antithetic deals are averaged per unit first (the two deals of a unit are not independent)
+ - units never straddle a block (PAIRS_PER_BLOCK is even), so batches add whole units
+ */
+static void addRecords(const DealSampler::Sampler& sampler,
+                       const std::vector<PairRecord>& records,
+                       int firstPair,
+                       int lastPair,
+                       DealSampler::StratifiedAccumulator& raw,
+                       DealSampler::StratifiedAccumulator& reduced) {
+    int unit = sampler.dealsPerUnit();
+    for (int first = firstPair; first < lastPair; first += unit) {
+        int last = std::min(lastPair, first + unit);
+        double rawSum = 0.0;
+        double correctedSum = 0.0;
+        for (int p = first; p < last; ++p) {
+            rawSum += records[p].raw;
+            correctedSum += records[p].corrected;
+        }
+        double size = static_cast<double>(last - first);
+        raw.add(records[first].stratum, rawSum / size);
+        reduced.add(records[first].stratum, correctedSum / size);
+    }
+}
+
+// stratified estimate in BlockStats form (m2 such that standardError() is the stratified one)
+static BlockStats toBlockStats(const DealSampler::StratifiedAccumulator& accumulator) {
+    BlockStats stats;
+    stats.count = static_cast<double>(accumulator.count());
+    stats.mean = accumulator.mean();
+    stats.m2 = accumulator.variance() * stats.count;
+    return stats;
+}
+
+static MatchResult makeResult(const BlockStats& raw, const BlockStats& reduced, bool varianceReduction, int bigBlind, int pairsPlayed) {
+    double chips_to_mbb = 1000.0 / static_cast<double>(bigBlind);
+    
+    MatchResult result;
+    result.mean_ev_mbb = static_cast<float>(raw.mean * chips_to_mbb);
+    result.std_error_mbb = static_cast<float>(raw.standardError() * chips_to_mbb);
+    result.confidence_95_mbb = static_cast<float>(1.96 * raw.standardError() * chips_to_mbb);
+    result.num_pairs = pairsPlayed;
+    result.total_hands = pairsPlayed * 2;
+    
+    result.variance_reduced = varianceReduction;
+    result.corrected_mean_ev_mbb = static_cast<float>(reduced.mean * chips_to_mbb);
+    result.corrected_std_error_mbb = static_cast<float>(reduced.standardError() * chips_to_mbb);
+    result.corrected_confidence_95_mbb = static_cast<float>(1.96 * reduced.standardError() * chips_to_mbb);
+    
+    result.stopped_early = false;
+    result.sequence_lower_mbb = 0.0f;
+    result.sequence_upper_mbb = 0.0f;
+    
+    return result;
+}
+
 MatchResult runMatch(const StrategyProfile& profileA,
                      const StrategyProfile& profileB,
                      Bucketer::IsomorphismEngine& isoEngine,
                      int numPairs,
                      int bigBlind,
-                     uint64_t seed) {
+                     uint64_t seed,
+                     int numThreads,
+                     bool varianceReduction,
+                     DealSampler::Mode sampling) {
+    
+    int numBlocks = (numPairs + PAIRS_PER_BLOCK - 1) / PAIRS_PER_BLOCK;
+    std::vector<BlockStats> rawBlocks(numBlocks);
+    std::vector<BlockStats> correctedBlocks(numBlocks);
+    
+    std::unique_ptr<DealSampler::Sampler> sampler;
+    std::vector<PairRecord> records;
+    if (sampling != DealSampler::Mode::Independent) {
+        sampler = std::make_unique<DealSampler::Sampler>(isoEngine, seed, sampling);
+        records.resize(numPairs);
+    }
+    
+    playBlocks(profileA, profileB, isoEngine, numPairs, seed, numThreads, varianceReduction, sampler.get(),
+               0, numBlocks, rawBlocks, correctedBlocks, records);
+    
+    // fixed-order reduction over blocks
+    BlockStats raw;
+    BlockStats reduced;
+    for (int b = 0; b < numBlocks; ++b) {
+        raw.merge(rawBlocks[b]);
+        reduced.merge(correctedBlocks[b]);
+    }
+    
+    if (sampler) {
+        DealSampler::StratifiedAccumulator stratifiedRaw(sampler->weights());
+        DealSampler::StratifiedAccumulator stratifiedReduced(sampler->weights());
+        addRecords(*sampler, records, 0, numPairs, stratifiedRaw, stratifiedReduced);
+        raw = toBlockStats(stratifiedRaw);
+        reduced = toBlockStats(stratifiedReduced);
+    }
+    
+    return makeResult(raw, reduced, varianceReduction, bigBlind, numPairs);
+}
+
+/*
+Half-width of the two-sided normal-mixture confidence sequence for a running mean.
+ -> Howard, Ramdas, McAuliffe & Sekhon (2021), "Time-uniform, nonparametric, nonasymptotic confidence sequences", Annals of Statistics
+ -> source: https://arxiv.org/abs/1810.08240
+ - n: pairs so far, variance: per-pair variance estimate, rho: mixture precision
+ - valid simultaneously over all n, so the bound may be checked after every batch without inflating the error rate
+ - variance is the running plug-in estimate (asymptotic sequence), fine at the pair counts we stop at
+ */
+static double mixtureRadius(double n, double variance, double rho, double alpha) {
+    double v = n * variance;
+    return std::sqrt((v + rho) * std::log((v + rho) / (rho * alpha * alpha))) / n;
+}
+
+MatchResult runMatchSequential(const StrategyProfile& profileA,
+                               const StrategyProfile& profileB,
+                               Bucketer::IsomorphismEngine& isoEngine,
+                               int maxPairs,
+                               int bigBlind,
+                               uint64_t seed,
+                               const SequentialOptions& options,
+                               int numThreads,
+                               bool varianceReduction,
+                               DealSampler::Mode sampling) {
+    
+    int numBlocks = (maxPairs + PAIRS_PER_BLOCK - 1) / PAIRS_PER_BLOCK;
+    std::vector<BlockStats> rawBlocks(numBlocks);
+    std::vector<BlockStats> correctedBlocks(numBlocks);
+    
+    std::unique_ptr<DealSampler::Sampler> sampler;
+    std::vector<PairRecord> records;
+    if (sampling != DealSampler::Mode::Independent) {
+        sampler = std::make_unique<DealSampler::Sampler>(isoEngine, seed, sampling);
+        records.resize(maxPairs);
+    }
+    DealSampler::StratifiedAccumulator stratifiedRaw(sampler ? sampler->weights() : std::vector<double>{1.0});
+    DealSampler::StratifiedAccumulator stratifiedReduced(sampler ? sampler->weights() : std::vector<double>{1.0});
+    
+    // batches are whole blocks -> the stopping point is the same for any thread count
+    int blocksPerBatch = std::max(1, options.batchPairs / PAIRS_PER_BLOCK);
+    int minBlocks = std::max(1, options.minPairs / PAIRS_PER_BLOCK);
     
-    std::mt19937 random01(seed);
+    double chips_to_mbb = 1000.0 / static_cast<double>(bigBlind);
+    double target = options.target_mbb / chips_to_mbb; // test in chips
     
-    float sum = 0.0f;
-    float sumSquared = 0.0f;
+    BlockStats raw;
+    BlockStats reduced;
+    double lower = 0.0;
+    double upper = 0.0;
+    bool stopped = false;
+    int playedBlocks = 0;
     
-    for (int p = 0; p < numPairs; ++p) {
-        int deck[52];
-        for (int i = 0; i < 52; ++i) {
-            deck[i] = i;
+    while (playedBlocks < numBlocks) {
+        int lastBlock = std::min(numBlocks, playedBlocks + blocksPerBatch);
+        playBlocks(profileA, profileB, isoEngine, maxPairs, seed, numThreads, varianceReduction, sampler.get(),
+                   playedBlocks, lastBlock, rawBlocks, correctedBlocks, records);
+        
+        for (int b = playedBlocks; b < lastBlock; ++b) {
+            raw.merge(rawBlocks[b]);
+            reduced.merge(correctedBlocks[b]);
         }
-        // partial Fisher-Yates: only shuffle first 9 cards
-        for (int i = 0; i < 9; ++i) {
-            std::uniform_int_distribution<int> dist(i, 51);
-            int j = dist(random01);
-            std::swap(deck[i], deck[j]);
+        if (sampler) {
+            addRecords(*sampler, records, playedBlocks * PAIRS_PER_BLOCK, std::min(maxPairs, lastBlock * PAIRS_PER_BLOCK),
+                       stratifiedRaw, stratifiedReduced);
         }
+        playedBlocks = lastBlock;
+        
+        // test the estimate that will be reported to the caller
+        BlockStats testedRaw = sampler ? toBlockStats(stratifiedRaw) : raw;
+        BlockStats testedReduced = sampler ? toBlockStats(stratifiedReduced) : reduced;
+        const BlockStats& tested = varianceReduction ? testedReduced : testedRaw;
+        double variance = tested.count > 1.0 ? tested.m2 / (tested.count - 1.0) : 0.0;
+        // tune the mixture so the sequence is tightest around tunePairs
+        double rho = std::max(variance, 1.0) * std::max(1, options.tunePairs);
+        double radius = mixtureRadius(tested.count, variance, rho, options.alpha);
+        lower = tested.mean - radius;
+        upper = tested.mean + radius;
         
-        std::array<int,2> player0hand = {deck[0], deck[1]};
-        std::array<int,2> player1hand = {deck[2], deck[3]};
-        std::array<int,5> board = {deck[4], deck[5], deck[6], deck[7], deck[8]};
+        if (options.verbose) {
+            fprintf(stderr, "[match] %d pairs: mean=%.2f mbb, sequence=[%.2f, %.2f] mbb, target=%.2f mbb\n",
+                    static_cast<int>(tested.count), tested.mean * chips_to_mbb,
+                    lower * chips_to_mbb, upper * chips_to_mbb, options.target_mbb);
+        }
         
-        float score = playDuplicatePair(profileA, profileB, player0hand, player1hand, board, isoEngine, random01);
+        if (playedBlocks < minBlocks) {
+            continue;
+        }
         
-        sum += score;
-        sumSquared += score * score;
+        // clearly worse than the target -> no point playing the rest
+        if (upper < target || (options.stopIfBetter && lower > target)) {
+            stopped = playedBlocks < numBlocks;
+            break;
+        }
     }
     
-    fprintf(stderr, "\n");
-    
-    float mean = sum / numPairs;
-    float variance = (sumSquared / numPairs) - (mean * mean);
-    float stddev = std::sqrt(variance > 0.0f ? variance : 0.0f);
-    float stderr_v = stddev / std::sqrt(static_cast<float>(numPairs));
-    
-    float chips_to_mbb = 1000.0f / static_cast<float>(bigBlind);
+    int pairsPlayed = static_cast<int>(raw.count);
+    if (sampler) {
+        raw = toBlockStats(stratifiedRaw);
+        reduced = toBlockStats(stratifiedReduced);
+    }
     
-    MatchResult result;
-    result.mean_ev_mbb = mean * chips_to_mbb;
-    result.std_error_mbb = stderr_v * chips_to_mbb;
-    result.confidence_95_mbb = 1.96f * stderr_v * chips_to_mbb;
-    result.num_pairs = numPairs;
-    result.total_hands = numPairs * 2;
+    MatchResult result = makeResult(raw, reduced, varianceReduction, bigBlind, pairsPlayed);
+    result.stopped_early = stopped;
+    result.sequence_lower_mbb = static_cast<float>(lower * chips_to_mbb);
+    result.sequence_upper_mbb = static_cast<float>(upper * chips_to_mbb);
     
     return result;
 }
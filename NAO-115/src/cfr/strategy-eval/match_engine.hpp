@@ -15,12 +15,34 @@ by Bard, N., Hawkin, J., Rubin, J., & Zinkevich, M. (2013). The Annual Computer
     - when a strategy faces an off-tree bet, PHM (pseudo-harmonic mapping)
     - translates it to a distribution over the two bracketing abstract actions
 
+Parallel execution:
+    - pairs are split into fixed-size blocks and spread over OpenMP threads
+    - every pair draws its cards and actions from its own counter-based stream keyed by (seed, pairIndex)
+    - block statistics (count, mean, M2) are kept in double and combined in block order
+    -> results are bit-identical for any thread count
+
+Deal sampling (optional, see deal_sampler.hpp):
+    - Independent: 9 uniform cards per pair from the pair's stream (default, reproduces earlier seeds)
+    - Stratified: flop texture stratified over the 1755 canonical flops, mean and standard error are the
+      stratified ones (antithetic units are averaged before accumulating)
+
+Variance reduction (optional, AIVAT-style control variates):
+    -> Burch, N., Schmid, M., Moravcik, M., Morrill, D., & Bowling, M. (2018). AIVAT: A New Variance Reduction Technique for Agent Evaluation in Imperfect Information Games. AAAI.
+    -> source: https://arxiv.org/abs/1612.06915
+    - both strategies are known, so at every decision the actor's full (PHM-mixed) distribution is available
+    - baseline value of a state = player 0's showdown odds (enumerated over the unseen board) applied to the current pot
+    - action correction: V(chosen child) - E_pi[V(child)], chance correction: V(after card) - E[V(after card)]
+    - every correction has zero mean, so payoff - corrections is unbiased with a much smaller variance
+    - costs one board enumeration (~1000 runouts) per duplicate pair
+
 Result:
     - returns mean EV of Strategy A vs Strategy B in mbb/hand, plus standard error for confidence intervals
     - Positive mean_ev means A outperforms B
  */
 
 #include "strategy_io.hpp"
+#include "frozen_strategy.hpp"
+#include "cfr/utils/deal_sampler.hpp"
 #include "bet-abstraction/bet_utils.hpp"
 #include "hand-bucketing/bucketer.hpp"
 #include "hand-bucketing/mapping_engine.hpp"
@@ -31,6 +53,9 @@ namespace MatchEngine {
 
 struct StrategyProfile {
     StrategyIO::InfosetMap map;
+    
+    // play-time table, used instead of map when not empty (see freezeProfile)
+    FrozenStrategy::Table frozen;
 
     // player's bet abstraction (pot fractions), used for action translation
     float flop[3];
@@ -38,10 +63,8 @@ struct StrategyProfile {
     float river[3];
     int numSizes = 3;
 
-    // integer ratios for g_betConfig — set before getLegalActions
-    int32_t flop_n[3],  flop_d[3];
-    int32_t turn_n[3],  turn_d[3];
-    int32_t river_n[3], river_d[3];
+    // integer ratios passed to getLegalActions (each profile carries its own abstraction)
+    BetAbstraction::BetConfig betConfig;
 };
 
 struct MatchResult {
@@ -50,6 +73,34 @@ struct MatchResult {
     float confidence_95_mbb; // 95% confidence interval half-width (mean ± this)
     int   num_pairs;         // number of duplicate pairs played
     int   total_hands;       // num_pairs * 2
+    
+    // variance-reduced estimate (only meaningful when variance_reduced == true, otherwise equals the raw one)
+    bool  variance_reduced;
+    float corrected_mean_ev_mbb;
+    float corrected_std_error_mbb;
+    float corrected_confidence_95_mbb;
+    
+    // sequential mode only (runMatchSequential)
+    bool  stopped_early;      // true if the match ended before maxPairs
+    float sequence_lower_mbb; // always-valid confidence sequence at the stopping point
+    float sequence_upper_mbb;
+};
+
+/*
+Settings of the sequential (early-stopping) match mode.
+ - the match is played in batches, after each batch an always-valid confidence sequence on A's EV is checked
+ - stops as soon as the upper bound drops below target_mbb (A is clearly worse than the target)
+ - with stopIfBetter also stops when the lower bound rises above target_mbb
+ - sizes are rounded down to whole reduction blocks (1024 pairs), so the stopping point is reproducible
+ */
+struct SequentialOptions {
+    float target_mbb = 0.0f;   // EV of A that a candidate has to be able to reach
+    float alpha = 0.05f;       // error probability over the whole sequence
+    int   batchPairs = 16384;  // pairs between two checks
+    int   minPairs = 32768;    // never stop before this many pairs
+    int   tunePairs = 50000;   // pair count where the sequence is tightest
+    bool  stopIfBetter = false;
+    bool  verbose = false;     // one stderr line per batch (pairs, mean, sequence bounds)
 };
 
 /*
@@ -57,6 +108,9 @@ Run a head-to-head match between two strategies using duplicate poker.
  - profileA, profileB: two competing strategies with their bet configs
  - numPairs: number of duplicate pairs (2 hands per pair)
  - seed: RNG seed for reproducibility
+ - numThreads: OpenMP threads used to play pairs (result does not depend on it)
+ - varianceReduction: also compute the AIVAT-style corrected estimate (raw estimate is unchanged)
+ - sampling: deal sampling scheme, stratified modes report the stratified mean / standard error
  - returns: MatchResult (positive mean_ev_mbb ->> A beats B)
  */
 
@@ -66,12 +120,54 @@ MatchResult runMatch(
     Bucketer::IsomorphismEngine& isoEngine,
     int numPairs,
     int bigBlind,
-    uint64_t seed
+    uint64_t seed,
+    int numThreads = 1,
+    bool varianceReduction = false,
+    DealSampler::Mode sampling = DealSampler::Mode::Independent
+);
+
+/*
+Same as runMatch, but plays in batches and may stop early (see SequentialOptions).
+ - maxPairs: upper limit of duplicate pairs, the first pairs are identical to runMatch with the same seed
+ - the estimate that is tested is the corrected one when varianceReduction is on
+ - num_pairs in the result is the number of pairs actually played
+ */
+MatchResult runMatchSequential(
+    const StrategyProfile& profileA,
+    const StrategyProfile& profileB,
+    Bucketer::IsomorphismEngine& isoEngine,
+    int maxPairs,
+    int bigBlind,
+    uint64_t seed,
+    const SequentialOptions& options,
+    int numThreads = 1,
+    bool varianceReduction = false,
+    DealSampler::Mode sampling = DealSampler::Mode::Independent
 );
 
+/*
+Freeze the profile's map into a compact play-time table and release the map.
+ - lookups become pre-normalized, sampling uses cumulative thresholds
+ - precision: Float32 keeps the exact strategy, UInt16 / UInt8 trade accuracy (1/65535, 1/255) for size
+ */
+void freezeProfile(StrategyProfile& profile,
+                   FrozenStrategy::Precision precision = FrozenStrategy::Precision::UInt16);
+
+// same, straight from a sharded load (StrategyIO::loadSharded), the profile's map stays empty
+void freezeProfile(StrategyProfile& profile,
+                   const StrategyIO::ShardedMap& shards,
+                   FrozenStrategy::Precision precision = FrozenStrategy::Precision::UInt16);
+
+/*
+Point the profile at a table file written by FrozenStrategy::saveMapped.
+ - zero-copy: the file is memory mapped and queried in place, no decompression, no map
+ - returns false (profile unchanged) if the file cannot be mapped
+ */
+bool mapProfile(StrategyProfile& profile, const std::string& path);
+
 /*
 Build a StrategyProfile from a loaded map and bet size fractions
-(converts float fractions to integer ratios for g_betConfig)
+(converts float fractions to the integer ratios of the profile's BetConfig)
  */
 StrategyProfile buildProfile(
     StrategyIO::InfosetMap map,
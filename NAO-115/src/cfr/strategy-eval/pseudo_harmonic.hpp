@@ -67,13 +67,18 @@ inline float mappingProbability(float lowerBet, float higherBet, float realSize)
 }
 
 /*
-Given an opponent's bet in chips and the current pot, find the bracketing abstract actions and sample one using PHM function
- - returns index into abstractSizes of the chosen abstract action.
+Find the bracketing abstract actions of an opponent bet and the PHM probability of the lower one.
+ - lowerIndex / higherIndex: indices into abstractBetSizes (equal when no randomization is needed)
+ - probLower: probability of mapping to lowerIndex (1 - probLower goes to higherIndex)
+ - returns false if there are no abstract sizes
+ Used directly when the full translated distribution is needed (variance reduction in the match engine).
  */
-
-inline int translateBet(const float* abstractBetSizes, int numberOfBetSizes, float villainBet,float potSize, float random01) {
+inline bool bracketBet(const float* abstractBetSizes, int numberOfBetSizes, float villainBet, float potSize,
+                       int& lowerIndex, int& higherIndex, float& probLower) {
     if (numberOfBetSizes <= 0) {
-        return -1;
+        lowerIndex = higherIndex = -1;
+        probLower = 1.0f;
+        return false;
     }
     #ifndef NDEBUG
     for (int i = 1; i < numberOfBetSizes; ++i) {
@@ -81,57 +86,79 @@ inline int translateBet(const float* abstractBetSizes, int numberOfBetSizes, flo
     }
     #endif
     
-    // clamp random number to 0-1
-    if (random01 < 0.0f) {
-        random01 = 0.0f;
-    }
-    
-    if (random01 >= 1.0f) {
-        random01 = 0.999999f;
-    }
+    probLower = 1.0f;
     
     // invalid pot, fallback to largest size
     if (potSize <= 0.0f) {
-        return numberOfBetSizes - 1;
+        lowerIndex = higherIndex = numberOfBetSizes - 1;
+        return true;
     }
 
     float betFraction = villainBet / potSize;
 
     // find bracketing abstract actions
-    int lowerIndex = -1;
-    int higherIndex = -1;
+    int lower = -1;
+    int higher = -1;
 
     for (int i = 0; i < numberOfBetSizes; ++i) {
         if (abstractBetSizes[i] <= betFraction) {
-            lowerIndex = i;
+            lower = i;
         }
 
-        if (abstractBetSizes[i] >= betFraction && higherIndex == -1) {
-            higherIndex = i;
+        if (abstractBetSizes[i] >= betFraction && higher == -1) {
+            higher = i;
         }
     }
 
     // if it's below abstraction, it's mapped to the smallest
-    if (lowerIndex == -1) {
-        return 0;
+    if (lower == -1) {
+        lowerIndex = higherIndex = 0;
+        return true;
     }
 
     // if it's above abstraction, it's mapped to the largest
-    if (higherIndex == -1) {
-        return numberOfBetSizes - 1;
+    if (higher == -1) {
+        lowerIndex = higherIndex = numberOfBetSizes - 1;
+        return true;
     }
 
+    lowerIndex = lower;
+    higherIndex = higher;
+    
     // if it's an exact match, randomness is not needed
-    if (lowerIndex == higherIndex) {
-        return lowerIndex;
+    if (lower == higher) {
+        return true;
     }
 
-    // PHM: sampling between lower and upper bets
-    float lowerBet = abstractBetSizes[lowerIndex];
-    float higherBet = abstractBetSizes[higherIndex];
-    float probLower = mappingProbability(lowerBet, higherBet, betFraction);
+    // PHM: probability of the lower bracket
+    probLower = mappingProbability(abstractBetSizes[lower], abstractBetSizes[higher], betFraction);
+    return true;
+}
+
+/*
+Given an opponent's bet in chips and the current pot, find the bracketing abstract actions and sample one using PHM function
+ - returns index into abstractSizes of the chosen abstract action.
+ */
 
-    if (random01 < probLower) {
+inline int translateBet(const float* abstractBetSizes, int numberOfBetSizes, float villainBet,float potSize, float random01) {
+    // clamp random number to 0-1
+    if (random01 < 0.0f) {
+        random01 = 0.0f;
+    }
+    
+    if (random01 >= 1.0f) {
+        random01 = 0.999999f;
+    }
+    
+    int lowerIndex = -1;
+    int higherIndex = -1;
+    float probLower = 1.0f;
+    
+    if (!bracketBet(abstractBetSizes, numberOfBetSizes, villainBet, potSize, lowerIndex, higherIndex, probLower)) {
+        return -1;
+    }
+    
+    if (lowerIndex == higherIndex || random01 < probLower) {
         return lowerIndex;
     }
     
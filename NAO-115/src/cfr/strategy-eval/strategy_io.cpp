@@ -1,9 +1,17 @@
 #include "strategy_io.hpp"
+#include "cfr/cfr-core/mccfr_multithread.hpp"
 #include <zlib.h>
+#include <omp.h>
+#include <algorithm>
 #include <cstdio>
 #include <cstring>
 #include <cstdlib>
+#include <exception>
+#include <future>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
+#include <unistd.h>
 
 namespace StrategyIO {
 /*
@@ -43,245 +51,827 @@ struct PlayEntry {
 };
 static_assert(sizeof(PlayEntry) == 8 + 4 + 24 + 1, "Play Entry must be 37 bytes");
 
+// v3 (chunked) file header, stored uncompressed at offset 0
+struct ChunkedHeader {
+    uint64_t fileMagic; // CHUNKED_FILE_MAGIC, never a plausible v2 size prefix
+    uint32_t magic; // MAGIC
+    uint32_t version; // VERSION_CHUNKED
+    uint64_t numEntries; // number of infosets
+    uint32_t flags; // mode + compression flags
+    uint32_t numShards; // NUM_SHARDS at write time
+    uint32_t numChunks;
+    uint64_t indexOffset; // file offset of ChunkIndexEntry x numChunks
+};
+static_assert(sizeof(ChunkedHeader) == 44, "Chunked Header must be 44 bytes");
+
+struct ChunkIndexEntry {
+    uint32_t shard;
+    uint32_t numEntries;
+    uint64_t offset; // file offset of the zlib stream
+    uint64_t compressedSize;
+};
+static_assert(sizeof(ChunkIndexEntry) == 24, "Chunk Index Entry must be 24 bytes");
+
 #pragma pack(pop)
 
 
-/* 
-Internal: Compress & Write (compresses raw serialized buffer, writes it to disk)
+/*
+Internal: streaming zlib file writer
  
  File layout:
  [uint64_t originalSize]
- [compressed payload]
+ [zlib stream]
  
- - the size prefix is required for zlib decompression
- - this function does not understand poker logic
- - used by both full and play-only saves
-
+ - the size prefix is known before serialization (header + N fixed size entries), written first
+ - payload goes through deflate in fixed size chunks -> the whole stream is the same as one compress2 call,
+   files stay readable by older builds and vice versa
+ - this class does not understand poker logic
  */
+static constexpr size_t STREAM_CHUNK_BYTES = size_t(4) << 20;
 
-static bool writeZlibInfosets(const std::string& path, const void* buffer, size_t size) {
-    uLongf compressedSize = compressBound(static_cast<uLong>(size));
-    std::vector<Bytef> compressed(compressedSize);
+class DeflateWriter {
+public:
+    DeflateWriter() : output(STREAM_CHUNK_BYTES) {}
     
-    int ret = compress2(
-                        compressed.data(), &compressedSize,
-                        static_cast<const Bytef*>(buffer), static_cast<uLong>(size),
-                        Z_BEST_SPEED
-                        );
-    
-    if (ret != Z_OK) {
-        fprintf(stderr, "StrategyIO: zlib compress failed (%d)\n", ret);
-        return false;
+    ~DeflateWriter() {
+        if (initialized) deflateEnd(&stream);
+        if (file) fclose(file);
     }
     
-    FILE* f = fopen(path.c_str(), "wb");
-    if (!f) {
-        fprintf(stderr, "StrategyIO: cannot open %s\n", path.c_str());
-        return false;
-    }
+    DeflateWriter(const DeflateWriter&) = delete;
+    DeflateWriter& operator=(const DeflateWriter&) = delete;
     
-    uint64_t originalSize = static_cast<uint64_t>(size);
+    bool open(const std::string& path, uint64_t originalSize) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) {
+            fprintf(stderr, "StrategyIO: cannot open %s\n", path.c_str());
+            return false;
+        }
+        
+        if (fwrite(&originalSize, sizeof(originalSize), 1, file) != 1) {
+            fprintf(stderr, "StrategyIO: failed to write size header\n");
+            return false;
+        }
+        
+        int ret = deflateInit(&stream, Z_BEST_SPEED);
+        if (ret != Z_OK) {
+            fprintf(stderr, "StrategyIO: zlib deflateInit failed (%d)\n", ret);
+            return false;
+        }
+        initialized = true;
+        return true;
+    }
     
-    if (fwrite(&originalSize, sizeof(originalSize), 1, f) != 1) {
-        fprintf(stderr, "StrategyIO: failed to write size header\n");
-        fclose(f);
-        return false;
+    bool write(const uint8_t* data, size_t size) {
+        stream.next_in = const_cast<Bytef*>(data);
+        stream.avail_in = static_cast<uInt>(size);
+        return pump(Z_NO_FLUSH);
     }
     
-    if (fwrite(compressed.data(), 1, compressedSize, f) != compressedSize) {
-        fprintf(stderr, "StrategyIO: failed to write compressed data\n");
-        fclose(f);
-        return false;
+    // flushes the end of the stream and closes the file
+    bool finish() {
+        stream.next_in = nullptr;
+        stream.avail_in = 0;
+        if (!pump(Z_FINISH)) return false;
+        
+        int closed = fclose(file);
+        file = nullptr;
+        if (closed != 0) {
+            fprintf(stderr, "StrategyIO: failed to close file\n");
+            return false;
+        }
+        return true;
     }
     
-    fclose(f);
-    return true;
-}
+private:
+    FILE* file = nullptr;
+    z_stream stream{};
+    bool initialized = false;
+    std::vector<Bytef> output;
+    
+    // runs deflate until the input is consumed (or the stream ends), writing every filled output chunk
+    bool pump(int flush) {
+        int ret;
+        do {
+            stream.next_out = output.data();
+            stream.avail_out = static_cast<uInt>(output.size());
+            ret = deflate(&stream, flush);
+            if (ret == Z_STREAM_ERROR) {
+                fprintf(stderr, "StrategyIO: zlib compress failed (%d)\n", ret);
+                return false;
+            }
+            
+            size_t produced = output.size() - stream.avail_out;
+            if (produced > 0 && fwrite(output.data(), 1, produced, file) != produced) {
+                fprintf(stderr, "StrategyIO: failed to write compressed data\n");
+                return false;
+            }
+        } while (stream.avail_out == 0 || (flush == Z_FINISH && ret != Z_STREAM_END));
+        return true;
+    }
+};
 
 /*
- Internal: Reads and decompresses a saved Nao strategy file, buffer is later parsed into infosets by load()
+ Internal: streaming reader for saved Nao strategy files, load() pulls fixed size records from it
 
  File layout:
  [ uint64_t originalSize ]
  [ zlib compressed blob ]
+ 
+ - compressed input and decompressed output are both buffered in STREAM_CHUNK_BYTES chunks,
+   memory use does not depend on the file size
  */
-static bool readZlibInfosets(const std::string& path, std::vector<uint8_t>& outData) {
+class InflateReader {
+public:
+    InflateReader() : input(STREAM_CHUNK_BYTES), output(STREAM_CHUNK_BYTES) {}
     
-    FILE* f = fopen(path.c_str(), "rb");
-    if (!f) {
-        fprintf(stderr, "StrategyIO: cannot open %s for reading\n", path.c_str());
-        return false;
+    ~InflateReader() {
+        if (initialized) inflateEnd(&stream);
+        if (file) fclose(file);
     }
     
-    uint64_t uncompressedSize;
-    if (fread(&uncompressedSize, sizeof(uncompressedSize), 1, f) != 1) {
-        fprintf(stderr, "StrategyIO: failed to read size header from %s\n", path.c_str());
-        fclose(f);
-        return false;
-    }
+    InflateReader(const InflateReader&) = delete;
+    InflateReader& operator=(const InflateReader&) = delete;
     
-    fseek(f, 0, SEEK_END);
-    long fileSize = ftell(f);
-    if (fileSize < 0) {
-        fprintf(stderr, "StrategyIO: ftell failed for %s\n", path.c_str());
-        fclose(f);
-        return false;
+    bool open(const std::string& path) {
+        file = fopen(path.c_str(), "rb");
+        if (!file) {
+            fprintf(stderr, "StrategyIO: cannot open %s for reading\n", path.c_str());
+            return false;
+        }
+        
+        if (fread(&uncompressedSize, sizeof(uncompressedSize), 1, file) != 1) {
+            fprintf(stderr, "StrategyIO: failed to read size header from %s\n", path.c_str());
+            return false;
+        }
+        
+        int ret = inflateInit(&stream);
+        if (ret != Z_OK) {
+            fprintf(stderr, "StrategyIO: zlib inflateInit failed (%d)\n", ret);
+            return false;
+        }
+        initialized = true;
+        return true;
     }
     
-    fseek(f, sizeof(uint64_t), SEEK_SET);
-    size_t compressedSize = fileSize - sizeof(uint64_t);
+    uint64_t rawSize() const { return uncompressedSize; }
     
-    std::vector<uint8_t> compressedBlob(compressedSize);
-    if (fread(compressedBlob.data(), 1, compressedSize, f) != compressedSize) {
-        fprintf(stderr, "StrategyIO: read error in %s\n", path.c_str());
-        fclose(f);
-        return false;
+    // copies the next size decompressed bytes, false if the stream ends first or is corrupted
+    bool read(void* destination, size_t size) {
+        uint8_t* writePointer = static_cast<uint8_t*>(destination);
+        while (size > 0) {
+            if (outputPosition == outputEnd && !refill()) return false;
+            
+            size_t available = std::min(size, outputEnd - outputPosition);
+            memcpy(writePointer, output.data() + outputPosition, available);
+            writePointer += available;
+            outputPosition += available;
+            size -= available;
+        }
+        return true;
     }
     
-    fclose(f);
+private:
+    FILE* file = nullptr;
+    z_stream stream{};
+    bool initialized = false;
+    bool streamEnded = false;
+    uint64_t uncompressedSize = 0;
+    std::vector<Bytef> input;
+    std::vector<Bytef> output;
+    size_t outputPosition = 0;
+    size_t outputEnd = 0;
     
-    outData.resize(uncompressedSize);
-    uLongf destLen = static_cast<uLongf>(uncompressedSize);
+    // decompresses the next chunk, false at the end of the stream or on error
+    bool refill() {
+        outputPosition = 0;
+        outputEnd = 0;
+        if (streamEnded) return false;
+        
+        stream.next_out = output.data();
+        stream.avail_out = static_cast<uInt>(output.size());
+        
+        while (stream.avail_out == output.size()) {
+            if (stream.avail_in == 0) {
+                size_t got = fread(input.data(), 1, input.size(), file);
+                if (got == 0) {
+                    fprintf(stderr, "StrategyIO: truncated zlib stream\n");
+                    return false;
+                }
+                stream.next_in = input.data();
+                stream.avail_in = static_cast<uInt>(got);
+            }
+            
+            int ret = inflate(&stream, Z_NO_FLUSH);
+            if (ret == Z_STREAM_END) {
+                streamEnded = true;
+                break;
+            }
+            if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                fprintf(stderr, "StrategyIO: zlib decompress failed (%d)\n", ret);
+                return false;
+            }
+        }
+        
+        outputEnd = output.size() - stream.avail_out;
+        return outputEnd > 0;
+    }
+};
+
+/*
+ Internal: entry conversion for the two save modes
+ 
+ Full entries store:
+  - regretSum   → used to update strategy during training
+  - strategySum → accumulated strategy for averaging
+ 
+ Play entries store strategySum only:
+  - NOT suitable for resuming training (regretSum is not present)
+  - used for head-to-head matches, BO evaluation, exporting strategies for play
+ */
+static FullEntry makeFullEntry(const MCCFR::InfosetKey& key, const MCCFR::Infoset& infoset) {
+    FullEntry entry{};
+    entry.historyHash = key.historyHash;
+    entry.bucketId = key.bucketId;
     
-    int ret = uncompress(outData.data(), &destLen, compressedBlob.data(), static_cast<uLong>(compressedSize));
+    if (infoset.numActions < 2 || infoset.numActions > MCCFR::MAX_ACTIONS) {
+        throw std::runtime_error("StrategyIO: invalid numActions");
+    }
     
-    if (ret != Z_OK || destLen != uncompressedSize) {
-        fprintf(stderr, "StrategyIO: zlib decompress failed or size mismatch\n");
-        return false;
+    entry.numActions = infoset.numActions;
+    
+    for (int i = 0; i < MCCFR::MAX_ACTIONS; ++i) {
+        entry.regretSum[i] = infoset.regretSum[i];
+        entry.strategySum[i] = infoset.strategySum[i];
+    }
+    return entry;
+}
+
+static PlayEntry makePlayEntry(const MCCFR::InfosetKey& key, const MCCFR::Infoset& infoset) {
+    PlayEntry entry{};
+    entry.historyHash = key.historyHash;
+    entry.bucketId = key.bucketId;
+    if (infoset.numActions < 2 || infoset.numActions > MCCFR::MAX_ACTIONS) {
+        throw std::runtime_error("StrategyIO: invalid numActions");
     }
     
-    return true;
+    entry.numActions = infoset.numActions;
+    for (int i = 0; i < MCCFR::MAX_ACTIONS; ++i) {
+        entry.strategySum[i] = infoset.strategySum[i];
+    }
+    return entry;
 }
 
 /*
- Internal: Serializes full MCCFR state (training snapshot)
- 
- Each infoset stores:
-  - regretSum   → used to update strategy during training
-  - strategySum → accumulated strategy for averaging
+ Internal: serializes and writes a map in chunks
  
 Layout:
  [ Header ]
- [ FullEntry x N]
-
- Note:
-  - preserves complete solver state
-  - larger than play-only mode
+ [ Entry x N ]
+ 
+ Double buffered: while chunk k is compressed and written, chunk k + 1 is serialized on a second thread
+  -> peak extra memory is 2 input chunks + 1 compressed chunk instead of ~3x the table size
  */
-static std::vector<uint8_t> serializeFullInfosets(const InfosetMap& map) {
-    
-    if (map.size() > (SIZE_MAX - sizeof(Header)) / sizeof(FullEntry)) {
+template <typename Entry, typename MakeEntry>
+static bool writeZlibInfosets(const InfosetMap& map, const std::string& path, uint32_t flags, MakeEntry makeEntry) {
+    if (map.size() > (SIZE_MAX - sizeof(Header)) / sizeof(Entry)) {
         throw std::runtime_error("StrategyIO: buffer size overflow");
     }
+    const uint64_t totalSize = sizeof(Header) + map.size() * sizeof(Entry);
     
-    const size_t totalSize = sizeof(Header) + map.size() * sizeof(FullEntry);
-    std::vector<uint8_t> buffer(totalSize);
+    DeflateWriter writer;
+    if (!writer.open(path, totalSize)) return false;
     
-    uint8_t* writePointer = buffer.data();
+    auto iterator = map.begin();
+    auto fill = [&](std::vector<uint8_t>& chunk) {
+        while (iterator != map.end() && chunk.size() + sizeof(Entry) <= STREAM_CHUNK_BYTES) {
+            Entry entry = makeEntry(iterator->first, iterator->second);
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&entry);
+            chunk.insert(chunk.end(), bytes, bytes + sizeof(entry));
+            ++iterator;
+        }
+    };
+    
+    std::vector<uint8_t> current;
+    std::vector<uint8_t> next;
+    current.reserve(STREAM_CHUNK_BYTES);
+    next.reserve(STREAM_CHUNK_BYTES);
     
     Header header{};
     header.magic = MAGIC;
     header.version = VERSION;
     header.numEntries = map.size();
-    header.flags = FLAG_COMPRESSED_ZLIB; // full mode (no play-only flag)
-    memcpy(writePointer, &header, sizeof(header));
-    writePointer += sizeof(header);
+    header.flags = flags;
+    const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+    current.insert(current.end(), headerBytes, headerBytes + sizeof(header));
+    fill(current);
     
-    for (const auto& [key, infoset] : map) {
-        FullEntry entry{};
-        entry.historyHash = key.historyHash;
-        entry.bucketId = key.bucketId;
+    while (!current.empty()) {
+        auto pending = std::async(std::launch::async, [&] {
+            next.clear();
+            fill(next);
+        });
         
-        if (infoset.numActions < 2 || infoset.numActions > MCCFR::MAX_ACTIONS) {
-            throw std::runtime_error("StrategyIO: invalid numActions");
+        bool written = writer.write(current.data(), current.size());
+        pending.get(); // rethrows serialization errors
+        if (!written) return false;
+        
+        std::swap(current, next);
+    }
+    
+    return writer.finish();
+}
+
+/*
+ Internal: entry -> infoset conversion for both modes, false on invalid data
+ */
+static bool decodeEntry(const FullEntry& entry, MCCFR::InfosetKey& key, MCCFR::Infoset& infoset) {
+    key = MCCFR::InfosetKey{entry.historyHash, entry.bucketId};
+    infoset = MCCFR::Infoset{};
+    if (entry.numActions < 2 || entry.numActions > MCCFR::MAX_ACTIONS) {
+        fprintf(stderr, "StrategyIO: invalid action count (%u) in infoset\n", entry.numActions);
+        return false;
+    }
+    
+    infoset.numActions = entry.numActions;
+    for (int j = 0; j < MCCFR::MAX_ACTIONS; ++j) {
+        infoset.regretSum[j]   = entry.regretSum[j];
+        infoset.strategySum[j] = entry.strategySum[j];
+    }
+    return true;
+}
+
+static bool decodeEntry(const PlayEntry& entry, MCCFR::InfosetKey& key, MCCFR::Infoset& infoset) {
+    key = MCCFR::InfosetKey{entry.historyHash, entry.bucketId};
+    infoset = MCCFR::Infoset{};
+    if (entry.numActions < 2 || entry.numActions > MCCFR::MAX_ACTIONS) {
+        fprintf(stderr, "StrategyIO: invalid numActions (%u)\n", entry.numActions);
+        return false;
+    }
+    infoset.numActions = entry.numActions;
+    for (int j = 0; j < MCCFR::MAX_ACTIONS; ++j) {
+        infoset.strategySum[j] = entry.strategySum[j];
+        infoset.regretSum[j] = 0.0f; // not saved in play mode
+    }
+    return true;
+}
+
+// v2: entries are pulled one by one from the inflate stream (shard >= 0 keeps only that shard's entries)
+template <typename Entry>
+static bool readStreamEntries(InflateReader& reader, InfosetMap& outInfosets, size_t numEntries, const char* label,
+                              int64_t shard = -1) {
+    for (size_t i = 0; i < numEntries; ++i) {
+        Entry entry{};
+        if (!reader.read(&entry, sizeof(entry))) {
+            fprintf(stderr, "StrategyIO: truncated file (%s entry %zu)\n", label, i);
+            return false;
         }
         
-        entry.numActions = infoset.numActions;
+        MCCFR::InfosetKey key;
+        MCCFR::Infoset infoset;
+        if (!decodeEntry(entry, key, infoset)) return false;
+        if (shard >= 0 && shardOf(key) != static_cast<uint32_t>(shard)) continue;
+        outInfosets[key] = infoset;
+    }
+    return true;
+}
+
+// v3: entries of one decompressed chunk
+template <typename Entry>
+static bool insertChunkEntries(InfosetMap& outInfosets, const uint8_t* raw, size_t numEntries) {
+    for (size_t i = 0; i < numEntries; ++i) {
+        Entry entry;
+        memcpy(&entry, raw + i * sizeof(Entry), sizeof(Entry));
         
-        for (int i = 0; i < MCCFR::MAX_ACTIONS; ++i) {
-            entry.regretSum[i] = infoset.regretSum[i];
-            entry.strategySum[i] = infoset.strategySum[i];
+        MCCFR::InfosetKey key;
+        MCCFR::Infoset infoset;
+        if (!decodeEntry(entry, key, infoset)) return false;
+        outInfosets[key] = infoset;
+    }
+    return true;
+}
+
+static bool validateHeader(uint32_t magic, uint32_t version, uint32_t expectedVersion, uint32_t flags, const std::string& path) {
+    if (magic != MAGIC) {
+        fprintf(stderr, "StrategyIO: bad magic in %s (got 0x%X expected 0x%X)\n",
+                path.c_str(), magic, MAGIC);
+        return false;
+    }
+    
+    if (version != expectedVersion) {
+        fprintf(stderr, "StrategyIO: version mismatch in %s (got %u expected %u)\n",
+                path.c_str(), version, expectedVersion);
+        return false;
+    }
+    
+    const uint32_t allowedFlags = FLAG_PLAY_ONLY | FLAG_COMPRESSED_ZLIB;
+    
+    if (flags & ~allowedFlags) {
+        fprintf(stderr, "StrategyIO: unknown flags 0x%X\n", flags);
+        return false;
+    }
+    return true;
+}
+
+/*
+ Internal: v3 chunked writer
+ 
+ File layout:
+ [ ChunkedHeader ]
+ [ zlib chunk x numChunks ]        - each one an independent stream of Entry records
+ [ ChunkIndexEntry x numChunks ]   - sorted by shard, a shard's chunks are contiguous
+ 
+ - entries are grouped by shardOf(key), every shard is cut into chunks of at most STREAM_CHUNK_BYTES raw
+ - chunks are serialized + compressed in parallel (OpenMP) in waves of 2 chunks per thread,
+   each wave is written in order before the next one starts -> memory stays O(threads * chunk)
+ - the index goes last (offsets are only known after compression), the header is rewritten at close
+ - shards can be written in several calls (in increasing shard order), e.g. one merged partition at a time
+ */
+using Element = InfosetMap::value_type;
+
+struct ShardSlice {
+    uint32_t shard;
+    const std::vector<const Element*>* entries;
+};
+
+template <typename Entry, typename MakeEntry>
+class ChunkedFileWriter {
+public:
+    explicit ChunkedFileWriter(MakeEntry makeEntry) : makeEntry(makeEntry) {}
+    
+    ~ChunkedFileWriter() {
+        if (file) fclose(file);
+    }
+    
+    ChunkedFileWriter(const ChunkedFileWriter&) = delete;
+    ChunkedFileWriter& operator=(const ChunkedFileWriter&) = delete;
+    
+    bool open(const std::string& path, uint32_t flags) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) {
+            fprintf(stderr, "StrategyIO: cannot open %s\n", path.c_str());
+            return false;
+        }
+        
+        header = ChunkedHeader{};
+        header.fileMagic = CHUNKED_FILE_MAGIC;
+        header.magic = MAGIC;
+        header.version = VERSION_CHUNKED;
+        header.flags = flags;
+        header.numShards = NUM_SHARDS;
+        
+        // placeholder, rewritten once the index offset is known
+        if (fwrite(&header, sizeof(header), 1, file) != 1) {
+            fprintf(stderr, "StrategyIO: failed to write header\n");
+            return false;
+        }
+        offset = sizeof(header);
+        return true;
+    }
+    
+    bool write(const std::vector<ShardSlice>& slices) {
+        struct ChunkJob {
+            uint32_t shard;
+            const std::vector<const Element*>* entries;
+            size_t begin;
+            uint32_t count;
+        };
+        const size_t entriesPerChunk = STREAM_CHUNK_BYTES / sizeof(Entry);
+        std::vector<ChunkJob> jobs;
+        for (const ShardSlice& slice : slices) {
+            for (size_t begin = 0; begin < slice.entries->size(); begin += entriesPerChunk) {
+                size_t count = std::min(entriesPerChunk, slice.entries->size() - begin);
+                jobs.push_back({slice.shard, slice.entries, begin, static_cast<uint32_t>(count)});
+            }
+        }
+        
+        const size_t wave = static_cast<size_t>(std::max(1, omp_get_max_threads())) * 2;
+        std::vector<std::vector<Bytef>> compressed(std::min(wave, jobs.size()));
+        
+        for (size_t first = 0; first < jobs.size(); first += wave) {
+            const int count = static_cast<int>(std::min(wave, jobs.size() - first));
+            std::exception_ptr error;
+            bool compressFailed = false;
+            
+#pragma omp parallel
+            {
+                std::vector<uint8_t> raw;
+                
+#pragma omp for schedule(dynamic, 1)
+                for (int k = 0; k < count; ++k) {
+                    const ChunkJob& job = jobs[first + k];
+                    try {
+                        raw.resize(static_cast<size_t>(job.count) * sizeof(Entry));
+                        for (uint32_t i = 0; i < job.count; ++i) {
+                            const Element* element = (*job.entries)[job.begin + i];
+                            Entry entry = makeEntry(element->first, element->second);
+                            memcpy(raw.data() + i * sizeof(Entry), &entry, sizeof(Entry));
+                        }
+                        
+                        uLongf compressedSize = compressBound(static_cast<uLong>(raw.size()));
+                        compressed[k].resize(compressedSize);
+                        int ret = compress2(compressed[k].data(), &compressedSize,
+                                            raw.data(), static_cast<uLong>(raw.size()), Z_BEST_SPEED);
+                        if (ret != Z_OK) {
+#pragma omp critical(strategy_io_error)
+                            compressFailed = true;
+                        }
+                        compressed[k].resize(compressedSize);
+                    } catch (...) {
+#pragma omp critical(strategy_io_error)
+                        error = std::current_exception();
+                    }
+                }
+            }
+            
+            if (error) {
+                std::rethrow_exception(error); // same errors as the serial writer
+            }
+            if (compressFailed) {
+                fprintf(stderr, "StrategyIO: zlib compress failed\n");
+                return false;
+            }
+            
+            for (int k = 0; k < count; ++k) {
+                const ChunkJob& job = jobs[first + k];
+                if (fwrite(compressed[k].data(), 1, compressed[k].size(), file) != compressed[k].size()) {
+                    fprintf(stderr, "StrategyIO: failed to write compressed data\n");
+                    return false;
+                }
+                index.push_back(ChunkIndexEntry{job.shard, job.count, offset, compressed[k].size()});
+                offset += compressed[k].size();
+                header.numEntries += job.count;
+            }
         }
+        return true;
+    }
+    
+    // writes the index and the final header
+    bool close() {
+        header.numChunks = static_cast<uint32_t>(index.size());
+        header.indexOffset = offset;
+        bool written = index.empty() || fwrite(index.data(), sizeof(ChunkIndexEntry), index.size(), file) == index.size();
+        written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
         
-        memcpy(writePointer, &entry, sizeof(entry));
-        writePointer += sizeof(entry);
+        int closed = fclose(file);
+        file = nullptr;
+        if (closed != 0 || !written) {
+            fprintf(stderr, "StrategyIO: failed to write chunk index\n");
+            return false;
+        }
+        return true;
+    }
+    
+private:
+    MakeEntry makeEntry;
+    FILE* file = nullptr;
+    ChunkedHeader header{};
+    std::vector<ChunkIndexEntry> index;
+    uint64_t offset = 0;
+};
+
+template <typename Entry, typename MakeEntry>
+static bool writeChunkedInfosets(const InfosetMap& map, const std::string& path, uint32_t flags, MakeEntry makeEntry) {
+    std::vector<std::vector<const Element*>> shards(NUM_SHARDS);
+    {
+        std::vector<size_t> counts(NUM_SHARDS, 0);
+        for (const auto& element : map) counts[shardOf(element.first)]++;
+        for (uint32_t s = 0; s < NUM_SHARDS; ++s) shards[s].reserve(counts[s]);
+        for (const auto& element : map) shards[shardOf(element.first)].push_back(&element);
+    }
+    
+    std::vector<ShardSlice> slices;
+    for (uint32_t s = 0; s < NUM_SHARDS; ++s) {
+        slices.push_back(ShardSlice{s, &shards[s]});
     }
     
-    return buffer;
+    ChunkedFileWriter<Entry, MakeEntry> writer(makeEntry);
+    return writer.open(path, flags) && writer.write(slices) && writer.close();
 }
+
 /*
- Internal: Serializes play-only strategy
+ Internal: v3 reader state
+  - header + chunk index, validated
+  - chunk payloads are read with one FILE per thread (independent offsets)
+ */
+struct ChunkedFile {
+    ChunkedHeader header{};
+    std::vector<ChunkIndexEntry> index;
+    size_t entryBytes = 0;
+    bool playOnly = false;
+};
 
- Used for:
-  - head-to-head matches
-  - BO evaluation
-  - exporting strategies for play
- 
-Layout:
- [ Header ]
- [ PlayEntry x N ]
+// true if the file starts with the v3 magic (v2 files start with their raw size)
+static bool isChunkedFile(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) return false;
+    uint64_t fileMagic = 0;
+    bool chunked = fread(&fileMagic, sizeof(fileMagic), 1, f) == 1 && fileMagic == CHUNKED_FILE_MAGIC;
+    fclose(f);
+    return chunked;
+}
 
- - NOT suitable for resuming training: only strategySum is stored (regretSum is not present)
- - returned buffer is later compressed and written to disk
-*/
-static std::vector<uint8_t> serializePlayInfosets(const InfosetMap& map) {
-    if (map.size() > (SIZE_MAX - sizeof(Header)) / sizeof(PlayEntry)) {
-        throw std::runtime_error("StrategyIO: buffer size overflow");
+static bool readChunkedIndex(const std::string& path, ChunkedFile& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (!f) {
+        fprintf(stderr, "StrategyIO: cannot open %s for reading\n", path.c_str());
+        return false;
     }
-    size_t totalSize = sizeof(Header) + map.size() * sizeof(PlayEntry);
-    std::vector<uint8_t> buffer(totalSize);
     
-    uint8_t* writePointer = buffer.data();
+    bool ok = fread(&out.header, sizeof(out.header), 1, f) == 1;
+    if (!ok) {
+        fprintf(stderr, "StrategyIO: truncated file (header)\n");
+    }
+    ok = ok && validateHeader(out.header.magic, out.header.version, VERSION_CHUNKED, out.header.flags, path);
     
-    Header header{};
-    header.magic      = MAGIC;
-    header.version    = VERSION;
-    header.numEntries = map.size();
-    header.flags = FLAG_PLAY_ONLY | FLAG_COMPRESSED_ZLIB; // play only flag set
-    memcpy(writePointer, &header, sizeof(header));
-    writePointer += sizeof(header);
+    if (ok) {
+        out.index.resize(out.header.numChunks);
+        ok = fseek(f, static_cast<long>(out.header.indexOffset), SEEK_SET) == 0
+          && fread(out.index.data(), sizeof(ChunkIndexEntry), out.index.size(), f) == out.index.size();
+        if (!ok) {
+            fprintf(stderr, "StrategyIO: truncated file (chunk index)\n");
+        }
+    }
+    fclose(f);
+    if (!ok) return false;
     
-    for (const auto& [key, infoset] : map) {
-        PlayEntry entry{};
-        entry.historyHash = key.historyHash;
-        entry.bucketId = key.bucketId;
-        if (infoset.numActions < 2 || infoset.numActions > MCCFR::MAX_ACTIONS) {
-            throw std::runtime_error("StrategyIO: invalid numActions");
+    out.playOnly = (out.header.flags & FLAG_PLAY_ONLY) != 0;
+    out.entryBytes = out.playOnly ? sizeof(PlayEntry) : sizeof(FullEntry);
+    
+    uint64_t total = 0;
+    for (const auto& chunk : out.index) {
+        if (chunk.shard >= out.header.numShards || chunk.offset + chunk.compressedSize > out.header.indexOffset) {
+            fprintf(stderr, "StrategyIO: corrupted chunk index in %s\n", path.c_str());
+            return false;
         }
+        total += chunk.numEntries;
+    }
+    if (total != out.header.numEntries) {
+        fprintf(stderr, "StrategyIO: chunk index covers %llu of %llu entries\n",
+                (unsigned long long)total, (unsigned long long)out.header.numEntries);
+        return false;
+    }
+    return true;
+}
+
+// reads and decompresses one chunk into raw (numEntries * entryBytes)
+static bool decodeChunk(FILE* f, const ChunkedFile& file, const ChunkIndexEntry& chunk,
+                        std::vector<Bytef>& compressed, std::vector<uint8_t>& raw) {
+    compressed.resize(chunk.compressedSize);
+    if (fseek(f, static_cast<long>(chunk.offset), SEEK_SET) != 0
+        || fread(compressed.data(), 1, compressed.size(), f) != compressed.size()) {
+        fprintf(stderr, "StrategyIO: read error (chunk at %llu)\n", (unsigned long long)chunk.offset);
+        return false;
+    }
+    
+    size_t rawSize = static_cast<size_t>(chunk.numEntries) * file.entryBytes;
+    raw.resize(rawSize);
+    uLongf destLen = static_cast<uLongf>(rawSize);
+    int ret = uncompress(raw.data(), &destLen, compressed.data(), static_cast<uLong>(compressed.size()));
+    if (ret != Z_OK || destLen != rawSize) {
+        fprintf(stderr, "StrategyIO: zlib decompress failed or size mismatch\n");
+        return false;
+    }
+    return true;
+}
+
+static bool insertChunk(InfosetMap& outInfosets, const ChunkedFile& file, const std::vector<uint8_t>& raw, uint32_t numEntries) {
+    return file.playOnly ? insertChunkEntries<PlayEntry>(outInfosets, raw.data(), numEntries)
+                         : insertChunkEntries<FullEntry>(outInfosets, raw.data(), numEntries);
+}
+
+// v3 chunks into one map: decompressed in parallel waves, inserted by the calling thread
+static bool loadChunks(InfosetMap& outInfosets, const std::string& path, const ChunkedFile& file,
+                       const std::vector<size_t>& chunks) {
+    const size_t numChunks = chunks.size();
+    const size_t wave = static_cast<size_t>(std::max(1, omp_get_max_threads())) * 2;
+    std::vector<std::vector<uint8_t>> raw(std::min(wave, numChunks));
+    
+    for (size_t first = 0; first < numChunks; first += wave) {
+        const int count = static_cast<int>(std::min(wave, numChunks - first));
+        bool failed = false;
         
-        entry.numActions = infoset.numActions;
-        for (int i = 0; i < MCCFR::MAX_ACTIONS; ++i) {
-            entry.strategySum[i] = infoset.strategySum[i];
+#pragma omp parallel
+        {
+            FILE* f = fopen(path.c_str(), "rb");
+            std::vector<Bytef> compressed;
+            
+#pragma omp for schedule(dynamic, 1)
+            for (int k = 0; k < count; ++k) {
+                if (!f || !decodeChunk(f, file, file.index[chunks[first + k]], compressed, raw[k])) {
+#pragma omp critical(strategy_io_error)
+                    failed = true;
+                }
+            }
+            if (f) fclose(f);
         }
+        if (failed) return false;
         
-        memcpy(writePointer, &entry, sizeof(entry));
-        writePointer += sizeof(entry);
+        for (int k = 0; k < count; ++k) {
+            if (!insertChunk(outInfosets, file, raw[k], file.index[chunks[first + k]].numEntries)) return false;
+        }
+    }
+    return true;
+}
+
+static bool loadChunked(InfosetMap& outInfosets, const std::string& path) {
+    ChunkedFile file;
+    if (!readChunkedIndex(path, file)) return false;
+    
+    outInfosets.clear();
+    outInfosets.reserve(file.header.numEntries);
+    
+    std::vector<size_t> chunks(file.index.size());
+    for (size_t c = 0; c < chunks.size(); ++c) chunks[c] = c;
+    return loadChunks(outInfosets, path, file, chunks);
+}
+
+// v2 single stream (shard >= 0: only that shard's entries, the whole stream is still decompressed)
+static bool loadStream(InfosetMap& outInfosets, const std::string& path, int64_t shard = -1) {
+    InflateReader reader;
+    if (!reader.open(path)) return false;
+    
+    Header header{};
+    
+    if (!reader.read(&header, sizeof(header))) {
+        fprintf(stderr, "StrategyIO: truncated file (header)\n");
+        return false;
+    }
+    
+    if (!validateHeader(header.magic, header.version, VERSION, header.flags, path)) return false;
+    
+    bool playOnly = (header.flags & FLAG_PLAY_ONLY) != 0;
+    size_t numEntries = header.numEntries;
+    
+    // one shard keeps ~1 / NUM_SHARDS of the keys (shardOf is uniform), the map grows past it if needed
+    outInfosets.clear();
+    outInfosets.reserve(shard >= 0 ? numEntries / NUM_SHARDS : numEntries);
+    
+    return playOnly ? readStreamEntries<PlayEntry>(reader, outInfosets, numEntries, "play", shard)
+                    : readStreamEntries<FullEntry>(reader, outInfosets, numEntries, "full", shard);
+}
+
+// one shard of any file
+static bool loadShard(InfosetMap& outInfosets, const std::string& path, uint32_t shard) {
+    outInfosets.clear();
+    if (!isChunkedFile(path)) return loadStream(outInfosets, path, shard);
+    
+    ChunkedFile file;
+    if (!readChunkedIndex(path, file)) return false;
+    if (file.header.numShards != NUM_SHARDS) {
+        fprintf(stderr, "StrategyIO: %s has %u shards, expected %u\n", path.c_str(), file.header.numShards, NUM_SHARDS);
+        return false;
+    }
+    
+    std::vector<size_t> chunks;
+    for (size_t c = 0; c < file.index.size(); ++c) {
+        if (file.index[c].shard == shard) chunks.push_back(c);
+    }
+    return loadChunks(outInfosets, path, file, chunks);
+}
+
+// storage mode of any file (false if unreadable)
+static bool readPlayOnly(const std::string& path, bool& playOnly) {
+    if (isChunkedFile(path)) {
+        ChunkedFile file;
+        if (!readChunkedIndex(path, file)) return false;
+        playOnly = file.playOnly;
+        return true;
     }
     
-    return buffer;
+    InflateReader reader;
+    Header header{};
+    if (!reader.open(path) || !reader.read(&header, sizeof(header))) return false;
+    if (!validateHeader(header.magic, header.version, VERSION, header.flags, path)) return false;
+    playOnly = (header.flags & FLAG_PLAY_ONLY) != 0;
+    return true;
 }
 
 // PUBLIC API funcitons
 
-bool save(const InfosetMap& map, const std::string& path) {
+bool save(const InfosetMap& map, const std::string& path, Format format) {
     fprintf(stderr, "StrategyIO: saving %zu infosets (full mode)...\n", map.size());
-    auto serialized = serializeFullInfosets(map);
-    return writeZlibInfosets(path, serialized.data(), serialized.size());
+    const uint32_t flags = FLAG_COMPRESSED_ZLIB; // full mode (no play-only flag)
+    return format == Format::Chunked ? writeChunkedInfosets<FullEntry>(map, path, flags, makeFullEntry)
+                                     : writeZlibInfosets<FullEntry>(map, path, flags, makeFullEntry);
 }
 
-bool saveForPlay(const InfosetMap& map, const std::string& path) {
+bool saveForPlay(const InfosetMap& map, const std::string& path, Format format) {
     fprintf(stderr, "StrategyIO: saving %zu infosets (strategy snapshot for evaluation)...\n", map.size());
-    auto serialized = serializePlayInfosets(map);
-    return writeZlibInfosets(path, serialized.data(), serialized.size());
+    const uint32_t flags = FLAG_PLAY_ONLY | FLAG_COMPRESSED_ZLIB;
+    return format == Format::Chunked ? writeChunkedInfosets<PlayEntry>(map, path, flags, makePlayEntry)
+                                     : writeZlibInfosets<PlayEntry>(map, path, flags, makePlayEntry);
 }
 
 /*
 Loads a saved Nao strategy into memory.
 
 Steps:
- 1. Decompress file into raw buffer
- 2. Validate header (magic, version, flags) - automatically detects full vs play-only mode
- 3. Reconstruct infoset map
+ 1. Detect the format from the first 8 bytes (v3 magic or v2 size prefix)
+ 2. v2: stream the file through inflate (fixed size chunks, never the whole payload in memory)
+    v3: decompress chunks in parallel
+ 3. Validate header (magic, version, flags) - automatically detects full vs play-only mode
+ 4. Reconstruct infoset map
 
 Output:
  - outInfosets becomes a fully usable strategy for:
@@ -294,119 +884,229 @@ Fails if:
  - invalid entry data
 */
 bool load(InfosetMap& outInfosets, const std::string& path) {
-    std::vector<uint8_t> decompressed;
-    if (!readZlibInfosets(path, decompressed)) return false;
-    
-    const uint8_t* readPointer = decompressed.data();
-    const uint8_t* bufferEnd = decompressed.data() + decompressed.size();
-    
-    Header header{};
+    return isChunkedFile(path) ? loadChunked(outInfosets, path) : loadStream(outInfosets, path);
+}
+
+bool loadSharded(ShardedMap& outShards, const std::string& path) {
+    outShards.clear();
+    outShards.resize(NUM_SHARDS);
     
-    if (readPointer + sizeof(Header) > bufferEnd) {
-        fprintf(stderr, "StrategyIO: truncated file (header)\n");
-        return false;
+    if (!isChunkedFile(path)) {
+        // v2 has no shard grouping: load serially, then distribute
+        InfosetMap map;
+        if (!loadStream(map, path)) return false;
+        for (const auto& [key, infoset] : map) outShards[shardOf(key)][key] = infoset;
+        return true;
     }
     
-    memcpy(&header, readPointer, sizeof(header));
-    readPointer += sizeof(header);
-    
-    if (header.magic != MAGIC) {
-        fprintf(stderr, "StrategyIO: bad magic in %s (got 0x%X expected 0x%X)\n",
-                path.c_str(), header.magic, MAGIC);
+    ChunkedFile file;
+    if (!readChunkedIndex(path, file)) return false;
+    if (file.header.numShards != NUM_SHARDS) {
+        fprintf(stderr, "StrategyIO: %s has %u shards, expected %u\n", path.c_str(), file.header.numShards, NUM_SHARDS);
         return false;
     }
     
-    if (header.version != VERSION) {
-        fprintf(stderr, "StrategyIO: version mismatch in %s (got %u expected %u)\n",
-                path.c_str(), header.version, VERSION);
-        return false;
+    // chunks of a shard are contiguous in the index
+    std::vector<size_t> shardBegin(NUM_SHARDS + 1, file.index.size());
+    std::vector<uint64_t> shardEntries(NUM_SHARDS, 0);
+    for (size_t c = file.index.size(); c-- > 0;) {
+        shardBegin[file.index[c].shard] = c;
+        shardEntries[file.index[c].shard] += file.index[c].numEntries;
+    }
+    for (int s = NUM_SHARDS - 1; s >= 0; --s) {
+        shardBegin[s] = std::min(shardBegin[s], shardBegin[s + 1]);
     }
     
-    const uint32_t allowedFlags = FLAG_PLAY_ONLY | FLAG_COMPRESSED_ZLIB;
+    bool failed = false;
     
-    if (header.flags & ~allowedFlags) {
-        fprintf(stderr, "StrategyIO: unknown flags 0x%X\n", header.flags);
+#pragma omp parallel
+    {
+        FILE* f = fopen(path.c_str(), "rb");
+        std::vector<Bytef> compressed;
+        std::vector<uint8_t> raw;
+        
+#pragma omp for schedule(dynamic, 1)
+        for (int s = 0; s < static_cast<int>(NUM_SHARDS); ++s) {
+            bool ok = f != nullptr;
+            outShards[s].reserve(shardEntries[s]);
+            for (size_t c = shardBegin[s]; ok && c < shardBegin[s + 1]; ++c) {
+                ok = decodeChunk(f, file, file.index[c], compressed, raw)
+                  && insertChunk(outShards[s], file, raw, file.index[c].numEntries);
+            }
+            if (!ok) {
+#pragma omp critical(strategy_io_error)
+                failed = true;
+            }
+        }
+        if (f) fclose(f);
+    }
+    return !failed;
+}
+
+bool merge(const std::vector<std::string>& inputs, const std::vector<double>& weights,
+           const std::string& outPath, Format format) {
+    if (inputs.empty() || (!weights.empty() && weights.size() != inputs.size())) {
+        fprintf(stderr, "StrategyIO: merge needs at least one input and one weight per input (or none)\n");
         return false;
     }
     
-    bool playOnly = (header.flags & FLAG_PLAY_ONLY) != 0;
-    size_t numEntries = header.numEntries;
-    
-    outInfosets.clear();
-    outInfosets.reserve(numEntries);
+    bool playOnly = false;
+    for (size_t f = 0; f < inputs.size(); ++f) {
+        bool filePlayOnly = false;
+        if (!readPlayOnly(inputs[f], filePlayOnly)) return false;
+        if (f > 0 && filePlayOnly != playOnly) {
+            fprintf(stderr, "StrategyIO: cannot merge full and play-only files (%s)\n", inputs[f].c_str());
+            return false;
+        }
+        playOnly = filePlayOnly;
+    }
     
-    if (!playOnly) {
-        for (size_t i = 0; i < numEntries; ++i) {
-            if (readPointer + sizeof(FullEntry) > bufferEnd) {
-                fprintf(stderr, "StrategyIO: truncated file (full entry %zu)\n", i);
-                return false;
-            }
-            
-            FullEntry entry{};
-            memcpy(&entry, readPointer, sizeof(entry));
-            readPointer += sizeof(entry);
+    // one shard of the merged table, inputs summed with the trainer's merge rule
+    InfosetMap merged;
+    InfosetMap part;
+    auto mergeShard = [&](uint32_t shard) {
+        merged.clear();
+        for (size_t f = 0; f < inputs.size(); ++f) {
+            if (!loadShard(part, inputs[f], shard)) return false;
             
-            MCCFR::InfosetKey key{entry.historyHash, entry.bucketId};
-            MCCFR::Infoset infoset{};
-            if (entry.numActions < 2 || entry.numActions > MCCFR::MAX_ACTIONS) {
-                fprintf(stderr, "StrategyIO: invalid action count (%u) in infoset\n", entry.numActions);
-                return false;
-            }
-            
-            infoset.numActions = entry.numActions;
-            for (int j = 0; j < MCCFR::MAX_ACTIONS; ++j) {
-                infoset.regretSum[j]   = entry.regretSum[j];
-                infoset.strategySum[j] = entry.strategySum[j];
+            float weight = weights.empty() ? 1.0f : static_cast<float>(weights[f]);
+            if (weight != 1.0f) {
+                for (auto& [key, infoset] : part) {
+                    for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+                        infoset.regretSum[a] *= weight;
+                        infoset.strategySum[a] *= weight;
+                    }
+                }
             }
-            
-            outInfosets[key] = infoset;
+            MCCFR::ParallelTrainer::mergeMaps(merged, part);
         }
-    } else {
-        for (size_t i = 0; i < numEntries; ++i) {
-            if (readPointer + sizeof(PlayEntry) > bufferEnd) {
-                fprintf(stderr, "StrategyIO: truncated file (play entry %zu)\n", i);
-                return false;
-            }
-            
-            PlayEntry entry{};
-            memcpy(&entry, readPointer, sizeof(entry));
-            readPointer += sizeof(entry);
-            
-            MCCFR::InfosetKey key{entry.historyHash, entry.bucketId};
-            MCCFR::Infoset infoset{};
-            if (entry.numActions < 2 || entry.numActions > MCCFR::MAX_ACTIONS) {
-                fprintf(stderr, "StrategyIO: invalid numActions (%u)\n", entry.numActions);
-                return false;
-            }
-            infoset.numActions = entry.numActions;
-            for (int j = 0; j < MCCFR::MAX_ACTIONS; ++j) {
-                infoset.strategySum[j] = entry.strategySum[j];
-                infoset.regretSum[j] = 0.0f; // not saved in play mode
+        return true;
+    };
+    
+    std::vector<const Element*> elements;
+    auto collect = [&] {
+        elements.clear();
+        elements.reserve(merged.size());
+        for (const auto& element : merged) elements.push_back(&element);
+    };
+    
+    const uint32_t flags = playOnly ? (FLAG_PLAY_ONLY | FLAG_COMPRESSED_ZLIB) : FLAG_COMPRESSED_ZLIB;
+    
+    // the output may be one of the inputs -> written next to it, renamed over it once every input was read
+    const std::string temporary = outPath + ".tmp." + std::to_string(getpid());
+    
+    auto writeChunked = [&](auto makeEntry) {
+        ChunkedFileWriter<std::invoke_result_t<decltype(makeEntry), const MCCFR::InfosetKey&, const MCCFR::Infoset&>,
+                          decltype(makeEntry)> writer(makeEntry);
+        if (!writer.open(temporary, flags)) return false;
+        for (uint32_t shard = 0; shard < NUM_SHARDS; ++shard) {
+            if (!mergeShard(shard)) return false;
+            collect();
+            if (!writer.write({ShardSlice{shard, &elements}})) return false;
+        }
+        return writer.close();
+    };
+    
+    // v2: the size prefix and header need the entry count -> counting pass, then the writing pass
+    auto writeStream = [&](auto makeEntry) {
+        using Entry = std::invoke_result_t<decltype(makeEntry), const MCCFR::InfosetKey&, const MCCFR::Infoset&>;
+        uint64_t numEntries = 0;
+        for (uint32_t shard = 0; shard < NUM_SHARDS; ++shard) {
+            if (!mergeShard(shard)) return false;
+            numEntries += merged.size();
+        }
+        
+        DeflateWriter writer;
+        if (!writer.open(temporary, sizeof(Header) + numEntries * sizeof(Entry))) return false;
+        
+        Header header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.numEntries = numEntries;
+        header.flags = flags;
+        if (!writer.write(reinterpret_cast<const uint8_t*>(&header), sizeof(header))) return false;
+        
+        std::vector<uint8_t> chunk;
+        for (uint32_t shard = 0; shard < NUM_SHARDS; ++shard) {
+            if (!mergeShard(shard)) return false;
+            chunk.clear();
+            for (const auto& [key, infoset] : merged) {
+                Entry entry = makeEntry(key, infoset);
+                const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&entry);
+                chunk.insert(chunk.end(), bytes, bytes + sizeof(entry));
+                if (chunk.size() + sizeof(Entry) > STREAM_CHUNK_BYTES) {
+                    if (!writer.write(chunk.data(), chunk.size())) return false;
+                    chunk.clear();
+                }
             }
-            outInfosets[key] = infoset;
+            if (!chunk.empty() && !writer.write(chunk.data(), chunk.size())) return false;
         }
+        return writer.finish();
+    };
+    
+    fprintf(stderr, "StrategyIO: merging %zu files into %s...\n", inputs.size(), outPath.c_str());
+    bool ok;
+    if (format == Format::Chunked) {
+        ok = playOnly ? writeChunked(makePlayEntry) : writeChunked(makeFullEntry);
+    } else {
+        ok = playOnly ? writeStream(makePlayEntry) : writeStream(makeFullEntry);
+    }
+    if (ok && std::rename(temporary.c_str(), outPath.c_str()) != 0) {
+        fprintf(stderr, "StrategyIO: cannot move the merged table to %s\n", outPath.c_str());
+        ok = false;
+    }
+    if (!ok) {
+        std::remove(temporary.c_str());
+    }
+    return ok;
+}
+
+void encodeEntries(const InfosetMap& map, std::vector<uint8_t>& out) {
+    static_assert(sizeof(FullEntry) == FULL_ENTRY_BYTES, "wire entry must match the file layout");
+    size_t offset = out.size();
+    out.resize(offset + map.size() * sizeof(FullEntry));
+    for (const auto& [key, infoset] : map) {
+        FullEntry entry = makeFullEntry(key, infoset);
+        memcpy(out.data() + offset, &entry, sizeof(entry));
+        offset += sizeof(entry);
     }
-    return true;
+}
+
+bool decodeEntries(const uint8_t* data, size_t numEntries, InfosetMap& out) {
+    return insertChunkEntries<FullEntry>(out, data, numEntries);
 }
 
 void inspect(const std::string& path) {
-    std::vector<uint8_t> decompressed;
-    if (!readZlibInfosets(path, decompressed)) return;
-    
-    if (decompressed.size() < sizeof(Header)) {
-        fprintf(stderr, "StrategyIO: file too small to contain header\n");
+    if (isChunkedFile(path)) {
+        ChunkedFile file;
+        if (!readChunkedIndex(path, file)) return;
+        
+        fprintf(stdout, "File: %s\n", path.c_str());
+        fprintf(stdout, "Version: %u (chunked)\n", file.header.version);
+        fprintf(stdout, "Infosets: %llu\n", (unsigned long long)file.header.numEntries);
+        fprintf(stdout, "Mode: %s\n", file.playOnly ? "play-only" : "full");
+        fprintf(stdout, "Shards: %u, chunks: %u\n", file.header.numShards, file.header.numChunks);
+        fprintf(stdout, "Raw size:  %.1f MB\n",
+                (file.header.numEntries * file.entryBytes) / (1024.0 * 1024.0));
         return;
     }
     
+    // only the header is decompressed
+    InflateReader reader;
+    if (!reader.open(path)) return;
+    
     Header header;
-    memcpy(&header, decompressed.data(), sizeof(Header));
+    if (!reader.read(&header, sizeof(header))) {
+        fprintf(stderr, "StrategyIO: file too small to contain header\n");
+        return;
+    }
     
     fprintf(stdout, "File: %s\n", path.c_str());
     fprintf(stdout, "Version: %u\n", header.version);
     fprintf(stdout, "Infosets: %llu\n", (unsigned long long)header.numEntries);
     fprintf(stdout, "Mode: %s\n",
             (header.flags & FLAG_PLAY_ONLY) ? "play-only" : "full");
-    fprintf(stdout, "Raw size:  %.1f MB\n", decompressed.size() / (1024.0 * 1024.0));
+    fprintf(stdout, "Raw size:  %.1f MB\n", reader.rawSize() / (1024.0 * 1024.0));
 }
 
 }
@@ -19,7 +19,13 @@
  
 Files written:
     - they have fixed binary layout (header + entries)
-    - compressed with zlib
+    - two container formats (same entries), load() accepts both:
+        v2 stream:  [uint64_t rawSize][one zlib stream of header + entries]
+        v3 chunked: [ChunkedHeader][independent zlib chunks][chunk index] (default for new files)
+      v3 groups entries by key-hash shard (shardOf), all cores compress on save and decompress on load,
+      loadSharded() fills one pre-reserved map per shard in parallel
+    - compressed with zlib, streamed through deflate / inflate in fixed size chunks
+      (save serializes the next chunk while the previous one is compressed and written)
 
  Format includes:
     - magic number (identity check)
@@ -59,7 +65,9 @@ Files written:
 #include "cfr/cfr-core/infoset.hpp"
 #include "cfr/external/robin_hood.h"
 #include <string>
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 namespace StrategyIO {
 // defines the container used in IO
@@ -73,16 +81,35 @@ using InfosetMap = robin_hood::unordered_flat_map<
 
 static constexpr uint32_t MAGIC = 0x4E414F54; // "NAOT" (v2)
 static constexpr uint32_t VERSION = 2;
+static constexpr uint32_t VERSION_CHUNKED = 3;
+static constexpr uint64_t CHUNKED_FILE_MAGIC = 0x334B4843544F414EULL; // "NAOTCHK3" as the first 8 bytes of a v3 file
 
 static constexpr uint32_t FLAG_PLAY_ONLY = 0x1; // strategySum only (no regret values needed for play simulations)
 static constexpr uint32_t FLAG_COMPRESSED_ZLIB = 0x2; // payload is zlib-compressed
 
+enum class Format : uint8_t {
+    Stream  = 2, // v2, single zlib stream
+    Chunked = 3  // v3, sharded independent chunks
+};
+
+// v3 shards: top bits of the bucket-mixed history hash (Zobrist bits are uniform)
+static constexpr uint32_t SHARD_BITS = 6;
+static constexpr uint32_t NUM_SHARDS = 1u << SHARD_BITS;
+
+inline uint32_t shardOf(const MCCFR::InfosetKey& key) {
+    uint64_t mixed = key.historyHash ^ (static_cast<uint64_t>(static_cast<uint32_t>(key.bucketId)) * 0x9E3779B97F4A7C15ULL);
+    return static_cast<uint32_t>(mixed >> (64 - SHARD_BITS));
+}
+
+// one map per shard, key k lives in shards[shardOf(k)]
+using ShardedMap = std::vector<InfosetMap>;
+
 /*
 Writes a full infoset map (including BOTH regretSums and strategySums), compressed with zlib
  - used for continuing training later (basically a checkpoint)
  - it returns true if succeeded
  */
-bool save(const InfosetMap& map, const std::string& path);
+bool save(const InfosetMap& map, const std::string& path, Format format = Format::Chunked);
 
 /*
 Writes a reduced infoset map (including strategySums, NOT INCLUDING regretSums), compressed with zlib
@@ -90,11 +117,11 @@ Writes a reduced infoset map (including strategySums, NOT INCLUDING regretSums),
  - loaded map will have regretSum = 0
  - it returns true if succeeded
  */
-bool saveForPlay(const InfosetMap& map, const std::string& path);
+bool saveForPlay(const InfosetMap& map, const std::string& path, Format format = Format::Chunked);
 
 /*
 Loads any infoset correctly saved by the previous 2 save function versions from file
- 1. decompresses zlib payload
+ 1. detects v2 / v3, decompresses zlib payload (v3: chunks in parallel)
  2. validates header (magic, version, flags)
  3. reconstructs infoset map
  
@@ -103,6 +130,36 @@ Loads any infoset correctly saved by the previous 2 save function versions from
  */
 bool load(InfosetMap& outInfosets, const std::string& path);
 
+/*
+Same as load, into NUM_SHARDS maps
+ - v3: one thread per shard decompresses its chunks and inserts into its own pre-reserved map (no serial insert)
+ - v2: loaded serially, then distributed
+ */
+bool loadSharded(ShardedMap& outShards, const std::string& path);
+
+/*
+Offline merge of saved tables (e.g. the same abstraction trained on several machines with different seeds)
+ - sums regretSum / strategySum with ParallelTrainer::mergeMaps, each file scaled by its weight (empty = all 1)
+ - streamed by key-hash shard: only one shard of the merged table is in memory at a time
+   (v3 inputs read just that shard's chunks, v2 inputs are decompressed once per shard -> convert big v2 files first)
+ - all inputs must have the same mode (full / play-only), the output keeps it
+ - v3 output is written shard by shard, v2 output needs the entry count up front (one extra merge pass)
+ - the output goes to a temporary file renamed into place, so outPath may be one of the inputs
+ - it returns true if succeeded
+ */
+bool merge(const std::vector<std::string>& inputs, const std::vector<double>& weights,
+           const std::string& outPath, Format format = Format::Chunked);
+
+/*
+Raw full-mode entries, no header and no compression (the same 61-byte layout as inside the files)
+ - used as the wire format of distributed training (cfr-core/mccfr_distributed.hpp)
+ - encodeEntries appends map.size() entries to out
+ - decodeEntries inserts (overwrites) numEntries entries into out, false on invalid data
+ */
+static constexpr size_t FULL_ENTRY_BYTES = 61;
+void encodeEntries(const InfosetMap& map, std::vector<uint8_t>& out);
+bool decodeEntries(const uint8_t* data, size_t numEntries, InfosetMap& out);
+
 /*
 Can read and print file metadata without reconstructing the complete map
 (like version, number of infosets, storage mode)
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+/*
+Counter-based random stream (SplitMix64 finalizer over a keyed counter).
+ -> source: Steele, Lea & Flood (2014), "Fast Splittable Pseudorandom Number Generators", OOPSLA
+
+ - every (seed, streamId) pair owns an independent stream, the n-th draw is mix(key + n * GOLDEN)
+ - no shared state between streams -> a duplicate pair always sees the same numbers,
+   no matter which thread plays it or in which order
+ - satisfies UniformRandomBitGenerator, so it plugs into std:: distributions
+ */
+namespace CounterRNG {
+
+constexpr uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+class Stream {
+public:
+    using result_type = uint64_t;
+
+    Stream(uint64_t seed, uint64_t streamId)
+    : key(mix64(seed) ^ mix64(streamId * GOLDEN_GAMMA + 1)), counter(0) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() {
+        return mix64(key + (++counter) * GOLDEN_GAMMA);
+    }
+
+    // uniform float in [0, 1), 24 mantissa bits
+    float uniform01() {
+        return static_cast<float>((*this)() >> 40) * (1.0f / 16777216.0f);
+    }
+
+    // uniform int in [low, high], Lemire's multiply-shift (bias < 2^-32 for deck sized ranges)
+    int uniformInt(int low, int high) {
+        uint64_t range = static_cast<uint64_t>(high - low) + 1;
+        uint64_t r = (*this)() >> 32;
+        return low + static_cast<int>((r * range) >> 32);
+    }
+
+private:
+    uint64_t key;
+    uint64_t counter;
+};
+
+}
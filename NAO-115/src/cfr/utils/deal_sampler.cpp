@@ -0,0 +1,201 @@
+#include "deal_sampler.hpp"
+#include "counter_rng.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace DealSampler {
+
+// deal streams are salted, so they never coincide with the (seed, index) streams the callers use for actions
+static constexpr uint64_t DEAL_STREAM_SALT = 0xD1B54A32D192ED03ULL;
+static constexpr double GOLDEN_FRACTION = 0.6180339887498949;
+
+Sampler::Sampler(const Bucketer::IsomorphismEngine& engine, uint64_t seed, Mode mode)
+: samplingMode(mode), seed(seed ^ DEAL_STREAM_SALT)
+{
+    CounterRNG::Stream offsetRng(this->seed, ~0ULL);
+    offset = static_cast<double>(offsetRng() >> 11) * (1.0 / 9007199254740992.0);
+
+    if (mode == Mode::Independent) {
+        stratumWeights = {1.0};
+        cumulative = {1.0};
+        return;
+    }
+
+    uint64_t numFlops = engine.getBoardFlopCombinations();
+    std::vector<double> rawCount(numFlops, 0.0);
+    for (int a = 0; a < 52; ++a) {
+        for (int b = a + 1; b < 52; ++b) {
+            for (int c = b + 1; c < 52; ++c) {
+                std::array<uint8_t, 3> flop = {static_cast<uint8_t>(a), static_cast<uint8_t>(b), static_cast<uint8_t>(c)};
+                rawCount[engine.getBoardFlopIndex(flop)] += 1.0;
+            }
+        }
+    }
+
+    flops.resize(numFlops);
+    stratumWeights.resize(numFlops);
+    cumulative.resize(numFlops);
+    double running = 0.0;
+    for (uint64_t f = 0; f < numFlops; ++f) {
+        std::array<uint8_t, 3> cards = engine.unindexBoardFlop(f);
+        flops[f] = {cards[0], cards[1], cards[2]};
+        stratumWeights[f] = rawCount[f] / 22100.0;
+        running += rawCount[f];
+        cumulative[f] = running / 22100.0;
+    }
+    cumulative.back() = 1.0;
+}
+
+int Sampler::stratumOf(uint64_t unit) const {
+    double u = offset + static_cast<double>(unit) * GOLDEN_FRACTION;
+    u -= std::floor(u);
+    auto it = std::upper_bound(cumulative.begin(), cumulative.end(), u);
+    if (it == cumulative.end()) {
+        --it;
+    }
+    return static_cast<int>(it - cumulative.begin());
+}
+
+Deal Sampler::deal(uint64_t index) const {
+    uint64_t unit = (samplingMode == Mode::StratifiedAntithetic) ? index / 2 : index;
+    CounterRNG::Stream rng(seed, unit);
+
+    int deck[52];
+    for (int i = 0; i < 52; ++i) {
+        deck[i] = i;
+    }
+
+    Deal out;
+    if (samplingMode == Mode::Independent) {
+        // partial Fisher-Yates: only shuffle first 9 cards
+        for (int i = 0; i < 9; ++i) {
+            int j = rng.uniformInt(i, 51);
+            std::swap(deck[i], deck[j]);
+        }
+        out.p0hand = {deck[0], deck[1]};
+        out.p1hand = {deck[2], deck[3]};
+        out.board = {deck[4], deck[5], deck[6], deck[7], deck[8]};
+        out.stratum = 0;
+        return out;
+    }
+
+    int stratum = stratumOf(unit);
+    const std::array<int, 3>& flop = flops[stratum];
+
+    // flop cards go to the front, the other 6 cards come from the remaining 49
+    for (int k = 0; k < 3; ++k) {
+        int position = static_cast<int>(std::find(deck, deck + 52, flop[k]) - deck);
+        std::swap(deck[k], deck[position]);
+    }
+    for (int i = 3; i < 9; ++i) {
+        int j = rng.uniformInt(i, 51);
+        std::swap(deck[i], deck[j]);
+    }
+
+    out.p0hand = {deck[3], deck[4]};
+    out.p1hand = {deck[5], deck[6]};
+    out.board = {flop[0], flop[1], flop[2], deck[7], deck[8]};
+    out.stratum = stratum;
+
+    if (samplingMode == Mode::StratifiedAntithetic && (index & 1ULL)) {
+        std::swap(out.p0hand, out.p1hand);
+    }
+    return out;
+}
+
+// STRATIFIED ACCUMULATOR
+
+StratifiedAccumulator::StratifiedAccumulator(const std::vector<double>& stratumWeights)
+: weights(stratumWeights),
+  counts(stratumWeights.size(), 0.0),
+  means(stratumWeights.size(), 0.0),
+  m2s(stratumWeights.size(), 0.0) {}
+
+void StratifiedAccumulator::add(int stratum, double value) {
+    double& n = counts[stratum];
+    n += 1.0;
+    double delta = value - means[stratum];
+    means[stratum] += delta / n;
+    m2s[stratum] += delta * (value - means[stratum]);
+
+    totalCount++;
+    double overallDelta = value - overallMean;
+    overallMean += overallDelta / static_cast<double>(totalCount);
+    overallM2 += overallDelta * (value - overallMean);
+}
+
+void StratifiedAccumulator::merge(const StratifiedAccumulator& other) {
+    for (size_t s = 0; s < counts.size(); ++s) {
+        if (other.counts[s] == 0.0) {
+            continue;
+        }
+        double total = counts[s] + other.counts[s];
+        double delta = other.means[s] - means[s];
+        means[s] += delta * other.counts[s] / total;
+        m2s[s] += other.m2s[s] + delta * delta * counts[s] * other.counts[s] / total;
+        counts[s] = total;
+    }
+
+    if (other.totalCount == 0) {
+        return;
+    }
+    double na = static_cast<double>(totalCount);
+    double nb = static_cast<double>(other.totalCount);
+    double delta = other.overallMean - overallMean;
+    overallMean += delta * nb / (na + nb);
+    overallM2 += other.overallM2 + delta * delta * na * nb / (na + nb);
+    totalCount += other.totalCount;
+}
+
+double StratifiedAccumulator::mean() const {
+    double weighted = 0.0;
+    double coveredWeight = 0.0;
+    for (size_t s = 0; s < counts.size(); ++s) {
+        if (counts[s] > 0.0) {
+            weighted += weights[s] * means[s];
+            coveredWeight += weights[s];
+        }
+    }
+    return coveredWeight > 0.0 ? weighted / coveredWeight : 0.0;
+}
+
+double StratifiedAccumulator::standardError() const {
+    if (totalCount < 2) {
+        return 0.0;
+    }
+
+    double pooledM2 = 0.0;
+    double pooledDegrees = 0.0;
+    double coveredWeight = 0.0;
+    for (size_t s = 0; s < counts.size(); ++s) {
+        if (counts[s] > 0.0) {
+            pooledM2 += m2s[s];
+            pooledDegrees += counts[s] - 1.0;
+            coveredWeight += weights[s];
+        }
+    }
+
+    double n = static_cast<double>(totalCount);
+    if (pooledDegrees < 1.0) {
+        // nothing to pool yet -> plain sample variance
+        return std::sqrt(overallM2 / (n - 1.0) / n);
+    }
+    double pooledVariance = pooledM2 / pooledDegrees;
+
+    double weightSum = 0.0;
+    for (size_t s = 0; s < counts.size(); ++s) {
+        if (counts[s] > 0.0) {
+            double w = weights[s] / coveredWeight;
+            weightSum += w * w / counts[s];
+        }
+    }
+    return std::sqrt(pooledVariance * weightSum);
+}
+
+double StratifiedAccumulator::variance() const {
+    double se = standardError();
+    return se * se * static_cast<double>(totalCount);
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "hand-bucketing/mapping_engine.hpp"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/*
+Deal sampling for the evaluators (exploitability, head to head matches).
+ Most of the sampling noise comes from WHICH flop texture is drawn, so the flop is stratified:
+
+ - strata: the 1755 suit-isomorphic flops, weight = raw flops mapping to it / 22100
+ - stratum of deal i: golden ratio sequence u_i = frac(offset + i * 0.618...) through the cumulative weights
+   -> every stratum is hit in proportion to its weight up to a few deals (discrepancy ~ log n), offset is random per seed
+ - the flop is the stratum's canonical representative (strategies, buckets and payoffs are suit-symmetric),
+   hole cards, turn and river are drawn uniformly from the remaining 49 cards
+ - antithetic mode: deal 2k+1 is deal 2k with the two hands swapped -> a unit of 2 negatively correlated deals
+ -> source: Owen (2013), "Monte Carlo theory, methods and examples" (stratification, antithetic sampling, QMC)
+
+ Deals are counter based: deal(i) only depends on (seed, i), never on call order or thread.
+ */
+namespace DealSampler {
+
+enum class Mode : uint8_t {
+    Independent = 0,          // 9 uniform cards, single stratum
+    Stratified = 1,           // stratified canonical flop
+    StratifiedAntithetic = 2  // stratified + swapped hands on every second deal
+};
+
+struct Deal {
+    std::array<int, 2> p0hand;
+    std::array<int, 2> p1hand;
+    std::array<int, 5> board;
+    int stratum;
+};
+
+class Sampler {
+public:
+    Sampler(const Bucketer::IsomorphismEngine& engine, uint64_t seed, Mode mode = Mode::Stratified);
+
+    Deal deal(uint64_t index) const;
+
+    Mode mode() const { return samplingMode; }
+
+    // deals that form one independent unit (2 in antithetic mode), callers average a unit before accumulating
+    int dealsPerUnit() const { return samplingMode == Mode::StratifiedAntithetic ? 2 : 1; }
+
+    // probability of each stratum (sums to 1)
+    const std::vector<double>& weights() const { return stratumWeights; }
+
+private:
+    Mode samplingMode;
+    uint64_t seed;
+    double offset;
+    std::vector<std::array<int, 3>> flops;  // canonical flop per stratum
+    std::vector<double> stratumWeights;
+    std::vector<double> cumulative;         // upper end of each stratum in [0, 1)
+
+    int stratumOf(uint64_t unit) const;
+};
+
+/*
+Running stratified mean and standard error.
+ - per stratum count / mean / M2 (Welford), merge = Chan et al. pairwise combination
+ - mean: sum_s w_s * mean_s over the strata seen so far (weights renormalized over them)
+ - standard error: pooled within-stratum variance * sum_s w_s^2 / n_s, strata with a single sample
+   share the pooled variance -> stable even with ~1 sample per stratum
+ - with a single stratum this is the plain sample mean and sqrt(var / n)
+ */
+class StratifiedAccumulator {
+public:
+    explicit StratifiedAccumulator(const std::vector<double>& stratumWeights);
+
+    void add(int stratum, double value);
+    void merge(const StratifiedAccumulator& other);
+
+    uint64_t count() const { return totalCount; }
+    double mean() const;
+    double standardError() const;
+
+    // per-sample variance equivalent to the standard error (n * SE^2), used where a plain sample variance is expected
+    double variance() const;
+
+private:
+    std::vector<double> weights;
+    std::vector<double> counts;
+    std::vector<double> means;
+    std::vector<double> m2s;
+    uint64_t totalCount = 0;
+
+    // all samples pooled, fallback when no stratum has two samples yet
+    double overallMean = 0.0;
+    double overallM2 = 0.0;
+};
+
+}
@@ -0,0 +1,170 @@
+#include "deal_stream.hpp"
+#include "../include/bucket-lookups/lut_indexer.hpp"
+#include "cfr/cfr-core/game_engine.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <system_error>
+#include <utility>
+#include <fcntl.h>
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace DealStream {
+
+namespace {
+
+struct Mapping {
+    void* address = nullptr;
+    size_t length = 0;
+
+    ~Mapping() {
+        if (address) munmap(address, length);
+    }
+};
+
+}
+
+std::vector<Record> sampleDeals(uint64_t numDeals, uint64_t seed) {
+    std::vector<Record> records(numDeals);
+    std::mt19937 rng(seed);
+
+    // same draw as Trainer::train: the first 9 cards of a deck that is never reset
+    std::array<int, 52> deck;
+    for (int i = 0; i < 52; ++i) deck[i] = i;
+
+    for (Record& record : records) {
+        for (int j = 0; j < 9; ++j) {
+            int k = j + rng() % (52 - j);
+            std::swap(deck[j], deck[k]);
+            record.cards[j] = static_cast<uint8_t>(deck[j]);
+        }
+        record.showdown = 0;
+        std::memset(record.buckets, 0, sizeof(record.buckets));
+    }
+    return records;
+}
+
+void resolve(std::vector<Record>& records) {
+    const int64_t n = static_cast<int64_t>(records.size());
+
+    #pragma omp parallel
+    {
+        // lookup_bucket needs a mutable engine -> one per thread
+        Bucketer::IsomorphismEngine engine;
+        engine.initialize();
+
+        #pragma omp for schedule(static)
+        for (int64_t i = 0; i < n; ++i) {
+            Record& record = records[i];
+            std::array<int, 2> hands[2] = {{record.cards[0], record.cards[1]}, {record.cards[2], record.cards[3]}};
+            std::array<int, 5> board = {record.cards[4], record.cards[5], record.cards[6], record.cards[7], record.cards[8]};
+
+            for (int player = 0; player < 2; ++player) {
+                for (int street = 1; street <= 3; ++street) {
+                    // flop 3, turn 4, river 5 board cards
+                    int bucket = Bucketer::lookup_bucket(engine, hands[player].data(), board.data(), street + 2);
+                    record.buckets[player][street - 1] = static_cast<uint16_t>(bucket);
+                }
+            }
+            record.showdown = static_cast<int8_t>(GameEngine::showdownWinner(hands[0], hands[1], board));
+        }
+    }
+}
+
+bool write(const std::vector<Record>& records, uint64_t seed, uint64_t abstractionChecksum, const std::string& path) {
+    Header header{};
+    header.fileMagic = FILE_MAGIC;
+    header.version = VERSION;
+    header.recordSize = sizeof(Record);
+    header.numDeals = records.size();
+    header.seed = seed;
+    header.abstractionChecksum = abstractionChecksum;
+
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        fprintf(stderr, "DealStream: cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+    if (ok && !records.empty()) {
+        ok = fwrite(records.data(), sizeof(Record), records.size(), f) == records.size();
+    }
+    if (fclose(f) != 0 || !ok) {
+        fprintf(stderr, "DealStream: failed to write %s\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool generate(const std::string& path, uint64_t numDeals, uint64_t seed, uint64_t abstractionChecksum) {
+    std::vector<Record> records = sampleDeals(numDeals, seed);
+    resolve(records);
+
+    std::error_code error;
+    std::filesystem::path parent = std::filesystem::path(path).parent_path();
+    if (!parent.empty()) {
+        std::filesystem::create_directories(parent, error);
+    }
+
+    // temporary name per process, the rename publishes the complete file
+    std::string temporary = path + ".tmp." + std::to_string(getpid());
+    if (!write(records, seed, abstractionChecksum, temporary)) {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    std::filesystem::rename(temporary, path, error);
+    if (error) {
+        fprintf(stderr, "DealStream: cannot publish %s (%s)\n", path.c_str(), error.message().c_str());
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+bool Stream::map(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false; // missing file is the normal "not generated yet" case
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header)) {
+        fprintf(stderr, "DealStream: %s is too small for a deal stream\n", path.c_str());
+        close(fd);
+        return false;
+    }
+
+    auto file = std::make_shared<Mapping>();
+    file->length = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, file->length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd); // the mapping keeps the file referenced
+    if (address == MAP_FAILED) {
+        fprintf(stderr, "DealStream: mmap failed for %s\n", path.c_str());
+        return false;
+    }
+    file->address = address;
+
+    Header loaded;
+    std::memcpy(&loaded, address, sizeof(loaded));
+    if (loaded.fileMagic != FILE_MAGIC || loaded.version != VERSION || loaded.recordSize != sizeof(Record)) {
+        fprintf(stderr, "DealStream: %s is not a deal stream (or has another version)\n", path.c_str());
+        return false;
+    }
+    if (loaded.numDeals == 0 || file->length != sizeof(Header) + loaded.numDeals * sizeof(Record)) {
+        fprintf(stderr, "DealStream: empty or truncated deal stream %s\n", path.c_str());
+        return false;
+    }
+
+    header = loaded;
+    records = reinterpret_cast<const Record*>(static_cast<const uint8_t*>(address) + sizeof(Header));
+    mapping = std::shared_ptr<const void>(file, file->address);
+    return true;
+}
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+Precomputed training deals, shared by every trainer of a BO session.
+ Hand buckets and showdown results only depend on the cards, never on the bet abstraction, so they are computed once
+ per deal instead of at every node of every candidate's tree walk (river buckets need the runtime features).
+
+ file layout (memory mappable):
+    [Header]           magic "NAODEAL1", version, record size, deal count, seed, abstraction checksum (64 bytes)
+    [Record deals[n]]  cards in Trainer order (p0 hand, p1 hand, board), showdownWinner, buckets of both players
+
+ - deal sequence: the partial Fisher-Yates over a persistent deck of Trainer::train, driven by std::mt19937(seed) alone
+   (the trainer's own rng also samples actions, so its deals differ between bet abstractions)
+ - a trainer with a stream reads deals first, first + stride, ... and wraps around at the end of the file
+ - abstractionChecksum is written by the caller and compared by the caller (buckets are stale when the LUTs change)
+ */
+namespace DealStream {
+
+static constexpr uint64_t FILE_MAGIC = 0x314C4145444F414EULL; // "NAODEAL1"
+static constexpr uint32_t VERSION = 1;
+
+#pragma pack(push, 1)
+struct Record {
+    uint8_t cards[9];       // p0 hand [0, 1], p1 hand [2, 3], board [4..8]
+    int8_t showdown;        // +1 player 0 wins, -1 player 1 wins, 0 split
+    uint16_t buckets[2][3]; // [player][street - 1]: flop, turn, river
+};
+
+struct Header {
+    uint64_t fileMagic;
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t numDeals;
+    uint64_t seed;
+    uint64_t abstractionChecksum;
+    uint8_t reserved[24];
+};
+#pragma pack(pop)
+static_assert(sizeof(Record) == 22, "Deal Record must be 22 bytes");
+static_assert(sizeof(Header) == 64, "Deal Stream Header must be 64 bytes");
+
+// the first numDeals deals of the sequence, cards only
+std::vector<Record> sampleDeals(uint64_t numDeals, uint64_t seed);
+
+// buckets and showdown of every record (Eval and Bucketer must be initialized), parallel over the records
+void resolve(std::vector<Record>& records);
+
+// false if the file cannot be written
+bool write(const std::vector<Record>& records, uint64_t seed, uint64_t abstractionChecksum, const std::string& path);
+
+// sample + resolve + write, through a temporary file renamed into place (concurrent readers never map a partial file)
+bool generate(const std::string& path, uint64_t numDeals, uint64_t seed, uint64_t abstractionChecksum);
+
+class Stream {
+public:
+    // false if the file is missing, not a deal stream or truncated
+    bool map(const std::string& path);
+
+    uint64_t size() const { return header.numDeals; }
+    uint64_t seed() const { return header.seed; }
+    uint64_t abstractionChecksum() const { return header.abstractionChecksum; }
+
+    // wraps around
+    const Record& operator[](uint64_t index) const {
+        return records[index % header.numDeals];
+    }
+
+private:
+    Header header{};
+    const Record* records = nullptr;
+    std::shared_ptr<const void> mapping;
+};
+
+}
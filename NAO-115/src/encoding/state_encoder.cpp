@@ -1,6 +1,13 @@
 #include "state_encoder.hpp"
 #include "cfr/cfr-core/mccfr_state.hpp"
 #include <array>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace StateEncoder {
 
@@ -37,4 +44,139 @@ std::array<float, 65> encode(const MCCFRState& state, uint64_t boardMask) {
     return input;
 }
 
+// the 13 scalar features of a row, same values as encode()
+static inline void encodeFeatures(const MCCFRState& state, float* row) {
+    for (int s = 0; s < 4; ++s) {
+        row[s] = 0.0f;
+    }
+    row[state.street] = 1.0f;
+    row[4]  = state.raiseCount / MAX_RAISES;
+    row[5]  = state.heroIsSB() ? 1.0f : 0.0f;
+    row[6]  = state.potBase            / MAX_CHIPS_IN_PLAY;
+    row[7]  = state.heroStreetBet      / MAX_CHIPS_IN_PLAY;
+    row[8]  = state.villainStreetBet   / MAX_CHIPS_IN_PLAY;
+    row[9]  = state.heroStack          / MAX_CHIPS_IN_PLAY;
+    row[10] = state.villainStack       / MAX_CHIPS_IN_PLAY;
+    row[11] = state.previousRaiseTotal / MAX_CHIPS_IN_PLAY;
+    row[12] = state.betBeforeRaise     / MAX_CHIPS_IN_PLAY;
+}
+
+/*
+52 mask bits -> 52 floats, one nibble per 4-lane step:
+ broadcast the nibble, test it against lanes {1, 2, 4, 8}, keep 1.0f where the bit is set
+ */
+static inline void expandMask(uint64_t mask, float* out) {
+#if defined(__SSE2__)
+    const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int nibble = 0; nibble < 13; ++nibble) {
+        __m128i bits = _mm_set1_epi32(static_cast<int>((mask >> (4 * nibble)) & 0xF));
+        __m128i set = _mm_cmpeq_epi32(_mm_and_si128(bits, lanes), lanes);
+        _mm_storeu_ps(out + 4 * nibble, _mm_and_ps(_mm_castsi128_ps(set), one));
+    }
+#elif defined(__ARM_NEON)
+    const uint32x4_t lanes = {1, 2, 4, 8};
+    const uint32x4_t one = vreinterpretq_u32_f32(vdupq_n_f32(1.0f));
+    for (int nibble = 0; nibble < 13; ++nibble) {
+        uint32x4_t set = vtstq_u32(vdupq_n_u32(static_cast<uint32_t>((mask >> (4 * nibble)) & 0xF)), lanes);
+        vst1q_f32(out + 4 * nibble, vreinterpretq_f32_u32(vandq_u32(set, one)));
+    }
+#else
+    for (int i = 0; i < 52; ++i) {
+        out[i] = ((mask >> i) & 1ULL) ? 1.0f : 0.0f;
+    }
+#endif
+}
+
+// same for 16-bit lanes, one byte per 8-lane step (48 bits), the last 4 bits one by one
+static inline void expandMask(uint64_t mask, uint16_t one, uint16_t* out) {
+    int done = 0;
+#if defined(__SSE2__)
+    const __m128i lanes = _mm_setr_epi16(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m128i ones = _mm_set1_epi16(static_cast<short>(one));
+    for (; done < 48; done += 8) {
+        __m128i bits = _mm_set1_epi16(static_cast<short>((mask >> done) & 0xFF));
+        __m128i set = _mm_cmpeq_epi16(_mm_and_si128(bits, lanes), lanes);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + done), _mm_and_si128(set, ones));
+    }
+#elif defined(__ARM_NEON)
+    const uint16x8_t lanes = {1, 2, 4, 8, 16, 32, 64, 128};
+    const uint16x8_t ones = vdupq_n_u16(one);
+    for (; done < 48; done += 8) {
+        uint16x8_t set = vtstq_u16(vdupq_n_u16(static_cast<uint16_t>((mask >> done) & 0xFF)), lanes);
+        vst1q_u16(out + done, vandq_u16(set, ones));
+    }
+#endif
+    for (int i = done; i < 52; ++i) {
+        out[i] = ((mask >> i) & 1ULL) ? one : 0;
+    }
+}
+
+void encodeBatch(const MCCFRState* states, const uint64_t* boardMasks, size_t n, float* out) {
+    for (size_t i = 0; i < n; ++i) {
+        float* row = out + i * INPUT_SIZE;
+        encodeFeatures(states[i], row);
+        expandMask(boardMasks[i], row + BOARD_OFFSET);
+    }
+}
+
+void encodeBatch(const MCCFRState* states, const uint64_t* boardMasks, size_t n, uint16_t* out, HalfFormat format) {
+    const bool bfloat = format == HalfFormat::BFloat16;
+    const uint16_t one = bfloat ? toBFloat16(1.0f) : toFloat16(1.0f);
+
+    float features[BOARD_OFFSET];
+    for (size_t i = 0; i < n; ++i) {
+        uint16_t* row = out + i * INPUT_SIZE;
+        encodeFeatures(states[i], features);
+        for (size_t f = 0; f < BOARD_OFFSET; ++f) {
+            row[f] = bfloat ? toBFloat16(features[f]) : toFloat16(features[f]);
+        }
+        expandMask(boardMasks[i], one, row + BOARD_OFFSET);
+    }
+}
+
+uint16_t toBFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if ((bits & 0x7FFFFFFFu) > 0x7F800000u) {
+        return static_cast<uint16_t>((bits >> 16) | 0x40); // NaN stays a (quiet) NaN
+    }
+    bits += 0x7FFFu + ((bits >> 16) & 1u);
+    return static_cast<uint16_t>(bits >> 16);
+}
+
+uint16_t toFloat16(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+    // NaN / infinity / overflow
+    if (magnitude >= 0x7F800000u) {
+        return sign | 0x7C00u | (magnitude > 0x7F800000u ? 0x200u : 0u);
+    }
+    if (magnitude >= 0x477FF000u) {
+        return sign | 0x7C00u; // rounds past 65504
+    }
+
+    const int exponent = static_cast<int>(magnitude >> 23) - 127 + 15;
+    uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+
+    if (exponent <= 0) {
+        // subnormal half (or zero)
+        if (exponent < -10) return sign;
+        const int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1u);
+        const uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) ++half;
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | ((mantissa >> 13) & 0x3FFu);
+    const uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) ++half; // a carry into the exponent is still correct
+    return sign | static_cast<uint16_t>(half);
+}
+
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include "cfr/cfr-core/mccfr_state.hpp"
 
@@ -51,4 +52,25 @@ Layout:
 */
 std::array<float, 65> encode(const MCCFRState& state, uint64_t boardMask);
 
+constexpr size_t INPUT_SIZE = 65;
+constexpr size_t BOARD_OFFSET = 13;
+
+enum class HalfFormat : uint8_t {
+    Float16 = 0,  // IEEE 754 binary16
+    BFloat16 = 1  // upper half of a float32
+};
+
+/*
+Batched encode for network training data and value net inference.
+ - out: row-major n x INPUT_SIZE buffer, row i holds encode(states[i], boardMasks[i])
+ - board bits are expanded 4 floats (8 halves) per instruction with SSE2 / NEON, scalar on other targets
+ - the 16-bit version writes fp16 / bf16 bit patterns (round to nearest even) -> half the bytes per row
+*/
+void encodeBatch(const MCCFRState* states, const uint64_t* boardMasks, size_t n, float* out);
+void encodeBatch(const MCCFRState* states, const uint64_t* boardMasks, size_t n, uint16_t* out, HalfFormat format);
+
+// float32 -> 16-bit patterns, round to nearest even
+uint16_t toFloat16(float value);
+uint16_t toBFloat16(float value);
+
 }
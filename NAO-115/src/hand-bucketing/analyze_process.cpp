@@ -10,6 +10,7 @@
 #include <numeric>
 #include <string>
 #include <limits>
+#include <omp.h>
 
 
 namespace Bucketer {
@@ -26,114 +27,33 @@ DataDistributionLogger::~DataDistributionLogger() {
     if (file_.is_open()) file_.close();
 }
 
-// helpers
-
-/*
-using the two-pass algorithm for calculating variance to avoid roundoff errors
-source: Higham, Nicholas J. (2002). "Problem 1.10".
-https://epubs.siam.org/doi/book/10.1137/1.9780898718027
-*/
-
-float DataDistributionLogger::calculateVariance(const std::vector<float>& dataset, float mean) {
-    double sumOfSqDifferences = 0.0;
-    size_t n = dataset.size();
-    
-    for (float value : dataset) {
-        double difference = value - mean;
-        sumOfSqDifferences += difference * difference;
-    }
-    
-    if (n > 1) {
-        // Bessel's Correction for sample size (n - 1 division)
-        return static_cast<float>(sumOfSqDifferences / (n - 1));
-    } else {
-        return 0.0f;
-    }
-}
-
-float DataDistributionLogger::findMedian(std::vector<float> dataset) {
-    if(dataset.empty()) {
-        return 0.0f;
-    }
-    
-    size_t n = dataset.size();
-    std::sort(dataset.begin(), dataset.end());
-    
-    if (n % 2 != 0) {
-        return dataset[n / 2];
-    } else {
-        return (dataset[(n - 1) / 2] + dataset[n / 2]) / 2.0f;
-    }
-}
-
-int DataDistributionLogger::getBinIndex(float value, float min_v, float range, int num_bins) {
-    if (range < 1e-9) return 0;
-    int bin = static_cast<int>((value - min_v) / range * (num_bins - 0.001f));
-    if (bin < 0) bin = 0;
-    if (bin >= num_bins) bin = num_bins - 1;
-    return bin;
-}
-
-std::pair<float, float> DataDistributionLogger::calculateMeanVariance(const std::vector<float>& inputVector) {
-    
-    if (inputVector.empty()) {
-        return {0.0f, 0.0f};
-    }
-    
-    double sum = 0;
-    
-    for (float value : inputVector) {
-        sum += value;
-    }
-    
-    float mean = sum / inputVector.size();
-    float variance = calculateVariance(inputVector, mean);
-    
-    return { mean, variance };
-}
-
 // core loggers
+// all of them read from a single FeatureAccumulator, the dataset itself is never copied or rescanned
 
-void DataDistributionLogger::logMoments(const std::vector<std::vector<float>>& features,
+void DataDistributionLogger::logMoments(const FeatureAccumulator& stats,
                 std::vector<double>& means,
                 std::vector<double>& stds) {
     file_ << "1.1 Moments & Shape\n";
     file_ << "Feature, Mean, StdDev, Skew, Kurtosis\n";
     
-    size_t num_features = features.size();
+    size_t num_features = stats.numFeatures();
     
     means.resize(num_features);
     stds.resize(num_features);
     
     for (size_t f = 0; f < num_features; ++f) {
-        // calculate mean & variance through external helper
-        std::pair<float, float> moments = calculateMeanVariance(features[f]);
-        means[f] = moments.first;
-        float variance = moments.second;
+        // Welford moments from the accumulator (sample variance, Bessel's correction)
+        means[f] = stats.mean(f);
+        double variance = stats.variance(f);
         // calculate standard deviation (square root of variance)
         stds[f] = std::sqrt(variance);
         
-        // calculate higher moments for skew and kurtosis
-        double m3_sum = 0.0;
-        double m4_sum = 0.0;
-        int N = static_cast<int>(features[f].size());
-        
-        for (float value : features[f]) {
-            double deviation = value - means[f];
-            m3_sum += deviation * deviation * deviation;
-            m4_sum += deviation * deviation * deviation * deviation;
-        }
-        
-        double m3 = m3_sum / N;
-        double m4 = m4_sum / N;
+        // higher central moments for skew and kurtosis
+        double m3 = stats.centralMoment3(f);
+        double m4 = stats.centralMoment4(f);
         double skew = 0.0;
         double kurtosis = 0.0;
         
-        if (N > 0) {
-            m3 = m3_sum / N;
-            m4 = m4_sum / N;
-        }
-        
         if (variance > 1e-9) {
             skew = m3 / std::pow(stds[f], 3);
             kurtosis = (m4 / (variance * variance)) - 3.0;
@@ -143,7 +63,7 @@ void DataDistributionLogger::logMoments(const std::vector<std::vector<float>>& f
     }
 }
 
-void DataDistributionLogger::logOutliers(const std::vector<std::vector<float>>& features,
+void DataDistributionLogger::logOutliers(const FeatureAccumulator& stats,
                  const std::vector<double>& means,
                  const std::vector<double>& stds,
                  const std::vector<std::string>& labels)
@@ -152,19 +72,20 @@ void DataDistributionLogger::logOutliers(const std::vector<std::vector<float>>&
     
     file_ << "1.2 Extreme Values & Histograms (Statistical Analysis)\n";
     
-    size_t N = features[0].size();
-    size_t num_features = features.size();
+    size_t N = stats.count();
+    size_t num_features = stats.numFeatures();
     
     // calculate Rice's rule for binning (formula: k = 2 * N^(1/3))
     int rice_count = static_cast<int>(2.0 * std::pow(N, 1.0/3.0));
     
     file_ << "Binning Logic: \n";
     file_ << "  * Visual Bins: 50 (Fixed 2% resolution for readability)\n";
-    file_ << "  * Rice's Rule: " << rice_count << " (Optimal for N = " << N << ")\n\n";
+    file_ << "  * Rice's Rule: " << rice_count << " (Optimal for N = " << N << ")\n";
+    file_ << "  * Counts re-binned from a 4000-bin streaming histogram (0.0005 resolution)\n\n";
     
     for (size_t f = 0; f < num_features; ++f) {
-        float min_v = *std::min_element(features[f].begin(), features[f].end());
-        float max_v = *std::max_element(features[f].begin(), features[f].end());
+        float min_v = stats.min(f);
+        float max_v = stats.max(f);
         float range = (max_v - min_v > 1e-9) ? (max_v - min_v) : 1.0f;
         
         float mid_low;
@@ -185,33 +106,14 @@ void DataDistributionLogger::logOutliers(const std::vector<std::vector<float>>&
         float thresh_low = mean - (2.0 * std_dev);
         float thresh_high = mean + (2.0 * std_dev);
         
-        // prepare bins
-        std::vector<int> visualBins(50, 0);       // for research visualisation
-        std::vector<int> riceBins(rice_count, 0); // for true statistical analysis
-        
-        int low_sigma_count = 0; // over 2 sigma, lowest
-        int high_sigma_count = 0; // over 2 sigma, highest
-        int mid_band_count = 0; // middle 10%
+        // extremes and middle band are read from the fine histogram
+        uint64_t low_sigma_count = stats.countBelow(f, thresh_low); // over 2 sigma, lowest
+        uint64_t high_sigma_count = stats.countAbove(f, thresh_high); // over 2 sigma, highest
+        uint64_t mid_band_count = stats.countBetween(f, mid_low, mid_high); // middle 10%
         
-        // data loop
-        for (float v : features[f]) {
-            // count extremes
-            if (v < thresh_low) {
-                low_sigma_count++;
-            }
-            if (v > thresh_high) {
-                high_sigma_count++;
-            }
-            if (v >= mid_low && v <= mid_high) {
-                mid_band_count++;
-            }
-            
-            // populate visual histogram
-            visualBins[getBinIndex(v, min_v, range, 50)]++;
-            
-            // populate Rice histogram
-            riceBins[getBinIndex(v, min_v, range, rice_count)]++;
-        }
+        // for research visualisation & true statistical analysis
+        std::vector<int> visualBins = stats.histogram(f, min_v, range, 50);
+        std::vector<int> riceBins = stats.histogram(f, min_v, range, rice_count);
         
         file_ << "--- Feature: " << labels[f] << " ---\n";
         file_ << "Range: [" << min_v << ", " << max_v << "]\n";
@@ -242,45 +144,35 @@ void DataDistributionLogger::logOutliers(const std::vector<std::vector<float>>&
     file_.flush();
 }
 
-void DataDistributionLogger::logQuantiles(std::vector<std::vector<float>> features, const std::vector<std::string>& labels) {
+void DataDistributionLogger::logQuantiles(const FeatureAccumulator& stats, const std::vector<std::string>& labels) {
     file_ << "1.3 Quantiles (Distribution Shape)\n";
     file_ << "Feature, Min, P1, P5, P25, Median, P75, P95, P99, Max\n";
     
-    size_t N = features[0].size();
-    size_t num_features = features.size();
+    size_t num_features = stats.numFeatures();
     
     for (size_t f = 0; f < num_features; ++f) {
-        // sort the feature data locally
-        std::sort(features[f].begin(), features[f].end());
-        
-        // quantiles computed as floor(q * N) on sorted data (empirical CDF)
-        auto qidx = [&](double q) {
-            return std::min(static_cast<size_t>(q * N), N - 1);
-        };
-        
+        // interior quantiles come from the KLL sketch, the extremes are tracked exactly
         file_ << labels[f] << ", "
-             << features[f][qidx(0.00)] << ", "
-             << features[f][qidx(0.01)] << ", "
-             << features[f][qidx(0.05)] << ", "
-             << features[f][qidx(0.25)] << ", "
-             << features[f][qidx(0.50)] << ", "
-             << features[f][qidx(0.75)] << ", "
-             << features[f][qidx(0.95)] << ", "
-             << features[f][qidx(0.99)] << ", "
-             << features[f][N - 1] << "\n";
+             << stats.min(f) << ", "
+             << stats.quantile(f, 0.01) << ", "
+             << stats.quantile(f, 0.05) << ", "
+             << stats.quantile(f, 0.25) << ", "
+             << stats.quantile(f, 0.50) << ", "
+             << stats.quantile(f, 0.75) << ", "
+             << stats.quantile(f, 0.95) << ", "
+             << stats.quantile(f, 0.99) << ", "
+             << stats.max(f) << "\n";
     }
     file_ << "\n";
 }
 
-void DataDistributionLogger::logCorrelationAndPCA(const std::vector<std::vector<float>>& data,
-                          const std::vector<double>& means,
+void DataDistributionLogger::logCorrelationAndPCA(const FeatureAccumulator& stats,
                           const std::vector<double>& stds,
                           const std::vector<std::string>& labels)
 {
     
     file_ << "1.4 Correlation & PCA\n";
-    size_t N = data.size();
-    int n = static_cast<int>(data[0].size());
+    int n = stats.numFeatures();
     
     // verify label name input correctness
     if (labels.size() != static_cast<size_t>(n)) {
@@ -288,22 +180,11 @@ void DataDistributionLogger::logCorrelationAndPCA(const std::vector<std::vector<
         return;
     }
     
-    // compute covariance matrix
+    // covariance matrix comes straight from the accumulated co-moments
     std::vector<std::vector<double>> cov(n, std::vector<double>(n, 0.0));
-    
-    // accumulate sums of products
-    for (size_t i = 0; i < N; i++) {
-        for (int r = 0; r < n; r++) {
-            for (int c = 0; c < n; c++) {
-                cov[r][c] += (static_cast<double>(data[i][r]) - means[r]) * (static_cast<double>(data[i][c]) - means[c]);
-            }
-        }
-    }
-    
-    // divide once to finalize covariance matrix
     for (int r = 0; r < n; r++) {
         for (int c = 0; c < n; c++) {
-            cov[r][c] /= (N - 1);
+            cov[r][c] = stats.covariance(r, c);
         }
     }
     
@@ -396,10 +277,18 @@ void DataDistributionLogger::logDistribution(int street, const std::vector<std::
     file_ << ">>> Data Distribution: Street " << street << " <<<\n";
     file_ << "Sample size: " << data.size() << " samples\n\n";
     
-    // transpose data
-    std::vector<std::vector<float>> features(NUM_FEATURES, std::vector<float>(data.size()));
-    for (int i = 0; i < data.size(); ++i) {
-        for (int f = 0; f < NUM_FEATURES; ++f) features[f][i] = data[i][f];
+    // single pass over the samples: one accumulator per thread, merged afterwards in thread order
+    int num_threads = omp_get_max_threads();
+    std::vector<FeatureAccumulator> localStats(num_threads, FeatureAccumulator(NUM_FEATURES));
+    
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < static_cast<long long>(data.size()); ++i) {
+        localStats[omp_get_thread_num()].add(data[i].data());
+    }
+    
+    FeatureAccumulator stats(NUM_FEATURES);
+    for (const auto& local : localStats) {
+        stats.merge(local);
     }
     
     // prepare stat containers
@@ -413,10 +302,10 @@ void DataDistributionLogger::logDistribution(int street, const std::vector<std::
     }
     
     // run loggers
-    logMoments(features, shared_means, shared_stds);
-    logOutliers(features, shared_means, shared_stds, currentLabels);
-    logQuantiles(features, currentLabels);
-    logCorrelationAndPCA(data, shared_means, shared_stds, currentLabels);
+    logMoments(stats, shared_means, shared_stds);
+    logOutliers(stats, shared_means, shared_stds, currentLabels);
+    logQuantiles(stats, currentLabels);
+    logCorrelationAndPCA(stats, shared_stds, currentLabels);
 }
 
 // K-MEANS CONVERGENCE (class: KMeansLogger)
@@ -3,6 +3,7 @@
 #include <array>
 #include <string>
 #include <fstream>
+#include "streaming_stats.hpp"
 
 namespace Bucketer {
 
@@ -18,21 +19,15 @@ public:
 private:
     std::ofstream file_;
 
-    float calculateVariance(const std::vector<float>& dataset, float mean);
-    float findMedian(std::vector<float> dataset);
-    std::pair<float, float> calculateMeanVariance(const std::vector<float>& inputVector);
-    int getBinIndex(float value, float min_v, float range, int num_bins);
-
-    void logMoments(const std::vector<std::vector<float>>& features,
+    void logMoments(const FeatureAccumulator& stats,
                     std::vector<double>& means,
                     std::vector<double>& stds);
-    void logOutliers(const std::vector<std::vector<float>>& features,
+    void logOutliers(const FeatureAccumulator& stats,
                      const std::vector<double>& means,
                      const std::vector<double>& stds,
                      const std::vector<std::string>& labels);
-    void logQuantiles(std::vector<std::vector<float>> features, const std::vector<std::string>& labels);
-    void logCorrelationAndPCA(const std::vector<std::vector<float>>& data,
-                              const std::vector<double>& means,
+    void logQuantiles(const FeatureAccumulator& stats, const std::vector<std::string>& labels);
+    void logCorrelationAndPCA(const FeatureAccumulator& stats,
                               const std::vector<double>& stds,
                               const std::vector<std::string>& labels);
 };
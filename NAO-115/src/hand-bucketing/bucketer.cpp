@@ -534,16 +534,13 @@ void initialize() {
         return;
     }
     std::filesystem::current_path("/Users/macbook/Documents/NAO-115");
-    std::ifstream in("output/data/centroids/centroids.dat", std::ios::binary);
+    std::ifstream in(CENTROIDS_FILE, std::ios::binary);
     if (!in.is_open()) {
         std::cerr << "Error: Could not open centroids.dat\n";
         exit(1);
     }
     
-    bool luts_ok = load_luts(
-        "output/data/luts/flop_buckets.lut",
-        "output/data/luts/turn_buckets.lut"
-    );
+    bool luts_ok = load_luts(FLOP_LUT_FILE, TURN_LUT_FILE);
     
     if (!luts_ok) {
         std::cerr << "Error: Could not load LUT files\n";
@@ -29,6 +29,12 @@ void generate_centroids();
 
 // runtime lookups
 void initialize();
+
+// abstraction files read by initialize() (relative to the project root it switches to)
+inline constexpr const char* CENTROIDS_FILE = "output/data/centroids/centroids.dat";
+inline constexpr const char* FLOP_LUT_FILE  = "output/data/luts/flop_buckets.lut";
+inline constexpr const char* TURN_LUT_FILE  = "output/data/luts/turn_buckets.lut";
+
 int get_preflop_bucket(const std::array<int, 2>& hand);
 int get_river_bucket(const std::array<int, 2>& hand, const std::array<int, 5>& board);
 
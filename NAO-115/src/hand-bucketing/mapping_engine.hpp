@@ -23,6 +23,7 @@ class IsomorphismEngine {
 private:
     hand_indexer_t flop_indexer;
     hand_indexer_t turn_indexer;
+    hand_indexer_t board_flop_indexer; // board only (3 cards), 1755 suit-isomorphic flops
     
     bool is_initialized = false;
     
@@ -32,6 +33,7 @@ public:
         if (is_initialized) {
             hand_indexer_free(&flop_indexer);
             hand_indexer_free(&turn_indexer);
+            hand_indexer_free(&board_flop_indexer);
         }
     }
     
@@ -51,6 +53,12 @@ public:
             throw std::runtime_error("Turn indexer initializing failed");
         }
         
+        // flop board alone - 3 cards, no hole cards (public tree walks)
+        uint8_t board_flop_cards_per_round[] = {3};
+        if (!hand_indexer_init(1, board_flop_cards_per_round, &board_flop_indexer)) {
+            throw std::runtime_error("Board flop indexer initializing failed");
+        }
+        
         is_initialized = true;
     }
     
@@ -75,6 +83,22 @@ public:
         return cards;
     }
     
+    // number of suit-isomorphic flop boards (1755)
+    uint64_t getBoardFlopCombinations() const {
+        return is_initialized ? hand_indexer_size(&board_flop_indexer, 0) : 0;
+    }
+    
+    std::array<uint8_t, 3> unindexBoardFlop(uint64_t idx) const {
+        std::array<uint8_t, 3> cards;
+        hand_unindex(&board_flop_indexer, 0, idx, cards.data());
+        return cards;
+    }
+    
+    // maps a 3-card flop board into its canonical index
+    uint64_t getBoardFlopIndex(const std::array<uint8_t, 3>& cards) const {
+        return hand_index_last(&board_flop_indexer, cards.data());
+    }
+    
     // maps 5-card flop combination into its unique Waugh Index
     uint64_t getFlopIndex(const std::array<uint8_t, 5>& cards) const {
         return hand_index_last(&flop_indexer, cards.data());
@@ -0,0 +1,332 @@
+#include "streaming_stats.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace Bucketer {
+
+// QUANTILE SKETCH (KLL)
+
+QuantileSketch::QuantileSketch(int k, uint64_t seed)
+: k_(k), n_(0), rngState_(seed ? seed : 1), levels_(1) {}
+
+// capacity decays geometrically (factor 2/3) from the top level down, never below 2
+int QuantileSketch::capacity(int level) const {
+    int depth = static_cast<int>(levels_.size()) - 1 - level;
+    int cap = static_cast<int>(std::ceil(k_ * std::pow(2.0 / 3.0, depth)));
+    return std::max(cap, 2);
+}
+
+bool QuantileSketch::flipCoin() {
+    // xorshift64
+    rngState_ ^= rngState_ << 13;
+    rngState_ ^= rngState_ >> 7;
+    rngState_ ^= rngState_ << 17;
+    return (rngState_ & 1ULL) != 0;
+}
+
+void QuantileSketch::compress() {
+    for (size_t h = 0; h < levels_.size(); ++h) {
+        if (static_cast<int>(levels_[h].size()) < capacity(static_cast<int>(h))) {
+            continue;
+        }
+
+        if (h + 1 == levels_.size()) {
+            levels_.emplace_back();
+        }
+
+        std::vector<float>& level = levels_[h];
+        std::sort(level.begin(), level.end());
+
+        // an odd leftover stays on this level so the total weight is preserved exactly
+        float leftover = 0.0f;
+        bool hasLeftover = (level.size() % 2) != 0;
+        if (hasLeftover) {
+            leftover = level.back();
+            level.pop_back();
+        }
+
+        size_t offset = flipCoin() ? 1 : 0;
+        std::vector<float>& upper = levels_[h + 1];
+        for (size_t i = offset; i < level.size(); i += 2) {
+            upper.push_back(level[i]);
+        }
+
+        level.clear();
+        if (hasLeftover) {
+            level.push_back(leftover);
+        }
+    }
+}
+
+void QuantileSketch::add(float value) {
+    levels_[0].push_back(value);
+    n_++;
+    if (static_cast<int>(levels_[0].size()) >= capacity(0)) {
+        compress();
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.levels_.size() > levels_.size()) {
+        levels_.resize(other.levels_.size());
+    }
+    for (size_t h = 0; h < other.levels_.size(); ++h) {
+        levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+    }
+    n_ += other.n_;
+    compress();
+}
+
+float QuantileSketch::quantile(double q) const {
+    std::vector<std::pair<float, uint64_t>> weighted;
+    uint64_t totalWeight = 0;
+
+    for (size_t h = 0; h < levels_.size(); ++h) {
+        uint64_t weight = 1ULL << h;
+        for (float v : levels_[h]) {
+            weighted.emplace_back(v, weight);
+            totalWeight += weight;
+        }
+    }
+
+    if (weighted.empty()) {
+        return 0.0f;
+    }
+
+    std::sort(weighted.begin(), weighted.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    // same convention as the old sorted-vector version: element at floor(q * N)
+    q = std::min(std::max(q, 0.0), 1.0);
+    uint64_t targetRank = static_cast<uint64_t>(q * static_cast<double>(totalWeight));
+    uint64_t cumulative = 0;
+    for (const auto& [value, weight] : weighted) {
+        cumulative += weight;
+        if (cumulative > targetRank) {
+            return value;
+        }
+    }
+    return weighted.back().first;
+}
+
+// FEATURE ACCUMULATOR
+
+FeatureAccumulator::FeatureAccumulator(int numFeatures, float histMin, float histMax, int histBins)
+: numFeatures_(numFeatures),
+  n_(0),
+  mean_(numFeatures, 0.0),
+  m2_(numFeatures, 0.0),
+  m3_(numFeatures, 0.0),
+  m4_(numFeatures, 0.0),
+  coMoment_(static_cast<size_t>(numFeatures) * numFeatures, 0.0),
+  min_(numFeatures, std::numeric_limits<float>::max()),
+  max_(numFeatures, std::numeric_limits<float>::lowest()),
+  histMin_(histMin),
+  histMax_(histMax),
+  histBins_(histBins),
+  binWidth_((histMax - histMin) / histBins),
+  hist_(static_cast<size_t>(numFeatures) * (histBins + 2), 0),
+  delta_(numFeatures, 0.0)
+{
+    sketches_.reserve(numFeatures);
+    for (int f = 0; f < numFeatures; ++f) {
+        // distinct coin streams per feature
+        sketches_.emplace_back(1000, 0x9E3779B97F4A7C15ULL + static_cast<uint64_t>(f));
+    }
+}
+
+// slot 0 = underflow, slots 1..histBins = regular bins, histBins + 1 = overflow
+int FeatureAccumulator::fineBin(float value) const {
+    if (value < histMin_) {
+        return 0;
+    }
+    if (value >= histMax_) {
+        return value == histMax_ ? histBins_ : histBins_ + 1;
+    }
+    int bin = static_cast<int>((value - histMin_) / binWidth_);
+    return std::min(bin, histBins_ - 1) + 1;
+}
+
+float FeatureAccumulator::fineBinCenter(int slot) const {
+    return histMin_ + (static_cast<float>(slot - 1) + 0.5f) * binWidth_;
+}
+
+void FeatureAccumulator::add(const float* sample) {
+    uint64_t n1 = n_;
+    n_++;
+    double n = static_cast<double>(n_);
+
+    // co-moments need the deviation from the OLD mean (before this sample)
+    for (int f = 0; f < numFeatures_; ++f) {
+        delta_[f] = sample[f] - mean_[f];
+    }
+
+    double weight = static_cast<double>(n1) / n;
+    for (int r = 0; r < numFeatures_; ++r) {
+        for (int c = r; c < numFeatures_; ++c) {
+            coMoment_[r * numFeatures_ + c] += weight * delta_[r] * delta_[c];
+        }
+    }
+
+    for (int f = 0; f < numFeatures_; ++f) {
+        double x = sample[f];
+        double delta = delta_[f];
+        double deltaN = delta / n;
+        double deltaN2 = deltaN * deltaN;
+        double term1 = delta * deltaN * static_cast<double>(n1);
+
+        // order matters: M4 uses old M3/M2, M3 uses old M2
+        mean_[f] += deltaN;
+        m4_[f] += term1 * deltaN2 * (n * n - 3.0 * n + 3.0) + 6.0 * deltaN2 * m2_[f] - 4.0 * deltaN * m3_[f];
+        m3_[f] += term1 * deltaN * (n - 2.0) - 3.0 * deltaN * m2_[f];
+        m2_[f] += term1;
+
+        min_[f] = std::min(min_[f], static_cast<float>(x));
+        max_[f] = std::max(max_[f], static_cast<float>(x));
+
+        sketches_[f].add(static_cast<float>(x));
+        hist_[static_cast<size_t>(f) * (histBins_ + 2) + fineBin(static_cast<float>(x))]++;
+    }
+}
+
+void FeatureAccumulator::merge(const FeatureAccumulator& other) {
+    if (other.n_ == 0) {
+        return;
+    }
+    if (n_ == 0) {
+        *this = other;
+        return;
+    }
+
+    double na = static_cast<double>(n_);
+    double nb = static_cast<double>(other.n_);
+    double n = na + nb;
+
+    for (int f = 0; f < numFeatures_; ++f) {
+        delta_[f] = other.mean_[f] - mean_[f];
+    }
+
+    for (int r = 0; r < numFeatures_; ++r) {
+        for (int c = r; c < numFeatures_; ++c) {
+            size_t idx = static_cast<size_t>(r) * numFeatures_ + c;
+            coMoment_[idx] += other.coMoment_[idx] + delta_[r] * delta_[c] * na * nb / n;
+        }
+    }
+
+    for (int f = 0; f < numFeatures_; ++f) {
+        double d = delta_[f];
+        double d2 = d * d;
+        double m2a = m2_[f], m2b = other.m2_[f];
+        double m3a = m3_[f], m3b = other.m3_[f];
+
+        m4_[f] += other.m4_[f]
+                + d2 * d2 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+                + 6.0 * d2 * (na * na * m2b + nb * nb * m2a) / (n * n)
+                + 4.0 * d * (na * m3b - nb * m3a) / n;
+        m3_[f] += m3b
+                + d2 * d * na * nb * (na - nb) / (n * n)
+                + 3.0 * d * (na * m2b - nb * m2a) / n;
+        m2_[f] += m2b + d2 * na * nb / n;
+        mean_[f] += d * nb / n;
+
+        min_[f] = std::min(min_[f], other.min_[f]);
+        max_[f] = std::max(max_[f], other.max_[f]);
+        sketches_[f].merge(other.sketches_[f]);
+    }
+
+    for (size_t i = 0; i < hist_.size(); ++i) {
+        hist_[i] += other.hist_[i];
+    }
+
+    n_ += other.n_;
+}
+
+double FeatureAccumulator::variance(int f) const {
+    return n_ > 1 ? m2_[f] / static_cast<double>(n_ - 1) : 0.0;
+}
+
+double FeatureAccumulator::centralMoment3(int f) const {
+    return n_ > 0 ? m3_[f] / static_cast<double>(n_) : 0.0;
+}
+
+double FeatureAccumulator::centralMoment4(int f) const {
+    return n_ > 0 ? m4_[f] / static_cast<double>(n_) : 0.0;
+}
+
+double FeatureAccumulator::covariance(int r, int c) const {
+    if (n_ < 2) {
+        return 0.0;
+    }
+    if (r > c) {
+        std::swap(r, c);
+    }
+    return coMoment_[static_cast<size_t>(r) * numFeatures_ + c] / static_cast<double>(n_ - 1);
+}
+
+uint64_t FeatureAccumulator::countBelow(int f, float threshold) const {
+    const uint64_t* hist = featureHist(f);
+    uint64_t total = 0;
+    for (int slot = 0; slot < histBins_ + 2; ++slot) {
+        float center = (slot == 0) ? histMin_ - binWidth_
+                     : (slot == histBins_ + 1) ? histMax_ + binWidth_
+                     : fineBinCenter(slot);
+        if (center < threshold) {
+            total += hist[slot];
+        }
+    }
+    return total;
+}
+
+uint64_t FeatureAccumulator::countAbove(int f, float threshold) const {
+    const uint64_t* hist = featureHist(f);
+    uint64_t total = 0;
+    for (int slot = 0; slot < histBins_ + 2; ++slot) {
+        float center = (slot == 0) ? histMin_ - binWidth_
+                     : (slot == histBins_ + 1) ? histMax_ + binWidth_
+                     : fineBinCenter(slot);
+        if (center > threshold) {
+            total += hist[slot];
+        }
+    }
+    return total;
+}
+
+uint64_t FeatureAccumulator::countBetween(int f, float low, float high) const {
+    const uint64_t* hist = featureHist(f);
+    uint64_t total = 0;
+    for (int slot = 1; slot <= histBins_; ++slot) {
+        float center = fineBinCenter(slot);
+        if (center >= low && center <= high) {
+            total += hist[slot];
+        }
+    }
+    return total;
+}
+
+std::vector<int> FeatureAccumulator::histogram(int f, float low, float range, int bins) const {
+    std::vector<int> out(bins, 0);
+    if (bins <= 0) {
+        return out;
+    }
+
+    const uint64_t* hist = featureHist(f);
+    for (int slot = 0; slot < histBins_ + 2; ++slot) {
+        if (hist[slot] == 0) {
+            continue;
+        }
+
+        int bin = 0;
+        if (slot == histBins_ + 1) {
+            bin = bins - 1;
+        } else if (slot > 0 && range >= 1e-9f) {
+            bin = static_cast<int>((fineBinCenter(slot) - low) / range * (bins - 0.001f));
+            bin = std::max(0, std::min(bin, bins - 1));
+        }
+        out[bin] += static_cast<int>(hist[slot]);
+    }
+    return out;
+}
+
+}
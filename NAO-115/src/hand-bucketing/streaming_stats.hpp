@@ -0,0 +1,111 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace Bucketer {
+
+/*
+Mergeable streaming quantile sketch (KLL - Karnin, Lang & Liberty, 2016).
+ -> source: https://arxiv.org/abs/1603.05346
+
+ - keeps a hierarchy of compactors, level h holds items with weight 2^h
+ - when a level overflows it is sorted and every second item (random offset) is promoted one level up
+ - rank error shrinks like 1 / k, k = 1000 keeps P1 / P99 within ~0.2% rank on any sample size, memory stays O(k)
+ - two sketches can be merged by concatenating their levels and compacting again (parallel friendly)
+ */
+class QuantileSketch {
+public:
+    explicit QuantileSketch(int k = 1000, uint64_t seed = 0x9E3779B97F4A7C15ULL);
+
+    void add(float value);
+    void merge(const QuantileSketch& other);
+
+    // approximate value at quantile q in [0, 1]
+    float quantile(double q) const;
+    uint64_t count() const { return n_; }
+
+private:
+    int k_;
+    uint64_t n_;
+    uint64_t rngState_; // xorshift state for the compaction coin, seeded for reproducible logs
+    std::vector<std::vector<float>> levels_;
+
+    int capacity(int level) const;
+    void compress();
+    bool flipCoin();
+};
+
+/*
+One-pass, mergeable statistics accumulator over fixed-width feature vectors.
+ Replaces the old transpose + multi-scan logic of DataDistributionLogger.
+
+ Tracked per feature:
+ - count, mean, M2, M3, M4 (Welford / Pebay update, numerically stable, no second pass)
+ - exact min and max
+ - KLL quantile sketch
+ - fine fixed-bin histogram over [histMin, histMax] (+ under/overflow), coarse histograms are re-binned from it
+ Tracked across features:
+ - co-moment matrix (covariance * (n - 1)) for correlation & PCA
+
+ merge() follows Pebay (2008) "Formulas for Robust, One-Pass Parallel Computation of
+ Covariances and Arbitrary-Order Statistical Moments", Sandia Report SAND2008-6212.
+ */
+class FeatureAccumulator {
+public:
+    // all Nao bucketing features are bounded in [-1, 1] -> default histogram range covers them
+    explicit FeatureAccumulator(int numFeatures,
+                                float histMin = -1.0f,
+                                float histMax = 1.0f,
+                                int histBins = 4000);
+
+    void add(const float* sample);
+    void merge(const FeatureAccumulator& other);
+
+    int numFeatures() const { return numFeatures_; }
+    uint64_t count() const { return n_; }
+
+    double mean(int f) const { return mean_[f]; }
+    double variance(int f) const; // sample variance (Bessel's correction)
+    double centralMoment3(int f) const; // M3 / n
+    double centralMoment4(int f) const; // M4 / n
+    double covariance(int r, int c) const; // sample covariance
+    float min(int f) const { return min_[f]; }
+    float max(int f) const { return max_[f]; }
+    float quantile(int f, double q) const { return sketches_[f].quantile(q); }
+
+    // approximate counts from the fine histogram (resolution = (histMax - histMin) / histBins)
+    uint64_t countBelow(int f, float threshold) const;
+    uint64_t countAbove(int f, float threshold) const;
+    uint64_t countBetween(int f, float low, float high) const;
+
+    // re-bins the fine histogram into `bins` equal-width bins over [low, low + range]
+    std::vector<int> histogram(int f, float low, float range, int bins) const;
+
+private:
+    int numFeatures_;
+    uint64_t n_;
+
+    std::vector<double> mean_;
+    std::vector<double> m2_;
+    std::vector<double> m3_;
+    std::vector<double> m4_;
+    std::vector<double> coMoment_; // numFeatures x numFeatures, row-major
+    std::vector<float> min_;
+    std::vector<float> max_;
+    std::vector<QuantileSketch> sketches_;
+
+    float histMin_;
+    float histMax_;
+    int histBins_;
+    float binWidth_;
+    std::vector<uint64_t> hist_; // numFeatures x (histBins + 2), slot 0 = underflow, last = overflow
+
+    std::vector<double> delta_; // scratch for co-moment update (avoids allocating per sample)
+
+    int fineBin(float value) const;
+    float fineBinCenter(int slot) const;
+    const uint64_t* featureHist(int f) const { return hist_.data() + static_cast<size_t>(f) * (histBins_ + 2); }
+};
+
+}
@@ -0,0 +1,54 @@
+/*
+nao_compact: folds the delta checkpoints of a training run into one full table (Checkpoint::compact)
+ - chains are read up to the lengths in <prefix>.manifest, deltas of an earlier run on the same prefix are ignored
+ - threads must be the thread count of the run that wrote the checkpoints
+
+ usage: nao_compact [--v2] -o <out.bin> <prefix> <threads>
+    --v2      write a single-stream v2 file (default: chunked v3)
+ */
+
+#include "cfr/strategy-eval/checkpoint.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+static void printUsage() {
+    fprintf(stderr, "usage: nao_compact [--v2] -o <out.bin> <prefix> <threads>\n");
+}
+
+int main(int argc, char** argv) {
+    std::string outPath;
+    StrategyIO::Format format = StrategyIO::Format::Chunked;
+    std::string prefix;
+    int numThreads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--v2") {
+            format = StrategyIO::Format::Stream;
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if (prefix.empty()) {
+            prefix = arg;
+        } else if (numThreads == 0) {
+            numThreads = std::atoi(arg.c_str());
+            if (numThreads <= 0) {
+                fprintf(stderr, "nao_compact: bad thread count %s\n", arg.c_str());
+                return 1;
+            }
+        } else {
+            printUsage();
+            return 1;
+        }
+    }
+
+    if (outPath.empty() || prefix.empty() || numThreads == 0) {
+        printUsage();
+        return 1;
+    }
+
+    return Checkpoint::compact(prefix, numThreads, outPath, format) ? 0 : 1;
+}
@@ -0,0 +1,41 @@
+/*
+nao_evaluate: BO evaluator entry point (bo/evaluator.hpp)
+
+ usage:
+    nao_evaluate                    one proposal from stdin, one result line on stdout
+    nao_evaluate --daemon           newline-delimited proposals on stdin, one result line each on stdout
+    nao_evaluate --socket <path>    same protocol on a UNIX domain socket
+
+ proposal: {"x": [flop0, flop1, flop2, turn0, turn1, turn2, river0, river1, river2], "id": 7}
+ result:   {"id": 7, "ev_mean": ..., "ev_variance_of_mean": ..., "fidelity": 1}
+
+ daemon modes also take batches (q proposals evaluated concurrently, cores split between them):
+ request:  {"batch": [{"x": [...]}, {"x": [...]}], "id": 8}
+ result:   {"id": 8, "results": [{"ev_mean": ..., "ev_variance_of_mean": ..., "fidelity": ...}, ...]}
+ with "schedule": "pipelined" each match overlaps the next proposal's training instead,
+ with "schedule": "halving" the batch is screened at low budgets first (successive halving, fidelity < 1 for the dropped ones)
+ */
+
+#include "bo/evaluator.hpp"
+#include <cstdio>
+#include <string>
+
+int main(int argc, char** argv) {
+    std::string mode = argc > 1 ? argv[1] : "";
+
+    if (mode.empty()) {
+        BOSignal signal = EvaluateBOProposal::evaluatePostflopStrategy();
+        fprintf(stdout, "{\"ev_mean\":%.17g,\"ev_variance_of_mean\":%.17g,\"fidelity\":%.17g}\n", signal.ev_mean,
+                signal.ev_variance_of_mean, signal.fidelity);
+        return 0;
+    }
+    if (mode == "--daemon" && argc == 2) {
+        return EvaluateBOProposal::serveStdio();
+    }
+    if (mode == "--socket" && argc == 3) {
+        return EvaluateBOProposal::serveSocket(argv[2]);
+    }
+
+    fprintf(stderr, "usage: nao_evaluate [--daemon | --socket <path>]\n");
+    return 1;
+}
@@ -0,0 +1,66 @@
+/*
+nao_merge: sums saved strategy tables offline (StrategyIO::merge)
+ - the same abstraction trained on several machines / seeds -> one blueprint, no shared-memory box needed
+ - memory is bounded by one key-hash shard of the merged table
+
+ usage: nao_merge [--v2] -o <out.bin> <input.bin>[@weight] <input.bin>[@weight] ...
+    --v2      write a single-stream v2 file (default: chunked v3)
+    @weight   scales that file's regretSum / strategySum (default 1)
+ */
+
+#include "cfr/strategy-eval/strategy_io.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+static void printUsage() {
+    fprintf(stderr, "usage: nao_merge [--v2] -o <out.bin> <input.bin>[@weight] ...\n");
+}
+
+int main(int argc, char** argv) {
+    std::string outPath;
+    StrategyIO::Format format = StrategyIO::Format::Chunked;
+    std::vector<std::string> inputs;
+    std::vector<double> weights;
+    bool weighted = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--v2") {
+            format = StrategyIO::Format::Stream;
+        } else if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else {
+            // path@weight, the last '@' separates the weight
+            size_t at = arg.rfind('@');
+            double weight = 1.0;
+            if (at != std::string::npos) {
+                char* end = nullptr;
+                weight = std::strtod(arg.c_str() + at + 1, &end);
+                if (end == arg.c_str() + at + 1 || *end != '\0') {
+                    fprintf(stderr, "nao_merge: bad weight in %s\n", arg.c_str());
+                    return 1;
+                }
+                arg = arg.substr(0, at);
+                weighted = true;
+            }
+            inputs.push_back(arg);
+            weights.push_back(weight);
+        }
+    }
+
+    if (outPath.empty() || inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    if (!weighted) {
+        weights.clear();
+    }
+
+    return StrategyIO::merge(inputs, weights, outPath, format) ? 0 : 1;
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include "bo/baseline_cache.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+using namespace BaselineCache;
+
+class BaselineCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::ofstream(abstractionFile, std::ios::binary) << "centroids v1";
+        key.nodeBudget = 1000;
+        key.trainingSeed = 42;
+        key.threads = 4;
+        key.abstractionFiles = {abstractionFile};
+    }
+
+    void TearDown() override {
+        std::remove(abstractionFile.c_str());
+        std::filesystem::remove_all(cacheDir);
+    }
+
+    std::string abstractionFile = "baseline_cache_test_abstraction.dat";
+    std::string cacheDir = "baseline_cache_test_dir";
+    Key key;
+};
+
+// reference values of 64-bit FNV-1a
+TEST_F(BaselineCacheTest, Fnv1aMatchesReference) {
+    EXPECT_EQ(fnv1a("", 0), 0xCBF29CE484222325ULL);
+    EXPECT_EQ(fnv1a("a", 1), 0xAF63DC4C8601EC8CULL);
+    EXPECT_EQ(fnv1a("foobar", 6), 0x85944171F73967E8ULL);
+}
+
+// every input of the trained baseline is part of the digest
+TEST_F(BaselineCacheTest, DigestChangesWithEveryInput) {
+    const std::string base = digest(key);
+    ASSERT_EQ(base.size(), 16u);
+    EXPECT_EQ(digest(key), base);
+
+    Key other = key;
+    other.trainingSeed++;
+    EXPECT_NE(digest(other), base);
+
+    other = key;
+    other.nodeBudget *= 2;
+    EXPECT_NE(digest(other), base);
+
+    other = key;
+    other.threads = 8;
+    EXPECT_NE(digest(other), base);
+
+    other = key;
+    other.config.river_numerators[2] = 3;
+    EXPECT_NE(digest(other), base);
+
+    std::ofstream(abstractionFile, std::ios::binary) << "centroids v2";
+    EXPECT_NE(digest(key), base);
+
+    std::remove(abstractionFile.c_str());
+    EXPECT_TRUE(digest(key).empty());
+}
+
+// a stored baseline is mapped back on lookup, other digests miss
+TEST_F(BaselineCacheTest, StoreThenLookup) {
+    FrozenStrategy::InfosetMap map;
+    MCCFR::InfosetKey infosetKey{0xDEADBEEFULL, 3};
+    MCCFR::Infoset infoset;
+    infoset.initialize(2);
+    infoset.strategySum[0] = 3.0f;
+    infoset.strategySum[1] = 1.0f;
+    map[infosetKey] = infoset;
+    FrozenStrategy::Table table = FrozenStrategy::Table::freeze(map, FrozenStrategy::Precision::Float32);
+
+    const std::string id = digest(key);
+    MatchEngine::StrategyProfile profile;
+    EXPECT_FALSE(lookup(cacheDir, id, profile));
+
+    ASSERT_TRUE(store(cacheDir, id, key, table));
+    EXPECT_TRUE(std::filesystem::exists(std::filesystem::path(cacheDir) / (id + ".json")));
+
+    ASSERT_TRUE(lookup(cacheDir, id, profile));
+    float out[MCCFR::MAX_ACTIONS];
+    ASSERT_TRUE(profile.frozen.getStrategy(infosetKey, 2, out));
+    EXPECT_FLOAT_EQ(out[0], 0.75f);
+
+    MatchEngine::StrategyProfile missed;
+    EXPECT_FALSE(lookup(cacheDir, "0000000000000000", missed));
+    EXPECT_FALSE(lookup(cacheDir, "", missed));
+}
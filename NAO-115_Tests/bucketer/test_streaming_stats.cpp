@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "hand-bucketing/streaming_stats.hpp"
+#include <random>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+using namespace Bucketer;
+
+class StreamingStatsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::mt19937 rng(7);
+        std::normal_distribution<float> noise(0.3f, 0.2f);
+        samples.resize(100000);
+        for (auto& s : samples) {
+            s[0] = std::clamp(noise(rng), -1.0f, 1.0f);
+            s[1] = 0.5f * s[0] + 0.1f * noise(rng);
+        }
+    }
+
+    std::vector<std::array<float, 2>> samples;
+};
+
+// splitting the stream across two accumulators and merging must match the one-pass result
+TEST_F(StreamingStatsTest, MergeMatchesSinglePass) {
+    FeatureAccumulator single(2), left(2), right(2);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        single.add(samples[i].data());
+        (i < samples.size() / 3 ? left : right).add(samples[i].data());
+    }
+    left.merge(right);
+
+    ASSERT_EQ(left.count(), single.count());
+    for (int f = 0; f < 2; ++f) {
+        EXPECT_NEAR(left.mean(f), single.mean(f), 1e-9);
+        EXPECT_NEAR(left.variance(f), single.variance(f), 1e-9);
+        EXPECT_NEAR(left.centralMoment3(f), single.centralMoment3(f), 1e-9);
+        EXPECT_NEAR(left.centralMoment4(f), single.centralMoment4(f), 1e-9);
+    }
+    EXPECT_NEAR(left.covariance(0, 1), single.covariance(0, 1), 1e-9);
+}
+
+// moments must agree with the textbook two-pass formulas
+TEST_F(StreamingStatsTest, MomentsMatchTwoPass) {
+    FeatureAccumulator stats(2);
+    double mean = 0.0;
+    for (const auto& s : samples) {
+        stats.add(s.data());
+        mean += s[0];
+    }
+    mean /= samples.size();
+
+    double m2 = 0.0;
+    for (const auto& s : samples) {
+        m2 += (s[0] - mean) * (s[0] - mean);
+    }
+
+    EXPECT_NEAR(stats.mean(0), mean, 1e-9);
+    EXPECT_NEAR(stats.variance(0), m2 / (samples.size() - 1), 1e-9);
+}
+
+// sketch quantiles should stay within a small rank error of the sorted data
+TEST_F(StreamingStatsTest, SketchQuantilesWithinRankError) {
+    FeatureAccumulator stats(2);
+    std::vector<float> sorted;
+    for (const auto& s : samples) {
+        stats.add(s.data());
+        sorted.push_back(s[0]);
+    }
+    std::sort(sorted.begin(), sorted.end());
+
+    for (double q : {0.01, 0.25, 0.5, 0.75, 0.99}) {
+        float estimate = stats.quantile(0, q);
+        double rank = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), estimate) - sorted.begin()) / sorted.size();
+        EXPECT_NEAR(rank, q, 0.01) << "q = " << q;
+    }
+    EXPECT_EQ(stats.min(0), sorted.front());
+    EXPECT_EQ(stats.max(0), sorted.back());
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "cfr/utils/deal_stream.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unistd.h>
+
+using namespace DealStream;
+
+static std::string tempPath(const char* name) {
+    return "/tmp/nao_deal_stream_" + std::to_string(getpid()) + "_" + name;
+}
+
+// the stream replays the trainer's draw: partial Fisher-Yates of 9 cards over a deck that is never reset
+TEST(DealStreamTest, SampleDealsMatchesTrainerDraw) {
+    std::vector<Record> records = sampleDeals(1000, 42);
+    ASSERT_EQ(records.size(), 1000u);
+
+    std::mt19937 rng(42);
+    std::array<int, 52> deck;
+    for (int i = 0; i < 52; ++i) deck[i] = i;
+
+    for (const Record& record : records) {
+        bool seen[52] = {false};
+        for (int j = 0; j < 9; ++j) {
+            int k = j + rng() % (52 - j);
+            std::swap(deck[j], deck[k]);
+            EXPECT_EQ(record.cards[j], deck[j]);
+            ASSERT_LT(record.cards[j], 52);
+            EXPECT_FALSE(seen[record.cards[j]]);
+            seen[record.cards[j]] = true;
+        }
+    }
+
+    // same seed, same deals
+    std::vector<Record> again = sampleDeals(1000, 42);
+    EXPECT_EQ(std::memcmp(records.data(), again.data(), records.size() * sizeof(Record)), 0);
+}
+
+TEST(DealStreamTest, WriteAndMapRoundTrip) {
+    std::vector<Record> records = sampleDeals(10, 7);
+    for (size_t i = 0; i < records.size(); ++i) {
+        records[i].showdown = static_cast<int8_t>(static_cast<int>(i % 3) - 1);
+        for (int p = 0; p < 2; ++p) {
+            for (int s = 0; s < 3; ++s) {
+                records[i].buckets[p][s] = static_cast<uint16_t>(i * 100 + p * 10 + s);
+            }
+        }
+    }
+
+    const std::string path = tempPath("roundtrip.deals");
+    ASSERT_TRUE(write(records, 7, 0xABCDULL, path));
+
+    Stream stream;
+    ASSERT_TRUE(stream.map(path));
+    EXPECT_EQ(stream.size(), 10u);
+    EXPECT_EQ(stream.seed(), 7u);
+    EXPECT_EQ(stream.abstractionChecksum(), 0xABCDULL);
+    for (size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(std::memcmp(&stream[i], &records[i], sizeof(Record)), 0);
+    }
+
+    // reads past the end wrap around
+    EXPECT_EQ(&stream[13], &stream[3]);
+    EXPECT_EQ(stream[25].buckets[1][2], records[5].buckets[1][2]);
+    std::remove(path.c_str());
+}
+
+TEST(DealStreamTest, MapRejectsBadFiles) {
+    Stream stream;
+    EXPECT_FALSE(stream.map(tempPath("missing.deals")));
+
+    // truncated: header promises more records than the file holds
+    const std::string path = tempPath("truncated.deals");
+    ASSERT_TRUE(write(sampleDeals(4, 1), 1, 0, path));
+    ASSERT_EQ(truncate(path.c_str(), sizeof(Header) + 3 * sizeof(Record)), 0);
+    EXPECT_FALSE(stream.map(path));
+
+    // not a deal stream
+    FILE* f = fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::vector<uint8_t> garbage(sizeof(Header) + sizeof(Record), 0x5A);
+    fwrite(garbage.data(), 1, garbage.size(), f);
+    fclose(f);
+    EXPECT_FALSE(stream.map(path));
+    std::remove(path.c_str());
+}
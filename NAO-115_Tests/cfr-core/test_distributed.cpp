@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include "cfr/cfr-core/mccfr_distributed.hpp"
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+using namespace MCCFR;
+
+// workers are simulated with synthetic increments (real Trainers need the bucket LUTs)
+class DistributedTest : public ::testing::Test {
+protected:
+    static Infoset makeIncrement(float regret, float strategy) {
+        Infoset infoset;
+        infoset.initialize(3);
+        for (int a = 0; a < 3; ++a) {
+            infoset.regretSum[a] = regret;
+            infoset.strategySum[a] = strategy;
+        }
+        return infoset;
+    }
+
+    std::string unixEndpoint = "unix:/tmp/nao_distributed_test_" + std::to_string(getpid()) + ".sock";
+};
+
+// both workers get the summed global value of every key touched in the round, DONE increments are added at the end
+TEST_F(DistributedTest, RoundSumsIncrementsAndBroadcastsUnion) {
+    InfosetKey shared{0xABCDEFULL, 4};
+    InfosetKey onlyB{0x12345ULL, 9};
+
+    DistributedCoordinator coordinator(unixEndpoint, 2);
+    bool coordinatorOk = false;
+    std::thread server([&]() { coordinatorOk = coordinator.run(); });
+
+    DistributedMap updateA, updateB;
+    bool okA = false, okB = false;
+
+    std::thread workerA([&]() {
+        WorkerLink link;
+        DistributedMap delta;
+        delta[shared] = makeIncrement(1.0f, 10.0f);
+        okA = link.connect(unixEndpoint) && link.exchange(delta, updateA);
+
+        DistributedMap last;
+        last[shared] = makeIncrement(0.5f, 1.0f);
+        okA = okA && link.finish(last);
+    });
+    std::thread workerB([&]() {
+        WorkerLink link;
+        DistributedMap delta;
+        delta[shared] = makeIncrement(2.0f, 20.0f);
+        delta[onlyB] = makeIncrement(4.0f, 40.0f);
+        okB = link.connect(unixEndpoint) && link.exchange(delta, updateB);
+        okB = okB && link.finish(DistributedMap{});
+    });
+
+    workerA.join();
+    workerB.join();
+    server.join();
+
+    ASSERT_TRUE(okA);
+    ASSERT_TRUE(okB);
+    ASSERT_TRUE(coordinatorOk);
+    EXPECT_EQ(coordinator.getRounds(), 2u);
+
+    for (const DistributedMap* update : {&updateA, &updateB}) {
+        ASSERT_EQ(update->size(), 2u);
+        EXPECT_FLOAT_EQ(update->at(shared).regretSum[0], 3.0f);
+        EXPECT_FLOAT_EQ(update->at(shared).strategySum[2], 30.0f);
+        EXPECT_FLOAT_EQ(update->at(onlyB).regretSum[1], 4.0f);
+        EXPECT_EQ(update->at(onlyB).numActions, 3);
+    }
+
+    const DistributedMap& global = coordinator.getInfosetMap();
+    ASSERT_EQ(global.size(), 2u);
+    EXPECT_FLOAT_EQ(global.at(shared).regretSum[0], 3.5f);
+    EXPECT_FLOAT_EQ(global.at(shared).strategySum[0], 31.0f);
+}
+
+// same protocol over TCP loopback, negative increments are summed like the threads' merge (no floor)
+TEST_F(DistributedTest, TcpLoopbackSumsRegrets) {
+    std::string endpoint = "tcp:127.0.0.1:" + std::to_string(40000 + getpid() % 20000);
+    InfosetKey key{0x777ULL, 1};
+
+    DistributedCoordinator coordinator(endpoint, 1);
+    bool coordinatorOk = false;
+    std::thread server([&]() { coordinatorOk = coordinator.run(); });
+
+    DistributedMap first, second;
+    WorkerLink link;
+    ASSERT_TRUE(link.connect(endpoint));
+
+    DistributedMap delta;
+    delta[key] = makeIncrement(2.0f, 1.0f);
+    ASSERT_TRUE(link.exchange(delta, first));
+
+    delta[key] = makeIncrement(-5.0f, 1.0f);
+    ASSERT_TRUE(link.exchange(delta, second));
+    ASSERT_TRUE(link.finish(DistributedMap{}));
+    server.join();
+
+    EXPECT_TRUE(coordinatorOk);
+    EXPECT_FLOAT_EQ(first.at(key).regretSum[0], 2.0f);
+    EXPECT_FLOAT_EQ(second.at(key).regretSum[0], -3.0f);
+    EXPECT_FLOAT_EQ(second.at(key).strategySum[0], 2.0f);
+    EXPECT_EQ(coordinator.getRounds(), 3u);
+}
+
+// a worker that disconnects without DONE is dropped, the others finish normally
+TEST_F(DistributedTest, LostWorkerIsDropped) {
+    InfosetKey key{0x42ULL, 2};
+
+    DistributedCoordinator coordinator(unixEndpoint, 2);
+    bool coordinatorOk = true;
+    std::thread server([&]() { coordinatorOk = coordinator.run(); });
+
+    std::thread lost([&]() {
+        WorkerLink link;
+        link.connect(unixEndpoint); // closed by the destructor, nothing sent
+    });
+
+    WorkerLink link;
+    ASSERT_TRUE(link.connect(unixEndpoint));
+    lost.join();
+
+    DistributedMap delta, update;
+    delta[key] = makeIncrement(1.0f, 1.0f);
+    ASSERT_TRUE(link.exchange(delta, update));
+    ASSERT_TRUE(link.finish(delta));
+    server.join();
+
+    EXPECT_FALSE(coordinatorOk);
+    EXPECT_FLOAT_EQ(coordinator.getInfosetMap().at(key).regretSum[0], 2.0f);
+}
+
+// a header announcing more entries than the limit is rejected before anything is allocated, the worker is dropped
+TEST_F(DistributedTest, OversizedMessageIsRejected) {
+    DistributedCoordinator coordinator(unixEndpoint, 1);
+    bool coordinatorOk = true;
+    std::thread server([&]() { coordinatorOk = coordinator.run(); });
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    const std::string path = unixEndpoint.substr(5); // without "unix:"
+    strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+    // raw peer, retries until the coordinator listens
+    int fd = -1;
+    for (int attempt = 0; attempt < 500 && fd < 0; ++attempt) {
+        fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            fd = -1;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    ASSERT_GE(fd, 0);
+
+    // 16-byte header: magic, version, type Delta, entry count above the limit, no payload
+    uint8_t header[16] = {};
+    uint32_t magic = DISTRIBUTED_MAGIC;
+    uint16_t version = DISTRIBUTED_VERSION;
+    uint16_t type = static_cast<uint16_t>(MessageType::Delta);
+    uint64_t numEntries = MAX_MESSAGE_ENTRIES + 1;
+    memcpy(header, &magic, 4);
+    memcpy(header + 4, &version, 2);
+    memcpy(header + 6, &type, 2);
+    memcpy(header + 8, &numEntries, 8);
+    ASSERT_EQ(::send(fd, header, sizeof(header), 0), static_cast<ssize_t>(sizeof(header)));
+
+    server.join();
+    ::close(fd);
+
+    EXPECT_FALSE(coordinatorOk);
+    EXPECT_TRUE(coordinator.getInfosetMap().empty());
+}
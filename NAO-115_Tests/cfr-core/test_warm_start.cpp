@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include "cfr/cfr-core/warm_start.hpp"
+
+using namespace WarmStart;
+
+// streets are compared in order, the first difference ends the shared prefix
+TEST(WarmStartTest, SharedStreetsCountsLeadingEqualStreets) {
+    BetAbstraction::BetConfig a;
+    BetAbstraction::BetConfig b;
+    EXPECT_EQ(sharedStreets(a, b), 3);
+    EXPECT_DOUBLE_EQ(sizeDistance(a, b), 0.0);
+
+    b.river_numerators[2] = 3;
+    EXPECT_EQ(sharedStreets(a, b), 2);
+
+    b.turn_numerators[0] = 3;
+    b.turn_denominators[0] = 8;
+    EXPECT_EQ(sharedStreets(a, b), 1);
+
+    b.flop_numerators[1] = 5;
+    b.flop_denominators[1] = 4;
+    EXPECT_EQ(sharedStreets(a, b), 0);
+
+    // same fraction written with another denominator is the same size
+    BetAbstraction::BetConfig c;
+    c.flop_numerators[0] = 4;
+    c.flop_denominators[0] = 8;
+    EXPECT_EQ(sharedStreets(a, c), 3);
+}
+
+// the closer proposal has the smaller distance
+TEST(WarmStartTest, SizeDistanceOrdersProposals) {
+    BetAbstraction::BetConfig base;
+    BetAbstraction::BetConfig near = base;
+    BetAbstraction::BetConfig far = base;
+    near.river_numerators[2] = 9;
+    near.river_denominators[2] = 4;  // 2.25 vs 2
+    far.river_numerators[2] = 4;     // 4 vs 2
+    EXPECT_GT(sizeDistance(base, near), 0.0);
+    EXPECT_LT(sizeDistance(base, near), sizeDistance(base, far));
+}
+
+// only infosets on the shared streets are carried over, unknown streets never
+TEST(WarmStartTest, TransferKeepsSharedStreets) {
+    InfosetMap source;
+    for (uint8_t street = 0; street <= 3; ++street) {
+        MCCFR::Infoset infoset;
+        infoset.initialize(3);
+        infoset.street = street;
+        infoset.regretSum[0] = 1.0f + street;
+        infoset.touchedEpoch = 7;
+        source[MCCFR::InfosetKey{0x1000ULL + street, street}] = infoset;
+    }
+
+    EXPECT_TRUE(transfer(source, 0).empty());
+
+    InfosetMap flopTurn = transfer(source, 2);
+    ASSERT_EQ(flopTurn.size(), 2u);
+    EXPECT_FLOAT_EQ(flopTurn.at(MCCFR::InfosetKey{0x1001ULL, 1}).regretSum[0], 2.0f);
+    EXPECT_EQ(flopTurn.at(MCCFR::InfosetKey{0x1002ULL, 2}).touchedEpoch, 0u);
+    EXPECT_EQ(flopTurn.count(MCCFR::InfosetKey{0x1003ULL, 3}), 0u);
+    EXPECT_EQ(flopTurn.count(MCCFR::InfosetKey{0x1000ULL, 0}), 0u);
+
+    EXPECT_EQ(transfer(source, 3).size(), 3u);
+}
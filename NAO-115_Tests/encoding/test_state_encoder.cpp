@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "encoding/state_encoder.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace StateEncoder;
+
+static std::vector<MCCFRState> randomStates(size_t n, std::vector<uint64_t>& masks) {
+    std::mt19937_64 rng(2024);
+    std::vector<MCCFRState> states(n);
+    masks.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        MCCFRState state{};
+        state.street = static_cast<uint8_t>(rng() % 4);
+        state.raiseCount = static_cast<uint8_t>(rng() % 5);
+        state.currentPlayer = static_cast<uint8_t>(rng() % 2);
+        state.potBase = static_cast<int>(rng() % 40000);
+        state.heroStreetBet = static_cast<int>(rng() % 20000);
+        state.villainStreetBet = static_cast<int>(rng() % 20000);
+        state.heroStack = static_cast<int>(rng() % 20000);
+        state.villainStack = static_cast<int>(rng() % 20000);
+        state.previousRaiseTotal = static_cast<int>(rng() % 20000);
+        state.betBeforeRaise = static_cast<int>(rng() % 20000);
+        states[i] = state;
+        masks[i] = rng() & ((1ULL << 52) - 1); // every bit pattern, not only legal boards
+    }
+    return states;
+}
+
+// every row of the batch is bit-identical to the per-state encode
+TEST(StateEncoderTest, BatchMatchesEncode) {
+    std::vector<uint64_t> masks;
+    std::vector<MCCFRState> states = randomStates(257, masks);
+
+    std::vector<float> out(states.size() * INPUT_SIZE, -1.0f);
+    encodeBatch(states.data(), masks.data(), states.size(), out.data());
+
+    for (size_t i = 0; i < states.size(); ++i) {
+        std::array<float, 65> expected = encode(states[i], masks[i]);
+        ASSERT_EQ(std::memcmp(expected.data(), out.data() + i * INPUT_SIZE, sizeof(expected)), 0) << "row " << i;
+    }
+}
+
+// 16-bit rows are the rounded float rows
+TEST(StateEncoderTest, HalfBatchMatchesConvertedEncode) {
+    std::vector<uint64_t> masks;
+    std::vector<MCCFRState> states = randomStates(64, masks);
+
+    for (HalfFormat format : {HalfFormat::Float16, HalfFormat::BFloat16}) {
+        std::vector<uint16_t> out(states.size() * INPUT_SIZE, 0xFFFF);
+        encodeBatch(states.data(), masks.data(), states.size(), out.data(), format);
+
+        for (size_t i = 0; i < states.size(); ++i) {
+            std::array<float, 65> expected = encode(states[i], masks[i]);
+            for (size_t f = 0; f < INPUT_SIZE; ++f) {
+                uint16_t value = format == HalfFormat::BFloat16 ? toBFloat16(expected[f]) : toFloat16(expected[f]);
+                ASSERT_EQ(out[i * INPUT_SIZE + f], value) << "row " << i << " feature " << f;
+            }
+        }
+    }
+}
+
+TEST(StateEncoderTest, HalfConversions) {
+    EXPECT_EQ(toFloat16(0.0f), 0x0000);
+    EXPECT_EQ(toFloat16(-0.0f), 0x8000);
+    EXPECT_EQ(toFloat16(1.0f), 0x3C00);
+    EXPECT_EQ(toFloat16(0.5f), 0x3800);
+    EXPECT_EQ(toFloat16(-2.0f), 0xC000);
+    EXPECT_EQ(toFloat16(65504.0f), 0x7BFF);
+    EXPECT_EQ(toFloat16(70000.0f), 0x7C00);
+    EXPECT_EQ(toFloat16(5.9604645e-8f), 0x0001);  // smallest subnormal
+    EXPECT_EQ(toFloat16(1.0f + 1.0f / 2048.0f), 0x3C00); // halfway, ties to even
+    EXPECT_EQ(toFloat16(1.0f + 3.0f / 2048.0f), 0x3C02);
+
+    EXPECT_EQ(toBFloat16(1.0f), 0x3F80);
+    EXPECT_EQ(toBFloat16(-2.0f), 0xC000);
+    EXPECT_EQ(toBFloat16(0.25f), 0x3E80);
+    EXPECT_EQ(toBFloat16(1.0f + 1.0f / 256.0f), 0x3F80);  // halfway, ties to even
+    EXPECT_EQ(toBFloat16(1.0f + 3.0f / 256.0f), 0x3F82);
+}
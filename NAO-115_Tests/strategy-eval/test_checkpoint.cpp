@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+#include "cfr/strategy-eval/checkpoint.hpp"
+#include <cstdio>
+#include <random>
+
+using namespace Checkpoint;
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        for (int t = 0; t < 2; ++t) {
+            for (uint64_t s = 0; s < 4; ++s) {
+                std::remove(deltaPath(prefix, t, s).c_str());
+            }
+        }
+        std::remove(outPath.c_str());
+        std::remove(manifestPath(prefix).c_str());
+    }
+
+    static MCCFR::Infoset makeInfoset(float value) {
+        MCCFR::Infoset infoset;
+        infoset.initialize(3);
+        for (int a = 0; a < 3; ++a) {
+            infoset.regretSum[a] = value + a;
+            infoset.strategySum[a] = 2.0f * value + a;
+        }
+        return infoset;
+    }
+
+    std::string prefix = "checkpoint_test";
+    std::string outPath = "checkpoint_test_compacted.bin";
+};
+
+// later deltas replace earlier values per thread, threads are summed
+TEST_F(CheckpointTest, CompactFoldsChainsAndSumsThreads) {
+    MCCFR::InfosetKey shared{0xABCDEFULL, 4};
+    MCCFR::InfosetKey onlyThread0{0x12345ULL, 9};
+    {
+        Writer writer(prefix);
+
+        StrategyIO::InfosetMap base0;
+        base0[shared] = makeInfoset(1.0f);
+        base0[onlyThread0] = makeInfoset(5.0f);
+        writer.submit(0, 0, base0);
+
+        StrategyIO::InfosetMap delta0;
+        delta0[shared] = makeInfoset(3.0f); // only the touched infoset
+        writer.submit(0, 1, delta0);
+
+        StrategyIO::InfosetMap base1;
+        base1[shared] = makeInfoset(10.0f);
+        writer.submit(1, 0, base1);
+
+        ASSERT_TRUE(writer.finish());
+    }
+
+    ASSERT_TRUE(compact(prefix, 2, outPath));
+    StrategyIO::InfosetMap compacted;
+    ASSERT_TRUE(StrategyIO::load(compacted, outPath));
+    ASSERT_EQ(compacted.size(), 2u);
+
+    const auto& merged = compacted.at(shared);
+    const auto& single = compacted.at(onlyThread0);
+    for (int a = 0; a < 3; ++a) {
+        EXPECT_FLOAT_EQ(merged.regretSum[a], (3.0f + a) + (10.0f + a));
+        EXPECT_FLOAT_EQ(merged.strategySum[a], (6.0f + a) + (20.0f + a));
+        EXPECT_FLOAT_EQ(single.regretSum[a], 5.0f + a);
+    }
+}
+
+TEST_F(CheckpointTest, MissingThreadChainFails) {
+    {
+        Writer writer(prefix);
+        StrategyIO::InfosetMap base;
+        base[MCCFR::InfosetKey{1, 1}] = makeInfoset(1.0f);
+        writer.submit(0, 0, base);
+    }
+
+    StrategyIO::InfosetMap folded;
+    EXPECT_TRUE(fold(folded, prefix, 1));
+    EXPECT_FALSE(fold(folded, prefix, 2));
+}
+
+// a shorter run on the same prefix does not pick up the later deltas of an earlier, longer run
+TEST_F(CheckpointTest, StaleDeltasOfEarlierRunAreIgnored) {
+    MCCFR::InfosetKey key{0x777ULL, 2};
+    MCCFR::InfosetKey staleKey{0x888ULL, 3};
+    {
+        Writer writer(prefix);
+        StrategyIO::InfosetMap base;
+        base[key] = makeInfoset(1.0f);
+        writer.submit(0, 0, base);
+        StrategyIO::InfosetMap later;
+        later[key] = makeInfoset(50.0f);
+        later[staleKey] = makeInfoset(60.0f);
+        writer.submit(0, 1, later);
+        writer.submit(0, 2, later);
+        ASSERT_TRUE(writer.finish());
+    }
+    {
+        Writer writer(prefix);
+        StrategyIO::InfosetMap base;
+        base[key] = makeInfoset(2.0f);
+        writer.submit(0, 0, base);
+        ASSERT_TRUE(writer.finish());
+    }
+
+    StrategyIO::InfosetMap folded;
+    ASSERT_TRUE(fold(folded, prefix, 1));
+    ASSERT_EQ(folded.size(), 1u);
+    EXPECT_FLOAT_EQ(folded.at(key).regretSum[0], 2.0f);
+}
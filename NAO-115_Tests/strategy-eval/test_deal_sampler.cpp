@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include "cfr/utils/deal_sampler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <set>
+
+using namespace DealSampler;
+
+class DealSamplerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        engine.initialize();
+    }
+
+    Bucketer::IsomorphismEngine engine;
+};
+
+// 1755 canonical flops, weights are raw flop counts / 22100
+TEST_F(DealSamplerTest, StrataCoverAllFlops) {
+    Sampler sampler(engine, 7, Mode::Stratified);
+    const auto& weights = sampler.weights();
+    ASSERT_EQ(weights.size(), 1755u);
+    EXPECT_NEAR(std::accumulate(weights.begin(), weights.end(), 0.0), 1.0, 1e-12);
+    for (double w : weights) {
+        // 4, 12 or 24 raw flops per class
+        double raw = w * 22100.0;
+        EXPECT_NEAR(raw, std::round(raw), 1e-6);
+        EXPECT_GE(raw, 4.0 - 1e-6);
+        EXPECT_LE(raw, 24.0 + 1e-6);
+    }
+}
+
+// 9 distinct cards, flop of the stratum, same deal for the same index
+TEST_F(DealSamplerTest, DealsAreValidAndReproducible) {
+    Sampler sampler(engine, 7, Mode::Stratified);
+    for (uint64_t i = 0; i < 5000; ++i) {
+        Deal deal = sampler.deal(i);
+        std::set<int> cards = {deal.p0hand[0], deal.p0hand[1], deal.p1hand[0], deal.p1hand[1]};
+        cards.insert(deal.board.begin(), deal.board.end());
+        ASSERT_EQ(cards.size(), 9u);
+        ASSERT_GE(*cards.begin(), 0);
+        ASSERT_LT(*cards.rbegin(), 52);
+
+        std::array<uint8_t, 3> flop = {static_cast<uint8_t>(deal.board[0]), static_cast<uint8_t>(deal.board[1]),
+                                       static_cast<uint8_t>(deal.board[2])};
+        EXPECT_EQ(static_cast<int>(engine.getBoardFlopIndex(flop)), deal.stratum);
+
+        Deal again = sampler.deal(i);
+        EXPECT_EQ(again.p0hand, deal.p0hand);
+        EXPECT_EQ(again.board, deal.board);
+    }
+}
+
+// golden ratio allocation: every stratum within a few deals of its proportional share (discrepancy ~ log n)
+TEST_F(DealSamplerTest, AllocationIsProportional) {
+    Sampler sampler(engine, 3, Mode::Stratified);
+    const int numDeals = 22100 * 4;
+    std::vector<int> hits(sampler.weights().size(), 0);
+    for (int i = 0; i < numDeals; ++i) {
+        hits[sampler.deal(i).stratum]++;
+    }
+    for (size_t s = 0; s < hits.size(); ++s) {
+        EXPECT_NEAR(hits[s], sampler.weights()[s] * numDeals, 5.0);
+    }
+}
+
+// antithetic unit: second deal swaps the hands of the first
+TEST_F(DealSamplerTest, AntitheticSwapsHands) {
+    Sampler sampler(engine, 5, Mode::StratifiedAntithetic);
+    ASSERT_EQ(sampler.dealsPerUnit(), 2);
+    for (uint64_t k = 0; k < 100; ++k) {
+        Deal first = sampler.deal(2 * k);
+        Deal second = sampler.deal(2 * k + 1);
+        EXPECT_EQ(first.p0hand, second.p1hand);
+        EXPECT_EQ(first.p1hand, second.p0hand);
+        EXPECT_EQ(first.board, second.board);
+    }
+}
+
+// single stratum -> plain mean and sqrt(var / n), strata -> weighted mean
+TEST(StratifiedAccumulatorTest, MatchesPlainAndWeightedMeans) {
+    StratifiedAccumulator plain(std::vector<double>{1.0});
+    std::vector<double> values = {1.0, 4.0, -2.0, 7.0, 3.5, 0.0};
+    for (double v : values) {
+        plain.add(0, v);
+    }
+    double mean = std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+    double ss = 0.0;
+    for (double v : values) {
+        ss += (v - mean) * (v - mean);
+    }
+    EXPECT_NEAR(plain.mean(), mean, 1e-12);
+    EXPECT_NEAR(plain.standardError(), std::sqrt(ss / (values.size() - 1) / values.size()), 1e-12);
+
+    StratifiedAccumulator strata(std::vector<double>{0.25, 0.75});
+    StratifiedAccumulator other(std::vector<double>{0.25, 0.75});
+    strata.add(0, 1.0);
+    strata.add(0, 3.0);
+    other.add(1, 10.0);
+    other.add(1, 14.0);
+    strata.merge(other);
+    EXPECT_EQ(strata.count(), 4u);
+    EXPECT_NEAR(strata.mean(), 0.25 * 2.0 + 0.75 * 12.0, 1e-12);
+    // pooled within variance (2 + 8) / 2 = 5, SE^2 = 5 * (0.25^2 / 2 + 0.75^2 / 2)
+    EXPECT_NEAR(strata.standardError(), std::sqrt(5.0 * (0.0625 / 2.0 + 0.5625 / 2.0)), 1e-12);
+}
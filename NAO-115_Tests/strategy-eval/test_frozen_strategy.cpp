@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "cfr/strategy-eval/frozen_strategy.hpp"
+#include <random>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+using namespace FrozenStrategy;
+
+class FrozenStrategyTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        std::mt19937_64 rng(11);
+        std::uniform_real_distribution<float> sums(0.0f, 100.0f);
+        for (int i = 0; i < 20000; ++i) {
+            MCCFR::InfosetKey key{rng(), static_cast<int32_t>(rng() % 1000)};
+            MCCFR::Infoset infoset;
+            infoset.initialize(2 + static_cast<int>(rng() % 5));
+            for (int a = 0; a < infoset.numActions; ++a) {
+                infoset.strategySum[a] = (rng() % 4 == 0) ? 0.0f : sums(rng);
+            }
+            map[key] = infoset;
+        }
+    }
+
+    InfosetMap map;
+};
+
+// every key must be found with the map's normalized strategy (within the quantization step)
+TEST_F(FrozenStrategyTest, LookupMatchesMap) {
+    const Precision precisions[3] = {Precision::Float32, Precision::UInt16, Precision::UInt8};
+    const float tolerance[3] = {1e-6f, 2.0f / 65535.0f, 2.0f / 255.0f};
+
+    for (int p = 0; p < 3; ++p) {
+        Table table = Table::freeze(map, precisions[p]);
+        ASSERT_EQ(table.size(), map.size());
+
+        for (const auto& [key, infoset] : map) {
+            float expected[MCCFR::MAX_ACTIONS];
+            float frozen[MCCFR::MAX_ACTIONS];
+            infoset.getAverageStrategy(expected);
+            ASSERT_TRUE(table.getStrategy(key, infoset.numActions, frozen));
+            for (int a = 0; a < infoset.numActions; ++a) {
+                EXPECT_NEAR(frozen[a], expected[a], tolerance[p]);
+            }
+        }
+    }
+}
+
+// unknown keys and action count mismatches fall through to the caller's uniform fallback
+TEST_F(FrozenStrategyTest, MissingKeysAreReported) {
+    Table table = Table::freeze(map, Precision::UInt16);
+    float out[MCCFR::MAX_ACTIONS];
+
+    MCCFR::InfosetKey unknown{0x1234567890ABCDEFULL, 7};
+    if (map.find(unknown) == map.end()) {
+        EXPECT_FALSE(table.getStrategy(unknown, 3, out));
+        EXPECT_EQ(table.sampleAction(unknown, 3, 0.5f), -1);
+    }
+
+    const auto& [key, infoset] = *map.begin();
+    int wrongCount = infoset.numActions == 6 ? 5 : infoset.numActions + 1;
+    EXPECT_FALSE(table.getStrategy(key, wrongCount, out));
+}
+
+// sampling from the thresholds follows the stored distribution
+TEST_F(FrozenStrategyTest, SamplingFollowsStrategy) {
+    Table table = Table::freeze(map, Precision::UInt8);
+    const auto& [key, infoset] = *map.begin();
+    int count = infoset.numActions;
+
+    float strategy[MCCFR::MAX_ACTIONS];
+    ASSERT_TRUE(table.getStrategy(key, count, strategy));
+
+    // stratified uniforms -> empirical frequencies are exact up to 1 / samples
+    const int samples = 100000;
+    int hits[MCCFR::MAX_ACTIONS] = {0};
+    for (int i = 0; i < samples; ++i) {
+        float u = (static_cast<float>(i) + 0.5f) / samples;
+        int chosen = table.sampleAction(key, count, u);
+        ASSERT_GE(chosen, 0);
+        ASSERT_LT(chosen, count);
+        hits[chosen]++;
+    }
+    for (int a = 0; a < count; ++a) {
+        EXPECT_NEAR(static_cast<float>(hits[a]) / samples, strategy[a], 1e-3f);
+    }
+}
+
+// copies own their buffers
+TEST_F(FrozenStrategyTest, CopyKeepsLookups) {
+    Table copy;
+    {
+        Table table = Table::freeze(map, Precision::Float32);
+        copy = table;
+    }
+    const auto& [key, infoset] = *map.begin();
+    float out[MCCFR::MAX_ACTIONS];
+    EXPECT_TRUE(copy.getStrategy(key, infoset.numActions, out));
+}
+
+// a mapped table file answers every lookup like the table it was written from
+TEST_F(FrozenStrategyTest, MappedFileMatchesTable) {
+    const std::string path = "frozen_strategy_test.frozen";
+    Table mapped;
+    {
+        Table table = Table::freeze(map, Precision::UInt16);
+        ASSERT_TRUE(saveMapped(table, path));
+        ASSERT_TRUE(loadMapped(mapped, path));
+        ASSERT_EQ(mapped.size(), table.size());
+        EXPECT_EQ(mapped.precision(), Precision::UInt16);
+
+        for (const auto& [key, infoset] : map) {
+            float expected[MCCFR::MAX_ACTIONS];
+            float fromFile[MCCFR::MAX_ACTIONS];
+            ASSERT_TRUE(table.getStrategy(key, infoset.numActions, expected));
+            ASSERT_TRUE(mapped.getStrategy(key, infoset.numActions, fromFile));
+            for (int a = 0; a < infoset.numActions; ++a) {
+                EXPECT_EQ(fromFile[a], expected[a]);
+            }
+        }
+    }
+
+    // copies share the mapping, which outlives the original table
+    Table copy = mapped;
+    mapped = Table();
+    const auto& [key, infoset] = *map.begin();
+    float out[MCCFR::MAX_ACTIONS];
+    EXPECT_TRUE(copy.getStrategy(key, infoset.numActions, out));
+
+    std::remove(path.c_str());
+}
+
+TEST_F(FrozenStrategyTest, MappedLoadRejectsOtherFiles) {
+    const std::string path = "frozen_strategy_test.bad";
+    FILE* f = fopen(path.c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    const char junk[128] = "not a table file";
+    fwrite(junk, 1, sizeof(junk), f);
+    fclose(f);
+
+    Table table;
+    EXPECT_FALSE(loadMapped(table, path));
+    EXPECT_FALSE(loadMapped(table, "missing_table_file.frozen"));
+    std::remove(path.c_str());
+}
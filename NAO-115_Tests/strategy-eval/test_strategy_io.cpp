@@ -0,0 +1,305 @@
+#include <gtest/gtest.h>
+#include "cfr/strategy-eval/strategy_io.hpp"
+#include "cfr/strategy-eval/frozen_strategy.hpp"
+#include <zlib.h>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace StrategyIO;
+
+class StrategyIOTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        // > 4 MB of full entries -> several stream chunks
+        std::mt19937_64 rng(5);
+        std::uniform_real_distribution<float> values(-50.0f, 100.0f);
+        for (int i = 0; i < 150000; ++i) {
+            MCCFR::InfosetKey key{rng(), static_cast<int32_t>(rng() % 1000)};
+            MCCFR::Infoset infoset;
+            infoset.initialize(2 + static_cast<int>(rng() % 5));
+            for (int a = 0; a < infoset.numActions; ++a) {
+                infoset.regretSum[a] = values(rng);
+                infoset.strategySum[a] = values(rng);
+            }
+            map[key] = infoset;
+        }
+    }
+
+    void TearDown() override {
+        std::remove(path.c_str());
+    }
+
+    InfosetMap map;
+    std::string path = "strategy_io_test.bin";
+};
+
+TEST_F(StrategyIOTest, FullRoundTrip) {
+    ASSERT_TRUE(save(map, path));
+
+    InfosetMap loaded;
+    ASSERT_TRUE(load(loaded, path));
+    ASSERT_EQ(loaded.size(), map.size());
+
+    for (const auto& [key, infoset] : map) {
+        auto it = loaded.find(key);
+        ASSERT_NE(it, loaded.end());
+        ASSERT_EQ(it->second.numActions, infoset.numActions);
+        for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+            EXPECT_EQ(it->second.regretSum[a], infoset.regretSum[a]);
+            EXPECT_EQ(it->second.strategySum[a], infoset.strategySum[a]);
+        }
+    }
+}
+
+// v2 files (single stream) stay readable
+TEST_F(StrategyIOTest, StreamFormatRoundTrip) {
+    ASSERT_TRUE(save(map, path, Format::Stream));
+
+    InfosetMap loaded;
+    ASSERT_TRUE(load(loaded, path));
+    ASSERT_EQ(loaded.size(), map.size());
+    for (const auto& [key, infoset] : map) {
+        const auto& restored = loaded.at(key);
+        for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+            EXPECT_EQ(restored.regretSum[a], infoset.regretSum[a]);
+            EXPECT_EQ(restored.strategySum[a], infoset.strategySum[a]);
+        }
+    }
+
+    ShardedMap shards;
+    ASSERT_TRUE(loadSharded(shards, path));
+    size_t total = 0;
+    for (const auto& shard : shards) total += shard.size();
+    EXPECT_EQ(total, map.size());
+}
+
+// every key lands in its own shard, the frozen table from shards equals the one from the map
+TEST_F(StrategyIOTest, ShardedLoadMatchesMap) {
+    ASSERT_TRUE(saveForPlay(map, path));
+
+    ShardedMap shards;
+    ASSERT_TRUE(loadSharded(shards, path));
+    ASSERT_EQ(shards.size(), NUM_SHARDS);
+
+    size_t total = 0;
+    for (uint32_t s = 0; s < NUM_SHARDS; ++s) {
+        total += shards[s].size();
+        for (const auto& [key, infoset] : shards[s]) {
+            ASSERT_EQ(shardOf(key), s);
+            ASSERT_EQ(infoset.strategySum[0], map.at(key).strategySum[0]);
+        }
+    }
+    EXPECT_EQ(total, map.size());
+
+    FrozenStrategy::Table fromMap = FrozenStrategy::Table::freeze(map);
+    FrozenStrategy::Table fromShards = FrozenStrategy::Table::freeze(shards);
+    ASSERT_EQ(fromShards.size(), fromMap.size());
+    for (size_t e = 0; e < fromMap.size(); ++e) {
+        ASSERT_EQ(fromShards.keyData()[e], fromMap.keyData()[e]);
+    }
+}
+
+TEST_F(StrategyIOTest, PlayRoundTripDropsRegrets) {
+    ASSERT_TRUE(saveForPlay(map, path));
+
+    InfosetMap loaded;
+    ASSERT_TRUE(load(loaded, path));
+    ASSERT_EQ(loaded.size(), map.size());
+
+    for (const auto& [key, infoset] : map) {
+        const auto& restored = loaded.at(key);
+        for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+            EXPECT_EQ(restored.regretSum[a], 0.0f);
+            EXPECT_EQ(restored.strategySum[a], infoset.strategySum[a]);
+        }
+    }
+}
+
+// the stream is a plain zlib stream: one-shot uncompress of a streamed file gives header + entries
+TEST_F(StrategyIOTest, StreamMatchesOneShotFormat) {
+    ASSERT_TRUE(saveForPlay(map, path, Format::Stream));
+
+    FILE* f = fopen(path.c_str(), "rb");
+    ASSERT_NE(f, nullptr);
+    uint64_t rawSize = 0;
+    ASSERT_EQ(fread(&rawSize, sizeof(rawSize), 1, f), 1u);
+    std::vector<Bytef> compressed;
+    Bytef block[65536];
+    size_t got;
+    while ((got = fread(block, 1, sizeof(block), f)) > 0) {
+        compressed.insert(compressed.end(), block, block + got);
+    }
+    fclose(f);
+
+    const size_t playEntryBytes = 37;
+    EXPECT_EQ(rawSize, 20 + map.size() * playEntryBytes);
+
+    std::vector<Bytef> raw(rawSize);
+    uLongf rawLength = static_cast<uLongf>(rawSize);
+    ASSERT_EQ(uncompress(raw.data(), &rawLength, compressed.data(), compressed.size()), Z_OK);
+    EXPECT_EQ(rawLength, rawSize);
+
+    uint32_t magic = 0;
+    memcpy(&magic, raw.data(), sizeof(magic));
+    EXPECT_EQ(magic, MAGIC);
+}
+
+TEST_F(StrategyIOTest, TruncatedFileIsRejected) {
+    ASSERT_TRUE(save(map, path));
+
+    FILE* f = fopen(path.c_str(), "rb");
+    ASSERT_NE(f, nullptr);
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    std::vector<char> bytes(size);
+    ASSERT_EQ(fread(bytes.data(), 1, size, f), static_cast<size_t>(size));
+    fclose(f);
+
+    f = fopen(path.c_str(), "wb");
+    fwrite(bytes.data(), 1, size / 2, f);
+    fclose(f);
+
+    InfosetMap loaded;
+    EXPECT_FALSE(load(loaded, path));
+}
+
+// weighted sum of two tables, v2 and v3 inputs mixed, both output formats
+TEST_F(StrategyIOTest, MergeSumsWeightedTables) {
+    // small first table (v2 inputs are decompressed once per shard)
+    InfosetMap first;
+    for (const auto& [key, infoset] : map) {
+        first[key] = infoset;
+        if (first.size() == 5000) break;
+    }
+
+    // second table: half of the keys shared, plus new ones
+    InfosetMap other;
+    std::mt19937_64 rng(17);
+    size_t i = 0;
+    for (const auto& [key, infoset] : first) {
+        if (i++ % 2 == 0) {
+            MCCFR::Infoset copy = infoset;
+            copy.regretSum[0] += 1.0f;
+            other[key] = copy;
+        }
+    }
+    for (int n = 0; n < 1000; ++n) {
+        MCCFR::Infoset infoset;
+        infoset.initialize(3);
+        infoset.strategySum[1] = 4.0f;
+        other[MCCFR::InfosetKey{rng(), 5}] = infoset;
+    }
+
+    const std::string otherPath = "strategy_io_test_other.bin";
+    const std::string mergedPath = "strategy_io_test_merged.bin";
+    ASSERT_TRUE(save(first, path, Format::Stream));
+    ASSERT_TRUE(save(other, otherPath, Format::Chunked));
+
+    for (Format format : {Format::Chunked, Format::Stream}) {
+        ASSERT_TRUE(merge({path, otherPath}, {1.0, 0.5}, mergedPath, format));
+
+        InfosetMap merged;
+        ASSERT_TRUE(load(merged, mergedPath));
+
+        InfosetMap expected = first;
+        for (const auto& [key, infoset] : other) {
+            MCCFR::Infoset scaled = infoset;
+            for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+                scaled.regretSum[a] *= 0.5f;
+                scaled.strategySum[a] *= 0.5f;
+            }
+            auto it = expected.find(key);
+            if (it == expected.end()) {
+                expected[key] = scaled;
+            } else {
+                for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+                    it->second.regretSum[a] += scaled.regretSum[a];
+                    it->second.strategySum[a] += scaled.strategySum[a];
+                }
+            }
+        }
+
+        ASSERT_EQ(merged.size(), expected.size());
+        for (const auto& [key, infoset] : expected) {
+            const auto& result = merged.at(key);
+            ASSERT_EQ(result.numActions, infoset.numActions);
+            for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+                ASSERT_FLOAT_EQ(result.regretSum[a], infoset.regretSum[a]);
+                ASSERT_FLOAT_EQ(result.strategySum[a], infoset.strategySum[a]);
+            }
+        }
+    }
+
+    ASSERT_TRUE(saveForPlay(other, otherPath));
+    EXPECT_FALSE(merge({path, otherPath}, {}, mergedPath)); // full + play-only
+
+    std::remove(otherPath.c_str());
+    std::remove(mergedPath.c_str());
+}
+
+// v2 inputs only: each one is decompressed once per shard and keeps just that shard's entries
+TEST_F(StrategyIOTest, MergeStreamInputsPerShard) {
+    InfosetMap first, second;
+    size_t i = 0;
+    for (const auto& [key, infoset] : map) {
+        if (i % 3 != 2) first[key] = infoset;
+        if (i % 3 != 0) second[key] = infoset;
+        if (++i == 6000) break;
+    }
+    const std::string otherPath = "strategy_io_test_other.bin";
+    const std::string mergedPath = "strategy_io_test_merged.bin";
+    ASSERT_TRUE(save(first, path, Format::Stream));
+    ASSERT_TRUE(save(second, otherPath, Format::Stream));
+
+    ASSERT_TRUE(merge({path, otherPath}, {}, mergedPath));
+
+    ShardedMap shards;
+    ASSERT_TRUE(loadSharded(shards, mergedPath));
+    size_t total = 0;
+    for (uint32_t shard = 0; shard < NUM_SHARDS; ++shard) {
+        total += shards[shard].size();
+        for (const auto& [key, infoset] : shards[shard]) {
+            ASSERT_EQ(shardOf(key), shard);
+            float count = static_cast<float>(first.count(key) + second.count(key));
+            const MCCFR::Infoset& original = map.at(key);
+            for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+                ASSERT_FLOAT_EQ(infoset.regretSum[a], count * original.regretSum[a]);
+                ASSERT_FLOAT_EQ(infoset.strategySum[a], count * original.strategySum[a]);
+            }
+        }
+    }
+    EXPECT_EQ(total, i);
+
+    std::remove(otherPath.c_str());
+    std::remove(mergedPath.c_str());
+}
+
+// the output can be one of the inputs: it is only replaced once the merge is complete
+TEST_F(StrategyIOTest, MergeIntoOneOfTheInputs) {
+    InfosetMap first;
+    for (const auto& [key, infoset] : map) {
+        first[key] = infoset;
+        if (first.size() == 2000) break;
+    }
+    const std::string otherPath = "strategy_io_test_other.bin";
+    ASSERT_TRUE(save(first, path, Format::Chunked));
+    ASSERT_TRUE(save(first, otherPath, Format::Chunked));
+
+    ASSERT_TRUE(merge({path, otherPath}, {}, path));
+
+    InfosetMap merged;
+    ASSERT_TRUE(load(merged, path));
+    ASSERT_EQ(merged.size(), first.size());
+    for (const auto& [key, infoset] : first) {
+        const auto& result = merged.at(key);
+        for (int a = 0; a < MCCFR::MAX_ACTIONS; ++a) {
+            ASSERT_FLOAT_EQ(result.regretSum[a], 2.0f * infoset.regretSum[a]);
+            ASSERT_FLOAT_EQ(result.strategySum[a], 2.0f * infoset.strategySum[a]);
+        }
+    }
+
+    std::remove(otherPath.c_str());
+}